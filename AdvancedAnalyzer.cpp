@@ -1,4 +1,5 @@
 #include "AdvancedAnalyzer.h"
+#include "NetworkCentrality.h"
 #include <algorithm>
 #include <cmath>
 #include <iostream>
@@ -7,19 +8,22 @@
 #include <sstream>
 
 // 构造函数
-AdvancedAnalyzer::AdvancedAnalyzer() : passengerFlow(nullptr) {}
+AdvancedAnalyzer::AdvancedAnalyzer()
+    : catalog(EntityCatalog::empty()), passengerFlow(nullptr) {}
 
-AdvancedAnalyzer::AdvancedAnalyzer(std::shared_ptr<PassengerFlow> flow)
-    : passengerFlow(flow) {}
+AdvancedAnalyzer::AdvancedAnalyzer(
+    std::shared_ptr<PassengerFlow> flow,
+    std::shared_ptr<const EntityCatalog> entityCatalog)
+    : catalog(entityCatalog ? entityCatalog : EntityCatalog::empty()),
+      passengerFlow(flow) {}
 
 // 析构函数
-AdvancedAnalyzer::~AdvancedAnalyzer() { stations.clear(); }
+AdvancedAnalyzer::~AdvancedAnalyzer() {}
 
 // 数据管理
-void AdvancedAnalyzer::addStation(std::shared_ptr<Station> station) {
-  if (station) {
-    stations.push_back(station);
-  }
+void AdvancedAnalyzer::setCatalog(
+    std::shared_ptr<const EntityCatalog> entityCatalog) {
+  catalog = entityCatalog ? entityCatalog : EntityCatalog::empty();
 }
 
 void AdvancedAnalyzer::setPassengerFlow(std::shared_ptr<PassengerFlow> flow) {
@@ -119,6 +123,7 @@ AdvancedAnalyzer::forecastLinearRegression(const std::string &stationId,
 // ========== 聚类分析实现 ==========
 
 ClusterResult AdvancedAnalyzer::clusterStationsByFlow(int k) const {
+  const auto &stations = catalog->getStations();
   ClusterResult result;
 
   if (!passengerFlow || stations.empty()) {
@@ -148,6 +153,7 @@ ClusterResult AdvancedAnalyzer::clusterStationsByFlow(int k) const {
 }
 
 ClusterResult AdvancedAnalyzer::clusterByTravelPatterns(int k) const {
+  const auto &stations = catalog->getStations();
   ClusterResult result;
 
   if (!passengerFlow) {
@@ -202,7 +208,7 @@ PatternResult AdvancedAnalyzer::mineTemporalPatterns() const {
   std::vector<int> hourlyTotal(24, 0);
   Date today(2024, 12, 15);
 
-  for (const auto &station : stations) {
+  for (const auto &station : catalog->getStations()) {
     auto hourlyFlow =
         passengerFlow->getStationHourlyFlow(station->getStationId(), today);
     for (size_t i = 0; i < hourlyFlow.size() && i < 24; i++) {
@@ -258,6 +264,7 @@ PatternResult AdvancedAnalyzer::mineTemporalPatterns() const {
 }
 
 PatternResult AdvancedAnalyzer::mineSpatialPatterns() const {
+  const auto &stations = catalog->getStations();
   PatternResult result("空间模式");
 
   if (!passengerFlow || stations.empty()) {
@@ -305,6 +312,7 @@ PatternResult AdvancedAnalyzer::mineSpatialPatterns() const {
 // ========== 站点关联性分析实现 ==========
 
 StationCorrelation AdvancedAnalyzer::analyzeStationCorrelations() const {
+  const auto &stations = catalog->getStations();
   StationCorrelation correlation;
 
   if (!passengerFlow || stations.size() < 2) {
@@ -345,6 +353,14 @@ StationCorrelation AdvancedAnalyzer::analyzeStationCorrelations() const {
   return correlation;
 }
 
+// 换乘效率分析与DataAnalyzer一致
+AnalysisResult AdvancedAnalyzer::analyzeTransferEfficiency() const {
+  if (!passengerFlow) {
+    return AnalysisResult("换乘效率分析");
+  }
+  return DataAnalyzer(passengerFlow, catalog).analyzeTransferEfficiency();
+}
+
 AnalysisResult AdvancedAnalyzer::optimizeTransferGuidance() const {
   AnalysisResult result("换乘引导策略优化", "基于客流分析优化换乘引导");
 
@@ -355,15 +371,11 @@ AnalysisResult AdvancedAnalyzer::optimizeTransferGuidance() const {
 
   for (const auto &pair : correlations.stronglyCorrelated) {
     // 检查是否涉及换乘站
-    bool hasTransferStation = false;
-    for (const auto &station : stations) {
-      if (station->getIsTransferStation() &&
-          (station->getStationName() == pair.first ||
-           station->getStationName() == pair.second)) {
-        hasTransferStation = true;
-        break;
-      }
-    }
+    EntityHandle first = catalog->getStationHandleByName(pair.first);
+    EntityHandle second = catalog->getStationHandleByName(pair.second);
+    bool hasTransferStation =
+        (first != INVALID_HANDLE && catalog->isTransferStation(first)) ||
+        (second != INVALID_HANDLE && catalog->isTransferStation(second));
 
     if (hasTransferStation) {
       improvementPotential += 10.0; // 假设每个相关换乘站对可提升10%效率
@@ -377,6 +389,97 @@ AnalysisResult AdvancedAnalyzer::optimizeTransferGuidance() const {
   return result;
 }
 
+AnalysisResult AdvancedAnalyzer::analyzeNetworkCentrality() const {
+  AnalysisResult result("网络中心性分析",
+                        "基于最短路的介数中心性（按里程与按区间数）");
+
+  RailNetwork network(catalog);
+  NetworkCentrality centrality(network);
+  BetweennessResult byDistance = centrality.betweenness(true);
+  BetweennessResult byHops = centrality.betweenness(false);
+  if (byDistance.activeStationCount < 3) {
+    return result;
+  }
+
+  double sum = 0.0;
+  for (double value : byDistance.normalized) {
+    sum += value;
+  }
+  result.data["连通站点数"] =
+      static_cast<double>(byDistance.activeStationCount);
+  result.data["平均介数中心性"] = sum / byDistance.activeStationCount;
+
+  for (const auto &entry : byDistance.top(10)) {
+    result.data["介数中心性-" +
+                catalog->getStation(entry.first)->getStationName()] =
+        entry.second;
+  }
+  for (const auto &entry : byHops.top(5)) {
+    result.data["区间数介数-" +
+                catalog->getStation(entry.first)->getStationName()] =
+        entry.second;
+  }
+
+  return result;
+}
+
+// 网络韧性分析与DataAnalyzer一致
+AnalysisResult AdvancedAnalyzer::analyzeNetworkResilience() const {
+  if (!passengerFlow) {
+    return AnalysisResult("网络韧性分析");
+  }
+  return DataAnalyzer(passengerFlow, catalog).analyzeNetworkResilience();
+}
+
+// 关键节点：按里程介数高于连通站点均值2个标准差
+AnalysisResult AdvancedAnalyzer::identifyCriticalNodes() const {
+  AnalysisResult result("关键节点识别",
+                        "介数中心性显著高于网络平均水平的站点");
+
+  RailNetwork network(catalog);
+  BetweennessResult betweenness =
+      NetworkCentrality(network).betweenness(true);
+  int activeCount = betweenness.activeStationCount;
+  if (activeCount < 3) {
+    return result;
+  }
+
+  std::vector<double> values;
+  for (EntityHandle station = 0; station < network.getNodeCount();
+       ++station) {
+    if (network.getDegree(station) > 0) {
+      values.push_back(betweenness.normalized[station]);
+    }
+  }
+  double mean = calculateMean(values);
+  double variance = 0.0;
+  for (double value : values) {
+    variance += (value - mean) * (value - mean);
+  }
+  double threshold = mean + 2 * std::sqrt(variance / values.size());
+
+  double total = std::accumulate(values.begin(), values.end(), 0.0);
+  double criticalShare = 0.0;
+  int criticalCount = 0;
+  for (const auto &entry : betweenness.top(values.size())) {
+    if (entry.second <= threshold) {
+      break;
+    }
+    criticalCount++;
+    criticalShare += entry.second;
+    result.data["关键节点-" +
+                catalog->getStation(entry.first)->getStationName()] =
+        entry.second;
+  }
+
+  result.data["关键节点数"] = static_cast<double>(criticalCount);
+  result.data["关键节点阈值"] = threshold;
+  result.data["关键节点介数占比%"] =
+      total > 0 ? criticalShare / total * 100 : 0.0;
+
+  return result;
+}
+
 // ========== 私有辅助方法实现 ==========
 
 std::vector<double>
@@ -403,7 +506,8 @@ std::vector<std::vector<double>>
 AdvancedAnalyzer::extractStationFeatures() const {
   std::vector<std::vector<double>> features;
 
-  for (const auto &station : stations) {
+  for (EntityHandle handle = 0; handle < catalog->getStationCount(); ++handle) {
+    const auto &station = catalog->getStation(handle);
     std::vector<double> stationFeatures;
 
     // 特征1: 总客流量
@@ -413,8 +517,8 @@ AdvancedAnalyzer::extractStationFeatures() const {
     // 特征2: 平台数量
     stationFeatures.push_back(static_cast<double>(station->getPlatformCount()));
 
-    // 特征3: 是否为换乘站
-    stationFeatures.push_back(station->getIsTransferStation() ? 1.0 : 0.0);
+    // 特征3: 是否为换乘站（含多线路经停）
+    stationFeatures.push_back(catalog->isTransferStation(handle) ? 1.0 : 0.0);
 
     features.push_back(stationFeatures);
   }
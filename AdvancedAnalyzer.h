@@ -2,6 +2,7 @@
 #define ADVANCEDANALYZER_H
 
 #include "DataAnalyzer.h"
+#include "EntityCatalog.h"
 #include "PassengerFlow.h"
 #include "Station.h"
 #include <algorithm>
@@ -28,19 +29,21 @@ struct PatternResult {
 // 高级分析器类
 class AdvancedAnalyzer {
 private:
-  std::vector<std::shared_ptr<Station>> stations;
+  std::shared_ptr<const EntityCatalog> catalog; // 共享只读实体目录
   std::shared_ptr<PassengerFlow> passengerFlow;
 
 public:
   // 构造函数
   AdvancedAnalyzer();
-  AdvancedAnalyzer(std::shared_ptr<PassengerFlow> flow);
+  AdvancedAnalyzer(
+      std::shared_ptr<PassengerFlow> flow,
+      std::shared_ptr<const EntityCatalog> entityCatalog = nullptr);
 
   // 析构函数
   ~AdvancedAnalyzer();
 
   // 数据管理
-  void addStation(std::shared_ptr<Station> station);
+  void setCatalog(std::shared_ptr<const EntityCatalog> entityCatalog);
   void setPassengerFlow(std::shared_ptr<PassengerFlow> flow);
 
   // ========== 高级时间序列预测 ==========
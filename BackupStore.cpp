@@ -0,0 +1,604 @@
+#include "BackupStore.h"
+#include "ParallelUtils.h"
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <tuple>
+
+namespace {
+
+const size_t READ_BLOCK_SIZE = 1 << 20; // 每次读取1MB
+const size_t RESTORE_BATCH = 64;        // 并行恢复的数据块批大小
+
+// Gear滚动哈希表（splitmix64生成，保证跨平台一致）
+const uint64_t *gearTable() {
+  static uint64_t table[256];
+  static bool initialized = [] {
+    uint64_t state = 0x52A11A7ULL;
+    for (auto &value : table) {
+      state += 0x9E3779B97F4A7C15ULL;
+      uint64_t z = state;
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+      value = z ^ (z >> 31);
+    }
+    return true;
+  }();
+  (void)initialized;
+  return table;
+}
+
+std::string joinPath(const std::string &dir, const std::string &name) {
+  return dir.empty() ? name : dir + "/" + name;
+}
+
+// 清单排序键：(UTC时间戳, 同秒序号, 名称)。名称形如
+// backup_<日期>_<时间>_<序号>.txt；旧版清单无序号或序号未补零，
+// 无序号的视为-1，序号按数值比较
+std::tuple<std::string, long long, std::string>
+manifestOrderKey(const std::string &name) {
+  std::string stem = name.substr(0, name.rfind('.'));
+  std::vector<std::string> parts;
+  std::istringstream iss(stem);
+  for (std::string part; std::getline(iss, part, '_');) {
+    parts.push_back(part);
+  }
+  long long sequence = -1;
+  if (parts.size() == 4 && !parts[3].empty() &&
+      parts[3].find_first_not_of("0123456789") == std::string::npos) {
+    sequence = std::stoll(parts[3]);
+  }
+  std::string stamp = parts.size() >= 3 ? parts[1] + parts[2] : stem;
+  return std::make_tuple(stamp, sequence, name);
+}
+
+uint32_t read32(const unsigned char *p) {
+  return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+         (static_cast<uint32_t>(p[2]) << 16) |
+         (static_cast<uint32_t>(p[3]) << 24);
+}
+
+// 长度扩展字节（LZ4格式：255连续累加）
+void writeLength(std::string &out, size_t length) {
+  while (length >= 255) {
+    out.push_back(static_cast<char>(255));
+    length -= 255;
+  }
+  out.push_back(static_cast<char>(length));
+}
+
+bool readLength(const unsigned char *&ip, const unsigned char *end,
+                size_t &length) {
+  unsigned char byte = 255;
+  while (byte == 255) {
+    if (ip >= end) {
+      return false;
+    }
+    byte = *ip++;
+    length += byte;
+  }
+  return true;
+}
+
+void emitSequence(std::string &out, const unsigned char *literals,
+                  size_t literalLength, size_t offset, size_t matchLength) {
+  size_t matchCode = matchLength >= 4 ? matchLength - 4 : 0;
+  unsigned char token =
+      static_cast<unsigned char>((std::min<size_t>(literalLength, 15) << 4) |
+                                 std::min<size_t>(matchCode, 15));
+  out.push_back(static_cast<char>(token));
+  if (literalLength >= 15) {
+    writeLength(out, literalLength - 15);
+  }
+  out.append(reinterpret_cast<const char *>(literals), literalLength);
+  if (matchLength == 0) {
+    return; // 末尾序列只有字面量
+  }
+  out.push_back(static_cast<char>(offset & 0xFF));
+  out.push_back(static_cast<char>((offset >> 8) & 0xFF));
+  if (matchCode >= 15) {
+    writeLength(out, matchCode - 15);
+  }
+}
+
+} // namespace
+
+// 构造函数
+BackupStore::BackupStore(const std::string &rootDir) : rootDirectory(rootDir) {}
+
+// ========== 分块、哈希与压缩 ==========
+
+// 返回从data开始的第一个块长度；数据不足以确定边界时返回0
+size_t BackupStore::findChunkBoundary(const unsigned char *data, size_t size,
+                                      bool endOfInput) {
+  if (size <= MIN_CHUNK_SIZE) {
+    return endOfInput ? size : 0;
+  }
+
+  const uint64_t *gear = gearTable();
+  size_t limit = std::min<size_t>(size, MAX_CHUNK_SIZE);
+  uint64_t hash = 0;
+  for (size_t i = MIN_CHUNK_SIZE; i < limit; ++i) {
+    hash = (hash << 1) + gear[data[i]];
+    if ((hash & CHUNK_MASK) == 0) {
+      return i + 1;
+    }
+  }
+
+  if (limit == MAX_CHUNK_SIZE) {
+    return MAX_CHUNK_SIZE;
+  }
+  return endOfInput ? size : 0;
+}
+
+// 128位内容哈希：FNV-1a与乘法-异或移位两条独立哈希拼接
+std::string BackupStore::hashChunk(const unsigned char *data, size_t size) {
+  uint64_t h1 = 14695981039346656037ULL;
+  uint64_t h2 = 0x27D4EB2F165667C5ULL ^ size;
+  for (size_t i = 0; i < size; ++i) {
+    h1 ^= data[i];
+    h1 *= 1099511628211ULL;
+    h2 = (h2 ^ data[i]) * 0x9E3779B97F4A7C15ULL;
+    h2 ^= h2 >> 29;
+  }
+  h2 ^= h2 >> 33;
+  h2 *= 0xFF51AFD7ED558CCDULL;
+  h2 ^= h2 >> 33;
+
+  std::ostringstream oss;
+  oss << std::hex << std::setfill('0') << std::setw(16) << h1 << std::setw(16)
+      << h2;
+  return oss.str();
+}
+
+// LZ77块压缩（LZ4块格式，64KB窗口）
+std::string BackupStore::compressBlock(const unsigned char *data,
+                                       size_t size) {
+  std::string out;
+  out.reserve(size / 2 + 16);
+
+  const int HASH_BITS = 14;
+  std::vector<int> table(1 << HASH_BITS, -1);
+  size_t anchor = 0;
+  size_t i = 0;
+
+  while (size >= 12 && i + 12 <= size) {
+    uint32_t sequence = read32(data + i);
+    uint32_t h = (sequence * 2654435761U) >> (32 - HASH_BITS);
+    int candidate = table[h];
+    table[h] = static_cast<int>(i);
+
+    if (candidate >= 0 && i - static_cast<size_t>(candidate) <= 65535 &&
+        read32(data + candidate) == sequence) {
+      size_t matchLength = 4;
+      while (i + matchLength < size &&
+             data[candidate + matchLength] == data[i + matchLength]) {
+        ++matchLength;
+      }
+      emitSequence(out, data + anchor, i - anchor,
+                   i - static_cast<size_t>(candidate), matchLength);
+      i += matchLength;
+      anchor = i;
+    } else {
+      ++i;
+    }
+  }
+
+  emitSequence(out, data + anchor, size - anchor, 0, 0);
+  return out;
+}
+
+bool BackupStore::decompressBlock(const std::string &compressed,
+                                  std::vector<unsigned char> &output,
+                                  size_t originalSize) {
+  output.clear();
+  output.reserve(originalSize);
+  const unsigned char *ip =
+      reinterpret_cast<const unsigned char *>(compressed.data());
+  const unsigned char *end = ip + compressed.size();
+
+  while (ip < end) {
+    unsigned char token = *ip++;
+    size_t literalLength = token >> 4;
+    if (literalLength == 15 && !readLength(ip, end, literalLength)) {
+      return false;
+    }
+    if (static_cast<size_t>(end - ip) < literalLength ||
+        output.size() + literalLength > originalSize) {
+      return false;
+    }
+    output.insert(output.end(), ip, ip + literalLength);
+    ip += literalLength;
+    if (ip == end) {
+      break; // 末尾序列
+    }
+
+    if (end - ip < 2) {
+      return false;
+    }
+    size_t offset = ip[0] | (static_cast<size_t>(ip[1]) << 8);
+    ip += 2;
+    size_t matchLength = token & 15;
+    if (matchLength == 15 && !readLength(ip, end, matchLength)) {
+      return false;
+    }
+    matchLength += 4;
+    if (offset == 0 || offset > output.size() ||
+        output.size() + matchLength > originalSize) {
+      return false;
+    }
+    size_t from = output.size() - offset;
+    for (size_t k = 0; k < matchLength; ++k) {
+      output.push_back(output[from + k]); // 允许重叠复制
+    }
+  }
+
+  return output.size() == originalSize;
+}
+
+// ========== 数据块存储 ==========
+
+std::string BackupStore::chunkPath(const std::string &chunkId) const {
+  return rootDirectory + "/chunks/" + chunkId.substr(0, 2) + "/" + chunkId +
+         ".chk";
+}
+
+void BackupStore::loadKnownChunks() {
+  knownChunks.clear();
+  std::error_code ec;
+  std::filesystem::path chunkDir(rootDirectory + "/chunks");
+  if (!std::filesystem::exists(chunkDir, ec)) {
+    return;
+  }
+  for (const auto &item :
+       std::filesystem::recursive_directory_iterator(chunkDir, ec)) {
+    if (item.is_regular_file() && item.path().extension() == ".chk") {
+      knownChunks.insert(item.path().stem().string());
+    }
+  }
+}
+
+// 写入数据块；块已存在时返回0，失败返回-1，否则返回写入字节数
+long long BackupStore::storeChunk(const unsigned char *data, size_t size,
+                                  const std::string &chunkId) {
+  {
+    std::lock_guard<std::mutex> lock(chunkMutex);
+    if (!knownChunks.insert(chunkId).second) {
+      return 0; // 已存在或已被其他线程认领
+    }
+  }
+
+  std::string payload = compressBlock(data, size);
+  char method = 1;
+  if (payload.size() >= size) {
+    payload.assign(reinterpret_cast<const char *>(data), size); // 不可压缩
+    method = 0;
+  }
+
+  std::string path = chunkPath(chunkId);
+  std::error_code ec;
+  std::filesystem::create_directories(
+      std::filesystem::path(path).parent_path(), ec);
+
+  std::string tempPath = path + ".tmp";
+  {
+    std::ofstream file(tempPath, std::ios::binary);
+    if (file.is_open()) {
+      file.put(method);
+      file.write(payload.data(), payload.size());
+    }
+    if (!file) {
+      std::lock_guard<std::mutex> lock(chunkMutex);
+      knownChunks.erase(chunkId);
+      return -1;
+    }
+  }
+  std::filesystem::rename(tempPath, path, ec);
+  if (ec) {
+    std::lock_guard<std::mutex> lock(chunkMutex);
+    knownChunks.erase(chunkId);
+    return -1;
+  }
+  return static_cast<long long>(payload.size()) + 1;
+}
+
+bool BackupStore::loadChunk(const ChunkRef &ref,
+                            std::vector<unsigned char> &data) const {
+  std::ifstream file(chunkPath(ref.chunkId), std::ios::binary);
+  if (!file.is_open()) {
+    return false;
+  }
+  char method = 0;
+  file.get(method);
+  std::string payload((std::istreambuf_iterator<char>(file)),
+                      std::istreambuf_iterator<char>());
+
+  if (method == 0) {
+    data.assign(payload.begin(), payload.end());
+  } else if (!decompressBlock(payload, data, ref.length)) {
+    return false;
+  }
+
+  // 校验内容哈希，防止数据块损坏
+  return data.size() == ref.length &&
+         hashChunk(data.data(), data.size()) == ref.chunkId;
+}
+
+// ========== 备份 ==========
+
+bool BackupStore::backup(const std::string &sourceDir,
+                         const std::vector<std::string> &fileNames,
+                         BackupStats &stats) {
+  lastError.clear();
+  stats = BackupStats();
+  std::error_code ec;
+  std::filesystem::create_directories(rootDirectory + "/manifests", ec);
+  if (ec) {
+    lastError = "无法创建备份目录: " + rootDirectory;
+    return false;
+  }
+  loadKnownChunks();
+
+  std::vector<ManifestEntry> entries;
+  for (const auto &name : fileNames) {
+    ManifestEntry entry;
+    entry.fileName = name;
+    if (!backupFile(joinPath(sourceDir, name), entry, stats)) {
+      return false;
+    }
+    entries.push_back(std::move(entry));
+    stats.fileCount++;
+  }
+
+  // 清单按UTC时间与补零的同秒序号命名，名称顺序即备份顺序
+  std::time_t now = std::time(nullptr);
+  std::tm tmValue = *std::gmtime(&now);
+  std::ostringstream oss;
+  oss << "backup_" << std::put_time(&tmValue, "%Y%m%d_%H%M%S");
+  std::string baseName = oss.str();
+  std::string manifestName;
+  for (int n = 0;; ++n) {
+    std::ostringstream name;
+    name << baseName << '_' << std::setw(4) << std::setfill('0') << n
+         << ".txt";
+    manifestName = name.str();
+    if (!std::filesystem::exists(rootDirectory + "/manifests/" + manifestName,
+                                 ec)) {
+      break;
+    }
+  }
+
+  if (!writeManifest(manifestName, entries)) {
+    return false;
+  }
+  stats.manifestName = manifestName;
+  return true;
+}
+
+bool BackupStore::backupFile(const std::string &path, ManifestEntry &entry,
+                             BackupStats &stats) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file.is_open()) {
+    lastError = "无法打开备份源文件: " + path;
+    return false;
+  }
+
+  std::vector<unsigned char> pending;
+  bool endOfInput = false;
+
+  while (!endOfInput) {
+    // 读取下一个数据块，追加到未分块缓冲区
+    size_t oldSize = pending.size();
+    pending.resize(oldSize + READ_BLOCK_SIZE);
+    file.read(reinterpret_cast<char *>(pending.data() + oldSize),
+              READ_BLOCK_SIZE);
+    size_t got = static_cast<size_t>(file.gcount());
+    pending.resize(oldSize + got);
+    endOfInput = got < READ_BLOCK_SIZE;
+    stats.bytesRead += got;
+
+    // 顺序确定分块边界
+    std::vector<std::pair<size_t, size_t>> spans;
+    size_t start = 0;
+    while (start < pending.size()) {
+      size_t length = findChunkBoundary(pending.data() + start,
+                                        pending.size() - start, endOfInput);
+      if (length == 0) {
+        break;
+      }
+      spans.emplace_back(start, length);
+      start += length;
+    }
+
+    // 并行计算哈希并压缩写入新数据块
+    std::vector<std::string> ids(spans.size());
+    std::vector<long long> written(spans.size(), 0);
+    parallelFor(spans.size(), [&](size_t begin, size_t end, unsigned) {
+      for (size_t i = begin; i < end; ++i) {
+        const unsigned char *chunk = pending.data() + spans[i].first;
+        ids[i] = hashChunk(chunk, spans[i].second);
+        written[i] = storeChunk(chunk, spans[i].second, ids[i]);
+      }
+    });
+
+    for (size_t i = 0; i < spans.size(); ++i) {
+      if (written[i] < 0) {
+        lastError = "写入数据块失败: " + ids[i];
+        return false;
+      }
+      if (written[i] > 0) {
+        stats.newChunkCount++;
+        stats.bytesStored += written[i];
+      }
+      entry.chunks.emplace_back(ids[i],
+                                static_cast<uint32_t>(spans[i].second));
+      entry.fileSize += static_cast<long long>(spans[i].second);
+    }
+    stats.chunkCount += static_cast<int>(spans.size());
+    pending.erase(pending.begin(), pending.begin() + start);
+  }
+
+  return true;
+}
+
+bool BackupStore::writeManifest(const std::string &manifestName,
+                                const std::vector<ManifestEntry> &entries) {
+  std::string path = rootDirectory + "/manifests/" + manifestName;
+  std::ofstream file(path);
+  if (!file.is_open()) {
+    lastError = "无法写入备份清单: " + path;
+    return false;
+  }
+
+  file << "RAILBACKUP 1\n";
+  for (const auto &entry : entries) {
+    file << "FILE\t" << entry.fileSize << '\t' << entry.chunks.size() << '\t'
+         << entry.fileName << '\n';
+    for (const auto &chunk : entry.chunks) {
+      file << chunk.chunkId << '\t' << chunk.length << '\n';
+    }
+  }
+  return static_cast<bool>(file);
+}
+
+// ========== 恢复 ==========
+
+std::vector<std::string> BackupStore::listManifests() const {
+  std::vector<std::string> names;
+  std::error_code ec;
+  std::filesystem::path dir(rootDirectory + "/manifests");
+  if (!std::filesystem::exists(dir, ec)) {
+    return names;
+  }
+  for (const auto &item : std::filesystem::directory_iterator(dir, ec)) {
+    if (item.is_regular_file() && item.path().extension() == ".txt") {
+      names.push_back(item.path().filename().string());
+    }
+  }
+  std::sort(names.begin(), names.end(),
+            [](const std::string &a, const std::string &b) {
+              return manifestOrderKey(a) < manifestOrderKey(b);
+            });
+  return names;
+}
+
+bool BackupStore::readManifest(const std::string &manifestName,
+                               std::vector<ManifestEntry> &entries) const {
+  entries.clear();
+  std::ifstream file(rootDirectory + "/manifests/" + manifestName);
+  std::string line;
+  if (!file.is_open() || !std::getline(file, line) ||
+      line != "RAILBACKUP 1") {
+    return false;
+  }
+
+  while (std::getline(file, line)) {
+    if (line.compare(0, 5, "FILE\t") != 0) {
+      return false;
+    }
+    std::istringstream header(line.substr(5));
+    ManifestEntry entry;
+    size_t chunkCount = 0;
+    header >> entry.fileSize >> chunkCount;
+    header.get(); // 跳过分隔符，文件名中可能包含空格
+    std::getline(header, entry.fileName);
+    if (entry.fileName.empty()) {
+      return false;
+    }
+
+    entry.chunks.reserve(chunkCount);
+    for (size_t i = 0; i < chunkCount; ++i) {
+      ChunkRef ref;
+      if (!(file >> ref.chunkId >> ref.length)) {
+        return false;
+      }
+      entry.chunks.push_back(ref);
+    }
+    file.ignore(1, '\n');
+    entries.push_back(std::move(entry));
+  }
+  return true;
+}
+
+bool BackupStore::restore(const std::string &targetDir,
+                          const std::string &manifestName) {
+  lastError.clear();
+  std::string name = manifestName;
+  if (name.empty()) {
+    auto manifests = listManifests();
+    if (manifests.empty()) {
+      lastError = "备份目录中没有可用的备份: " + rootDirectory;
+      return false;
+    }
+    name = manifests.back();
+  }
+
+  std::vector<ManifestEntry> entries;
+  if (!readManifest(name, entries)) {
+    lastError = "备份清单无效: " + name;
+    return false;
+  }
+
+  for (const auto &entry : entries) {
+    if (!restoreFile(targetDir, entry)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool BackupStore::restoreFile(const std::string &targetDir,
+                              const ManifestEntry &entry) {
+  std::string targetPath = joinPath(targetDir, entry.fileName);
+  std::string tempPath = targetPath + ".restore";
+  std::ofstream file(tempPath, std::ios::binary);
+  if (!file.is_open()) {
+    lastError = "无法写入恢复文件: " + targetPath;
+    return false;
+  }
+
+  // 分批并行读取、解压、校验数据块，再按顺序写出
+  std::vector<std::vector<unsigned char>> buffers;
+  std::vector<char> loaded;
+  for (size_t base = 0; base < entry.chunks.size(); base += RESTORE_BATCH) {
+    size_t count = std::min(RESTORE_BATCH, entry.chunks.size() - base);
+    buffers.assign(count, std::vector<unsigned char>());
+    loaded.assign(count, 0);
+
+    parallelFor(count, [&](size_t begin, size_t end, unsigned) {
+      for (size_t i = begin; i < end; ++i) {
+        loaded[i] = loadChunk(entry.chunks[base + i], buffers[i]) ? 1 : 0;
+      }
+    });
+
+    for (size_t i = 0; i < count; ++i) {
+      if (!loaded[i]) {
+        lastError = "数据块缺失或损坏: " + entry.chunks[base + i].chunkId;
+        file.close();
+        std::remove(tempPath.c_str());
+        return false;
+      }
+      file.write(reinterpret_cast<const char *>(buffers[i].data()),
+                 static_cast<std::streamsize>(buffers[i].size()));
+    }
+  }
+
+  file.close();
+  if (!file) {
+    lastError = "写入恢复文件失败: " + targetPath;
+    return false;
+  }
+
+  // 全部块校验通过后再替换目标文件
+  std::error_code ec;
+  std::filesystem::rename(tempPath, targetPath, ec);
+  if (ec) {
+    lastError = "无法替换目标文件: " + targetPath;
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,99 @@
+#ifndef BACKUPSTORE_H
+#define BACKUPSTORE_H
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+// 数据块引用
+struct ChunkRef {
+  std::string chunkId; // 内容哈希（32位十六进制）
+  uint32_t length;     // 原始长度
+
+  ChunkRef(const std::string &id = "", uint32_t len = 0)
+      : chunkId(id), length(len) {}
+};
+
+// 备份清单中的单个文件
+struct ManifestEntry {
+  std::string fileName;
+  long long fileSize;
+  std::vector<ChunkRef> chunks;
+
+  ManifestEntry() : fileSize(0) {}
+};
+
+// 备份统计
+struct BackupStats {
+  int fileCount;
+  long long bytesRead;
+  int chunkCount;        // 引用的数据块总数
+  int newChunkCount;     // 新写入的数据块数
+  long long bytesStored; // 新写入的压缩后字节数
+  std::string manifestName;
+
+  BackupStats()
+      : fileCount(0), bytesRead(0), chunkCount(0), newChunkCount(0),
+        bytesStored(0) {}
+};
+
+// 基于内容寻址的增量备份仓库
+// 目录结构：<root>/chunks/xx/<id>.chk 存放压缩数据块，
+//           <root>/manifests/backup_<UTC时间>_<序号>.txt 存放每次备份的
+//           块引用清单（序号为同一秒内的补零计数）
+class BackupStore {
+private:
+  std::string rootDirectory;
+  std::unordered_set<std::string> knownChunks; // 仓库中已存在的数据块
+  std::mutex chunkMutex;
+  std::string lastError;
+
+public:
+  // 内容定义分块参数
+  static const uint32_t MIN_CHUNK_SIZE = 2 * 1024;
+  static const uint32_t MAX_CHUNK_SIZE = 64 * 1024;
+  static const uint64_t CHUNK_MASK = (1ULL << 13) - 1; // 平均约8KB
+
+  // 构造函数
+  explicit BackupStore(const std::string &rootDir);
+
+  // 备份sourceDir下的指定文件，只写入仓库中不存在的数据块
+  bool backup(const std::string &sourceDir,
+              const std::vector<std::string> &fileNames, BackupStats &stats);
+
+  // 按清单恢复到targetDir；manifestName为空时恢复最近一次备份
+  bool restore(const std::string &targetDir,
+               const std::string &manifestName = "");
+
+  // 清单管理；按备份先后排序
+  std::vector<std::string> listManifests() const;
+  bool readManifest(const std::string &manifestName,
+                    std::vector<ManifestEntry> &entries) const;
+
+  std::string getLastError() const { return lastError; }
+
+  // 分块与压缩（供测试和工具使用）
+  static size_t findChunkBoundary(const unsigned char *data, size_t size,
+                                  bool endOfInput);
+  static std::string hashChunk(const unsigned char *data, size_t size);
+  static std::string compressBlock(const unsigned char *data, size_t size);
+  static bool decompressBlock(const std::string &compressed,
+                              std::vector<unsigned char> &output,
+                              size_t originalSize);
+
+private:
+  void loadKnownChunks();
+  std::string chunkPath(const std::string &chunkId) const;
+  long long storeChunk(const unsigned char *data, size_t size,
+                       const std::string &chunkId);
+  bool loadChunk(const ChunkRef &ref, std::vector<unsigned char> &data) const;
+  bool backupFile(const std::string &path, ManifestEntry &entry,
+                  BackupStats &stats);
+  bool restoreFile(const std::string &targetDir, const ManifestEntry &entry);
+  bool writeManifest(const std::string &manifestName,
+                     const std::vector<ManifestEntry> &entries);
+};
+
+#endif // BACKUPSTORE_H
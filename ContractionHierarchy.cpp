@@ -0,0 +1,542 @@
+#include "ContractionHierarchy.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <queue>
+
+namespace {
+
+const double INF = std::numeric_limits<double>::infinity();
+const char FILE_MAGIC[4] = {'R', 'C', 'H', '1'};
+const uint32_t FILE_VERSION = 1;
+
+typedef std::pair<double, int> HeapItem;
+typedef std::priority_queue<HeapItem, std::vector<HeapItem>,
+                            std::greater<HeapItem>>
+    MinHeap;
+
+struct Neighbor {
+  int node;
+  int middle;
+  double weight;
+};
+
+struct Shortcut {
+  int from;
+  int to;
+  double weight;
+};
+
+// 收缩过程中的剩余图（只保存尚未收缩的邻居）
+class Contractor {
+public:
+  std::vector<std::vector<Neighbor>> adjacency;
+  std::vector<int> contractedNeighbors;
+
+  Contractor(const RailNetwork &network, PathMetric metric)
+      : adjacency(network.getNodeCount()),
+        contractedNeighbors(network.getNodeCount(), 0),
+        witnessDist(network.getNodeCount(), INF),
+        witnessStamp(network.getNodeCount(), 0), witnessGeneration(0) {
+    const auto &offsets = network.getOffsets();
+    const auto &edges = network.getEdges();
+    for (int node = 0; node < network.getNodeCount(); ++node) {
+      for (int e = offsets[node]; e < offsets[node + 1]; ++e) {
+        adjacency[node].push_back(
+            {edges[e].target, -1, edges[e].weight(metric)});
+      }
+    }
+  }
+
+  // 收缩node需要的捷径（不修改图）
+  void findShortcuts(int node, std::vector<Shortcut> &shortcuts) {
+    shortcuts.clear();
+    const auto &neighbors = adjacency[node];
+    double maxWeight = 0.0;
+    for (const auto &neighbor : neighbors) {
+      maxWeight = std::max(maxWeight, neighbor.weight);
+    }
+    for (size_t i = 0; i < neighbors.size(); ++i) {
+      const Neighbor &from = neighbors[i];
+      witnessSearch(from.node, node, from.weight + maxWeight);
+      for (size_t j = i + 1; j < neighbors.size(); ++j) {
+        const Neighbor &to = neighbors[j];
+        double viaWeight = from.weight + to.weight;
+        if (witnessDistance(to.node) > viaWeight) {
+          shortcuts.push_back({from.node, to.node, viaWeight});
+        }
+      }
+    }
+  }
+
+  // 优先级：边差（新增捷径数 - 删除边数）+ 已收缩邻居数
+  int priority(int node, std::vector<Shortcut> &shortcuts) {
+    findShortcuts(node, shortcuts);
+    return static_cast<int>(shortcuts.size()) -
+           static_cast<int>(adjacency[node].size()) +
+           contractedNeighbors[node];
+  }
+
+  // 收缩node：从邻居的邻接表中移除它并加入捷径
+  void contract(int node, const std::vector<Shortcut> &shortcuts) {
+    for (const auto &neighbor : adjacency[node]) {
+      auto &list = adjacency[neighbor.node];
+      list.erase(std::remove_if(list.begin(), list.end(),
+                                [node](const Neighbor &n) {
+                                  return n.node == node;
+                                }),
+                 list.end());
+      ++contractedNeighbors[neighbor.node];
+    }
+    for (const auto &shortcut : shortcuts) {
+      addOrUpdate(shortcut.from, shortcut.to, shortcut.weight, node);
+      addOrUpdate(shortcut.to, shortcut.from, shortcut.weight, node);
+    }
+    adjacency[node].clear();
+    adjacency[node].shrink_to_fit();
+  }
+
+private:
+  std::vector<double> witnessDist;
+  std::vector<unsigned> witnessStamp;
+  unsigned witnessGeneration;
+  std::vector<HeapItem> witnessHeap;
+
+  double witnessDistance(int node) const {
+    return (witnessStamp[node] == witnessGeneration) ? witnessDist[node] : INF;
+  }
+
+  // 从source出发、绕开excluded的有限Dijkstra
+  void witnessSearch(int source, int excluded, double maxDistance) {
+    ++witnessGeneration;
+    auto &heap = witnessHeap;
+    std::greater<HeapItem> later;
+    heap.clear();
+    witnessDist[source] = 0.0;
+    witnessStamp[source] = witnessGeneration;
+    heap.emplace_back(0.0, source);
+    int settled = 0;
+    while (!heap.empty() &&
+           settled < ContractionHierarchy::WITNESS_SETTLE_LIMIT) {
+      std::pop_heap(heap.begin(), heap.end(), later);
+      HeapItem top = heap.back();
+      heap.pop_back();
+      if (top.first > witnessDistance(top.second)) {
+        continue;
+      }
+      if (top.first > maxDistance) {
+        break;
+      }
+      ++settled;
+      for (const auto &neighbor : adjacency[top.second]) {
+        if (neighbor.node == excluded) {
+          continue;
+        }
+        double candidate = top.first + neighbor.weight;
+        if (candidate < witnessDistance(neighbor.node)) {
+          witnessDist[neighbor.node] = candidate;
+          witnessStamp[neighbor.node] = witnessGeneration;
+          heap.emplace_back(candidate, neighbor.node);
+          std::push_heap(heap.begin(), heap.end(), later);
+        }
+      }
+    }
+  }
+
+  void addOrUpdate(int from, int to, double weight, int middle) {
+    for (auto &neighbor : adjacency[from]) {
+      if (neighbor.node == to) {
+        if (weight < neighbor.weight) {
+          neighbor.weight = weight;
+          neighbor.middle = middle;
+        }
+        return;
+      }
+    }
+    adjacency[from].push_back({to, middle, weight});
+  }
+};
+
+void hashBytes(uint64_t &hash, const void *data, size_t size) {
+  const unsigned char *bytes = static_cast<const unsigned char *>(data);
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ULL;
+  }
+}
+
+template <typename T> bool writeVector(std::ofstream &out, const T &values) {
+  uint64_t count = values.size();
+  out.write(reinterpret_cast<const char *>(&count), sizeof(count));
+  out.write(reinterpret_cast<const char *>(values.data()),
+            static_cast<std::streamsize>(count * sizeof(values[0])));
+  return static_cast<bool>(out);
+}
+
+template <typename T>
+bool readVector(std::ifstream &in, std::vector<T> &values, uint64_t maxCount) {
+  uint64_t count = 0;
+  if (!in.read(reinterpret_cast<char *>(&count), sizeof(count)) ||
+      count > maxCount) {
+    return false;
+  }
+  values.resize(static_cast<size_t>(count));
+  return static_cast<bool>(
+      in.read(reinterpret_cast<char *>(values.data()),
+              static_cast<std::streamsize>(count * sizeof(T))));
+}
+
+DijkstraWorkspace &localWorkspace() {
+  thread_local DijkstraWorkspace workspace;
+  return workspace;
+}
+
+} // namespace
+
+// 构造函数
+ContractionHierarchy::ContractionHierarchy()
+    : catalog(EntityCatalog::empty()), metric(PathMetric::Distance),
+      networkFingerprint(0) {}
+
+// ========== 预处理 ==========
+
+void ContractionHierarchy::build(const RailNetwork &network,
+                                 PathMetric pathMetric) {
+  catalog = network.getSharedCatalog();
+  metric = pathMetric;
+  networkFingerprint = fingerprint(network);
+
+  int nodeCount = network.getNodeCount();
+  Contractor contractor(network, metric);
+  std::vector<std::vector<UpEdge>> upLists(nodeCount);
+  std::vector<Shortcut> shortcuts;
+
+  // 按优先级收缩，出堆时重新计算（懒更新）
+  MinHeap queue;
+  for (int node = 0; node < nodeCount; ++node) {
+    queue.emplace(contractor.priority(node, shortcuts), node);
+  }
+
+  ranks.assign(nodeCount, -1);
+  int nextRank = 0;
+  while (!queue.empty()) {
+    HeapItem top = queue.top();
+    queue.pop();
+    int node = top.second;
+    if (ranks[node] >= 0) {
+      continue;
+    }
+    int current = contractor.priority(node, shortcuts);
+    if (!queue.empty() && current > queue.top().first) {
+      queue.emplace(current, node);
+      continue;
+    }
+
+    // 此时剩余邻居的等级都将高于node
+    for (const auto &neighbor : contractor.adjacency[node]) {
+      upLists[node].push_back({neighbor.node, neighbor.middle, neighbor.weight});
+    }
+    contractor.contract(node, shortcuts);
+    ranks[node] = nextRank++;
+  }
+
+  upOffsets.assign(nodeCount + 1, 0);
+  upEdges.clear();
+  for (int node = 0; node < nodeCount; ++node) {
+    upEdges.insert(upEdges.end(), upLists[node].begin(), upLists[node].end());
+    upOffsets[node + 1] = static_cast<int>(upEdges.size());
+  }
+}
+
+int ContractionHierarchy::getShortcutCount() const {
+  return static_cast<int>(std::count_if(
+      upEdges.begin(), upEdges.end(),
+      [](const UpEdge &edge) { return edge.middle >= 0; }));
+}
+
+uint64_t ContractionHierarchy::fingerprint(const RailNetwork &network) {
+  uint64_t hash = 14695981039346656037ULL;
+  int nodeCount = network.getNodeCount();
+  hashBytes(hash, &nodeCount, sizeof(nodeCount));
+  for (const auto &station : network.getCatalog().getStations()) {
+    const std::string &id = station->getStationId();
+    hashBytes(hash, id.data(), id.size() + 1);
+  }
+  const auto &offsets = network.getOffsets();
+  hashBytes(hash, offsets.data(), offsets.size() * sizeof(int));
+  for (const auto &edge : network.getEdges()) {
+    hashBytes(hash, &edge.target, sizeof(edge.target));
+    hashBytes(hash, &edge.distance, sizeof(edge.distance));
+    hashBytes(hash, &edge.minutes, sizeof(edge.minutes));
+  }
+  return hash;
+}
+
+// ========== 保存与加载 ==========
+
+bool ContractionHierarchy::saveToFile(const std::string &path) {
+  if (!isBuilt()) {
+    lastError = "索引尚未构建";
+    return false;
+  }
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (!out.is_open()) {
+    lastError = "无法写入索引文件: " + path;
+    return false;
+  }
+
+  int32_t metricValue = static_cast<int32_t>(metric);
+  out.write(FILE_MAGIC, sizeof(FILE_MAGIC));
+  out.write(reinterpret_cast<const char *>(&FILE_VERSION),
+            sizeof(FILE_VERSION));
+  out.write(reinterpret_cast<const char *>(&metricValue), sizeof(metricValue));
+  out.write(reinterpret_cast<const char *>(&networkFingerprint),
+            sizeof(networkFingerprint));
+  if (!writeVector(out, ranks) || !writeVector(out, upOffsets) ||
+      !writeVector(out, upEdges)) {
+    lastError = "写入索引文件失败: " + path;
+    return false;
+  }
+  return true;
+}
+
+bool ContractionHierarchy::loadFromFile(const std::string &path,
+                                        const RailNetwork &network) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in.is_open()) {
+    lastError = "无法打开索引文件: " + path;
+    return false;
+  }
+
+  char magic[sizeof(FILE_MAGIC)];
+  uint32_t version = 0;
+  int32_t metricValue = 0;
+  uint64_t storedFingerprint = 0;
+  in.read(magic, sizeof(magic));
+  in.read(reinterpret_cast<char *>(&version), sizeof(version));
+  in.read(reinterpret_cast<char *>(&metricValue), sizeof(metricValue));
+  in.read(reinterpret_cast<char *>(&storedFingerprint),
+          sizeof(storedFingerprint));
+  if (!in || std::memcmp(magic, FILE_MAGIC, sizeof(magic)) != 0 ||
+      version != FILE_VERSION) {
+    lastError = "索引文件格式不正确: " + path;
+    return false;
+  }
+  if (storedFingerprint != fingerprint(network)) {
+    lastError = "索引文件与当前网络不一致: " + path;
+    return false;
+  }
+
+  uint64_t nodeCount = static_cast<uint64_t>(network.getNodeCount());
+  std::vector<int> loadedRanks, loadedOffsets;
+  std::vector<UpEdge> loadedEdges;
+  if (!readVector(in, loadedRanks, nodeCount) ||
+      !readVector(in, loadedOffsets, nodeCount + 1) ||
+      loadedRanks.size() != nodeCount ||
+      loadedOffsets.size() != nodeCount + 1) {
+    lastError = "索引文件内容不完整: " + path;
+    return false;
+  }
+  // 偏移须从0开始且不减，否则查询会越界访问上行边
+  if (loadedOffsets.front() != 0 ||
+      std::adjacent_find(loadedOffsets.begin(), loadedOffsets.end(),
+                         std::greater<int>()) != loadedOffsets.end()) {
+    lastError = "索引文件偏移表无效: " + path;
+    return false;
+  }
+  if (!readVector(in, loadedEdges,
+                  static_cast<uint64_t>(loadedOffsets.back())) ||
+      loadedEdges.size() != static_cast<size_t>(loadedOffsets.back())) {
+    lastError = "索引文件内容不完整: " + path;
+    return false;
+  }
+  // 等级须为0..n-1的排列，否则等级比较无法区分上下行
+  int nodes = static_cast<int>(nodeCount);
+  std::vector<char> rankUsed(nodeCount, 0);
+  for (int rank : loadedRanks) {
+    if (rank < 0 || rank >= nodes || rankUsed[rank]) {
+      lastError = "索引文件等级表无效: " + path;
+      return false;
+    }
+    rankUsed[rank] = 1;
+  }
+  // 上行边须指向更高等级；捷径经过的节点等级须低于两端，
+  // 保证展开时递归逐层降低等级、必然终止
+  for (int node = 0; node < nodes; ++node) {
+    for (int e = loadedOffsets[node]; e < loadedOffsets[node + 1]; ++e) {
+      const UpEdge &edge = loadedEdges[e];
+      if (edge.target < 0 || edge.target >= nodes || edge.middle < -1 ||
+          edge.middle >= nodes || !(edge.weight >= 0.0) ||
+          loadedRanks[edge.target] <= loadedRanks[node] ||
+          (edge.middle >= 0 &&
+           loadedRanks[edge.middle] >= loadedRanks[node])) {
+        lastError = "索引文件上行边无效: " + path;
+        return false;
+      }
+    }
+  }
+
+  catalog = network.getSharedCatalog();
+  metric = static_cast<PathMetric>(metricValue);
+  networkFingerprint = storedFingerprint;
+  ranks.swap(loadedRanks);
+  upOffsets.swap(loadedOffsets);
+  upEdges.swap(loadedEdges);
+  return true;
+}
+
+bool ContractionHierarchy::loadOrBuild(const std::string &path,
+                                       const RailNetwork &network,
+                                       PathMetric pathMetric) {
+  if (loadFromFile(path, network) && metric == pathMetric) {
+    return true;
+  }
+  build(network, pathMetric);
+  return saveToFile(path);
+}
+
+// ========== 查询 ==========
+
+double ContractionHierarchy::search(int source, int target,
+                                    DijkstraWorkspace &workspace,
+                                    int &meeting) const {
+  int nodeCount = getNodeCount();
+  workspace.prepare(nodeCount);
+  meeting = -1;
+  if (source < 0 || source >= nodeCount || target < 0 || target >= nodeCount) {
+    return INF;
+  }
+
+  double best = INF;
+  workspace.relax(0, source, 0.0, -1);
+  workspace.relax(1, target, 0.0, -1);
+  int side = 1;
+  while (true) {
+    bool forwardOpen = !workspace.sides[0].heap.empty() &&
+                       workspace.sides[0].heap.front().first < best;
+    bool backwardOpen = !workspace.sides[1].heap.empty() &&
+                        workspace.sides[1].heap.front().first < best;
+    if (!forwardOpen && !backwardOpen) {
+      break;
+    }
+    // 两侧交替扩展
+    side = (forwardOpen && (!backwardOpen || side == 1)) ? 0 : 1;
+    int other = 1 - side;
+    auto &current = workspace.sides[side];
+
+    auto top = workspace.popMin(side);
+    int node = top.second;
+    if (top.first > current.dist[node]) {
+      continue;
+    }
+    if (workspace.reached(other, node)) {
+      double total = top.first + workspace.sides[other].dist[node];
+      if (total < best) {
+        best = total;
+        meeting = node;
+      }
+    }
+
+    // 按需停滞：若存在经更高等级节点到达node的更短路径，则不再扩展
+    bool stalled = false;
+    for (int e = upOffsets[node]; e < upOffsets[node + 1]; ++e) {
+      const UpEdge &edge = upEdges[e];
+      if (workspace.reached(side, edge.target) &&
+          current.dist[edge.target] + edge.weight < top.first) {
+        stalled = true;
+        break;
+      }
+    }
+    if (stalled) {
+      continue;
+    }
+
+    for (int e = upOffsets[node]; e < upOffsets[node + 1]; ++e) {
+      const UpEdge &edge = upEdges[e];
+      double candidate = top.first + edge.weight;
+      if (!workspace.reached(side, edge.target) ||
+          candidate < current.dist[edge.target]) {
+        workspace.relax(side, edge.target, candidate, node);
+      }
+    }
+  }
+  return best;
+}
+
+double ContractionHierarchy::queryCost(int source, int target,
+                                       DijkstraWorkspace &workspace) const {
+  int meeting = -1;
+  return search(source, target, workspace, meeting);
+}
+
+PathResult ContractionHierarchy::query(int source, int target,
+                                       DijkstraWorkspace &workspace) const {
+  PathResult result;
+  int meeting = -1;
+  double cost = search(source, target, workspace, meeting);
+  if (meeting < 0) {
+    return result;
+  }
+  result.found = true;
+  result.cost = cost;
+
+  // 正向：source -> meeting 的上行边链
+  std::vector<int> chain;
+  for (int node = meeting; node != -1;
+       node = workspace.sides[0].parent[node]) {
+    chain.push_back(node);
+  }
+  std::reverse(chain.begin(), chain.end());
+  result.stations.push_back(source);
+  for (size_t i = 1; i < chain.size(); ++i) {
+    unpackEdge(chain[i - 1], chain[i], result.stations);
+  }
+  // 反向：meeting -> target
+  for (int node = meeting; workspace.sides[1].parent[node] != -1;
+       node = workspace.sides[1].parent[node]) {
+    unpackEdge(node, workspace.sides[1].parent[node], result.stations);
+  }
+  return result;
+}
+
+// 展开from与to之间的边（追加from之后直到to的所有站点）
+void ContractionHierarchy::unpackEdge(int from, int to,
+                                      std::vector<EntityHandle> &path) const {
+  int lower = (ranks[from] < ranks[to]) ? from : to;
+  int higher = (lower == from) ? to : from;
+  for (int e = upOffsets[lower]; e < upOffsets[lower + 1]; ++e) {
+    const UpEdge &edge = upEdges[e];
+    if (edge.target != higher) {
+      continue;
+    }
+    if (edge.middle < 0) {
+      path.push_back(to);
+    } else {
+      unpackEdge(from, edge.middle, path);
+      unpackEdge(edge.middle, to, path);
+    }
+    return;
+  }
+}
+
+PathResult ContractionHierarchy::findPath(const std::string &fromStationId,
+                                          const std::string &toStationId) const {
+  EntityHandle source = catalog->getStationHandle(fromStationId);
+  EntityHandle target = catalog->getStationHandle(toStationId);
+  if (!isBuilt() || source == INVALID_HANDLE || target == INVALID_HANDLE) {
+    return PathResult();
+  }
+  return query(source, target, localWorkspace());
+}
+
+double ContractionHierarchy::shortestCost(const std::string &fromStationId,
+                                          const std::string &toStationId) const {
+  EntityHandle source = catalog->getStationHandle(fromStationId);
+  EntityHandle target = catalog->getStationHandle(toStationId);
+  if (!isBuilt() || source == INVALID_HANDLE || target == INVALID_HANDLE) {
+    return -1.0;
+  }
+  double cost = queryCost(source, target, localWorkspace());
+  return (cost < INF) ? cost : -1.0;
+}
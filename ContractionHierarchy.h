@@ -0,0 +1,75 @@
+#ifndef CONTRACTIONHIERARCHY_H
+#define CONTRACTIONHIERARCHY_H
+
+#include "RailNetwork.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// 收缩层次（Contraction Hierarchies）索引：离线按重要度逐个收缩站点并
+// 添加捷径边，查询时只沿等级升高的方向做双向搜索。索引可保存到文件，
+// 启动时加载后复用
+class ContractionHierarchy {
+public:
+  // 上行边：从低等级节点指向高等级节点（middle为捷径经过的节点，原始边为-1）
+  struct UpEdge {
+    int target;
+    int middle;
+    double weight;
+  };
+
+private:
+  std::shared_ptr<const EntityCatalog> catalog;
+  PathMetric metric;
+  std::vector<int> ranks; // 收缩次序，越大越重要
+  std::vector<int> upOffsets;
+  std::vector<UpEdge> upEdges;
+  uint64_t networkFingerprint; // 构建时网络的指纹，加载时用于校验
+  std::string lastError;
+
+public:
+  static const int WITNESS_SETTLE_LIMIT = 500; // 见证搜索的最大出堆节点数
+
+  // 构造函数
+  ContractionHierarchy();
+
+  // 由网络构建索引
+  void build(const RailNetwork &network, PathMetric pathMetric);
+
+  // 保存/加载；加载时要求与network节点数和指纹一致，并校验等级表为
+  // 排列、偏移表有效、上行边指向更高等级且捷径经过的节点等级低于两端，
+  // 任一校验失败时保留原有索引并返回false
+  bool saveToFile(const std::string &path);
+  bool loadFromFile(const std::string &path, const RailNetwork &network);
+  // 加载索引文件，失败或已过期时重新构建并保存
+  bool loadOrBuild(const std::string &path, const RailNetwork &network,
+                   PathMetric pathMetric);
+
+  bool isBuilt() const { return !upOffsets.empty(); }
+  PathMetric getMetric() const { return metric; }
+  int getNodeCount() const { return static_cast<int>(ranks.size()); }
+  int getShortcutCount() const;
+  std::string getLastError() const { return lastError; }
+
+  // 点对点查询；仅需代价时可用queryCost跳过路径展开
+  double queryCost(int source, int target, DijkstraWorkspace &workspace) const;
+  PathResult query(int source, int target, DijkstraWorkspace &workspace) const;
+
+  // 按站点ID查询（使用线程局部工作区）
+  PathResult findPath(const std::string &fromStationId,
+                      const std::string &toStationId) const;
+  // 最短代价，站点不存在或不可达返回-1
+  double shortestCost(const std::string &fromStationId,
+                      const std::string &toStationId) const;
+
+  // 网络指纹（节点、弧与权重的哈希）
+  static uint64_t fingerprint(const RailNetwork &network);
+
+private:
+  double search(int source, int target, DijkstraWorkspace &workspace,
+                int &meeting) const;
+  void unpackEdge(int from, int to, std::vector<EntityHandle> &path) const;
+};
+
+#endif // CONTRACTIONHIERARCHY_H
@@ -0,0 +1,127 @@
+#include "CsvWriter.h"
+#include <charconv>
+#include <cmath>
+
+// 构造函数
+CsvWriter::CsvWriter(const std::string &path, bool append, size_t bufferSize)
+    : flushThreshold(bufferSize), rowStarted(false), failed(false) {
+  file.open(path, append ? std::ios::binary | std::ios::app
+                         : std::ios::binary | std::ios::trunc);
+  buffer.reserve(bufferSize + 4096);
+}
+
+// 析构函数
+CsvWriter::~CsvWriter() { close(); }
+
+void CsvWriter::beginField() {
+  if (rowStarted) {
+    buffer.push_back(',');
+  }
+  rowStarted = true;
+}
+
+void CsvWriter::maybeFlush() {
+  if (buffer.size() >= flushThreshold) {
+    flush();
+  }
+}
+
+CsvWriter &CsvWriter::field(const std::string &value) {
+  beginField();
+  appendEscaped(buffer, value);
+  return *this;
+}
+
+CsvWriter &CsvWriter::field(const char *value) {
+  return field(std::string(value ? value : ""));
+}
+
+CsvWriter &CsvWriter::field(long long value) {
+  beginField();
+  appendNumber(buffer, value);
+  return *this;
+}
+
+CsvWriter &CsvWriter::field(double value) {
+  beginField();
+  appendNumber(buffer, value);
+  return *this;
+}
+
+void CsvWriter::endRow() {
+  buffer.push_back('\n');
+  rowStarted = false;
+  maybeFlush();
+}
+
+void CsvWriter::writeRaw(const std::string &text) {
+  if (text.size() >= flushThreshold) {
+    // 大块数据直接写出，避免再拷贝进缓冲区
+    flush();
+    if (file.is_open()) {
+      file.write(text.data(), static_cast<std::streamsize>(text.size()));
+      failed = failed || !file;
+    }
+    return;
+  }
+  buffer.append(text);
+  maybeFlush();
+}
+
+bool CsvWriter::flush() {
+  if (!file.is_open()) {
+    return false;
+  }
+  if (!buffer.empty()) {
+    file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    buffer.clear();
+  }
+  failed = failed || !file;
+  return !failed;
+}
+
+bool CsvWriter::close() {
+  if (!file.is_open()) {
+    return false;
+  }
+  if (rowStarted) {
+    endRow();
+  }
+  bool ok = flush();
+  file.close();
+  return ok && !file.fail();
+}
+
+// 按RFC 4180转义：含逗号、引号或换行的字段加引号，内部引号加倍
+void CsvWriter::appendEscaped(std::string &out, const std::string &value) {
+  if (value.find_first_of(",\"\r\n") == std::string::npos) {
+    out.append(value);
+    return;
+  }
+
+  out.push_back('"');
+  for (char c : value) {
+    if (c == '"') {
+      out.push_back('"');
+    }
+    out.push_back(c);
+  }
+  out.push_back('"');
+}
+
+void CsvWriter::appendNumber(std::string &out, long long value) {
+  char digits[24];
+  auto result = std::to_chars(digits, digits + sizeof(digits), value);
+  out.append(digits, result.ptr);
+}
+
+void CsvWriter::appendNumber(std::string &out, double value) {
+  if (!std::isfinite(value)) {
+    out.append("0");
+    return;
+  }
+  // 最短往返表示，解析后与原值完全一致
+  char digits[32];
+  auto result = std::to_chars(digits, digits + sizeof(digits), value);
+  out.append(digits, result.ptr);
+}
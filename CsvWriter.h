@@ -0,0 +1,98 @@
+#ifndef CSVWRITER_H
+#define CSVWRITER_H
+
+#include "ParallelUtils.h"
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// 高吞吐CSV写入器：行数据格式化到内存缓冲区，按大块写出
+class CsvWriter {
+private:
+  std::ofstream file;
+  std::string buffer;
+  size_t flushThreshold;
+  bool rowStarted; // 当前行是否已有字段
+  bool failed;
+
+public:
+  static const size_t DEFAULT_BUFFER_SIZE = 1 << 20; // 1MB
+  static const size_t PARTITION_ROWS = 16384;        // 并行格式化分区行数
+
+  // 构造函数
+  explicit CsvWriter(const std::string &path, bool append = false,
+                     size_t bufferSize = DEFAULT_BUFFER_SIZE);
+
+  // 析构函数（自动写出缓冲区并关闭文件）
+  ~CsvWriter();
+
+  CsvWriter(const CsvWriter &) = delete;
+  CsvWriter &operator=(const CsvWriter &) = delete;
+
+  bool isOpen() const { return file.is_open(); }
+
+  // 逐字段写入
+  CsvWriter &field(const std::string &value);
+  CsvWriter &field(const char *value);
+  CsvWriter &field(long long value);
+  CsvWriter &field(int value) { return field(static_cast<long long>(value)); }
+  CsvWriter &field(double value);
+  void endRow();
+
+  // 写入已格式化的文本（如表头或并行格式化的分区）
+  void writeRaw(const std::string &text);
+
+  // 并行格式化：rows按分区交给工作线程格式化，再按原顺序写出。
+  // formatRow(std::string &out, const T &row) 负责追加一行（含换行符）。
+  template <typename T, typename Fn>
+  void writeRowsParallel(const std::vector<T> &rows, Fn &&formatRow);
+
+  bool flush();
+  bool close();
+
+  // ========== 无中间字符串的格式化工具 ==========
+  static void appendEscaped(std::string &out, const std::string &value);
+  static void appendNumber(std::string &out, long long value);
+  static void appendNumber(std::string &out, double value);
+
+private:
+  void beginField();
+  void maybeFlush();
+};
+
+template <typename T, typename Fn>
+void CsvWriter::writeRowsParallel(const std::vector<T> &rows, Fn &&formatRow) {
+  if (rowStarted) {
+    endRow();
+  }
+
+  // 以"工作线程数×分区行数"为窗口推进，限制内存占用
+  size_t workers = parallelWorkerCount(rows.size(), PARTITION_ROWS);
+  size_t window = workers * PARTITION_ROWS * 4;
+  std::vector<std::string> partitions;
+
+  for (size_t base = 0; base < rows.size(); base += window) {
+    size_t windowRows = std::min(window, rows.size() - base);
+    size_t partitionCount = (windowRows + PARTITION_ROWS - 1) / PARTITION_ROWS;
+    partitions.assign(partitionCount, std::string());
+
+    parallelFor(partitionCount, [&](size_t begin, size_t end, unsigned) {
+      for (size_t p = begin; p < end; ++p) {
+        size_t first = base + p * PARTITION_ROWS;
+        size_t last = std::min(first + PARTITION_ROWS, base + windowRows);
+        std::string &out = partitions[p];
+        out.reserve((last - first) * 64);
+        for (size_t i = first; i < last; ++i) {
+          formatRow(out, rows[i]);
+        }
+      }
+    });
+
+    for (const auto &part : partitions) {
+      writeRaw(part);
+    }
+  }
+}
+
+#endif // CSVWRITER_H
@@ -1,4 +1,6 @@
 #include "DataAnalyzer.h"
+#include "NetworkResilience.h"
+#include "SectionLoadIndex.h"
 #include <algorithm>
 #include <cmath>
 #include <iostream>
@@ -6,35 +8,21 @@
 #include <sstream>
 
 // 构造函数
-DataAnalyzer::DataAnalyzer() : passengerFlow(nullptr) {}
+DataAnalyzer::DataAnalyzer()
+    : catalog(EntityCatalog::empty()), passengerFlow(nullptr) {}
 
-DataAnalyzer::DataAnalyzer(std::shared_ptr<PassengerFlow> flow)
-    : passengerFlow(flow) {}
+DataAnalyzer::DataAnalyzer(std::shared_ptr<PassengerFlow> flow,
+                           std::shared_ptr<const EntityCatalog> entityCatalog)
+    : catalog(entityCatalog ? entityCatalog : EntityCatalog::empty()),
+      passengerFlow(flow) {}
 
 // 析构函数
-DataAnalyzer::~DataAnalyzer() {
-  stations.clear();
-  routes.clear();
-  trains.clear();
-}
+DataAnalyzer::~DataAnalyzer() {}
 
 // 数据管理
-void DataAnalyzer::addStation(std::shared_ptr<Station> station) {
-  if (station) {
-    stations.push_back(station);
-  }
-}
-
-void DataAnalyzer::addRoute(std::shared_ptr<Route> route) {
-  if (route) {
-    routes.push_back(route);
-  }
-}
-
-void DataAnalyzer::addTrain(std::shared_ptr<Train> train) {
-  if (train) {
-    trains.push_back(train);
-  }
+void DataAnalyzer::setCatalog(
+    std::shared_ptr<const EntityCatalog> entityCatalog) {
+  catalog = entityCatalog ? entityCatalog : EntityCatalog::empty();
 }
 
 void DataAnalyzer::setPassengerFlow(std::shared_ptr<PassengerFlow> flow) {
@@ -115,6 +103,94 @@ ChartData DataAnalyzer::generateStationRankingChart() const {
   return chart;
 }
 
+// 列车载客率分析（最近一日）：断面客流按停站顺序的前缀和计算
+AnalysisResult DataAnalyzer::analyzeTrainLoadFactor() const {
+  AnalysisResult result("列车载客率分析", "按停站顺序计算各列车断面客流");
+
+  if (!passengerFlow || passengerFlow->getRecords().empty()) {
+    return result;
+  }
+
+  Date latest = passengerFlow->getRecords().front().getDate();
+  for (const auto &record : passengerFlow->getRecords()) {
+    if (latest < record.getDate()) {
+      latest = record.getDate();
+    }
+  }
+
+  SectionLoadIndex index(catalog);
+  index.compute(*passengerFlow, latest);
+
+  int loadedTrains = 0;
+  int overloadedTrains = 0;
+  int peakLoad = 0;
+  double peakFactorSum = 0.0;
+  double passengerKm = 0.0;
+  double seatKm = 0.0;
+  for (const auto &profile : index.getTrainProfiles()) {
+    if (profile.boarded == 0) {
+      continue;
+    }
+    loadedTrains++;
+    if (profile.peakLoad > profile.capacity) {
+      overloadedTrains++;
+    }
+    peakLoad = std::max(peakLoad, profile.peakLoad);
+    peakFactorSum += profile.getPeakLoadFactor();
+    passengerKm += profile.passengerKm;
+    seatKm += profile.capacity * profile.getLength();
+  }
+
+  result.data["有客流列车数"] = static_cast<double>(loadedTrains);
+  result.data["超员列车数"] = static_cast<double>(overloadedTrains);
+  result.data["最大断面客流"] = static_cast<double>(peakLoad);
+  result.data["平均最大断面满载率%"] =
+      loadedTrains > 0 ? peakFactorSum / loadedTrains * 100.0 : 0.0;
+  result.data["总人公里"] = passengerKm;
+  result.data["平均满载率%"] = seatKm > 0 ? passengerKm / seatKm * 100.0 : 0.0;
+
+  for (const auto &segment : index.getBusiestSegments(5)) {
+    if (segment.passengers == 0) {
+      break;
+    }
+    result.data["区间满载率%-" +
+                catalog->getStation(segment.fromStation)->getStationName() +
+                "-" +
+                catalog->getStation(segment.toStation)->getStationName()] =
+        segment.getLoadFactor() * 100.0;
+  }
+
+  return result;
+}
+
+ChartData DataAnalyzer::generateLoadFactorChart(const Date &date) const {
+  ChartData chart("bar", "列车最大断面满载率");
+  chart.unit = "%";
+
+  if (!passengerFlow) {
+    return chart;
+  }
+
+  SectionLoadIndex index(catalog);
+  index.compute(*passengerFlow, date);
+  auto loadFactors = index.getLoadFactors();
+
+  std::vector<std::pair<std::string, double>> ranking(loadFactors.begin(),
+                                                      loadFactors.end());
+  std::sort(ranking.begin(), ranking.end(),
+            [](const std::pair<std::string, double> &a,
+               const std::pair<std::string, double> &b) {
+              return a.second > b.second;
+            });
+
+  for (const auto &pair : ranking) {
+    chart.labels.push_back(pair.first);
+    chart.values.push_back(pair.second);
+  }
+
+  return chart;
+}
+
 // 方向性分析
 AnalysisResult DataAnalyzer::analyzeDirectionalFlow() const {
   AnalysisResult result("方向性流量分析", "分析川渝双向客流");
@@ -296,33 +372,17 @@ bool DataAnalyzer::isValidTrainId(const std::string &trainId) const {
 
 std::shared_ptr<Station>
 DataAnalyzer::findStation(const std::string &stationId) const {
-  auto it =
-      std::find_if(stations.begin(), stations.end(),
-                   [&stationId](const std::shared_ptr<Station> &station) {
-                     return station && station->getStationId() == stationId;
-                   });
-
-  return (it != stations.end()) ? *it : nullptr;
+  return catalog->findStation(stationId);
 }
 
 std::shared_ptr<Route>
 DataAnalyzer::findRoute(const std::string &routeId) const {
-  auto it = std::find_if(routes.begin(), routes.end(),
-                         [&routeId](const std::shared_ptr<Route> &route) {
-                           return route && route->getRouteId() == routeId;
-                         });
-
-  return (it != routes.end()) ? *it : nullptr;
+  return catalog->findRoute(routeId);
 }
 
 std::shared_ptr<Train>
 DataAnalyzer::findTrain(const std::string &trainId) const {
-  auto it = std::find_if(trains.begin(), trains.end(),
-                         [&trainId](const std::shared_ptr<Train> &train) {
-                           return train && train->getTrainId() == trainId;
-                         });
-
-  return (it != trains.end()) ? *it : nullptr;
+  return catalog->findTrain(trainId);
 }
 
 // ========== 高级算法功能实现 ==========
@@ -470,6 +530,7 @@ DataAnalyzer::compareTimeSeriesMethods(const std::string &stationId,
 // K-means聚类分析 - 按客流量聚类站点
 ClusterResult
 DataAnalyzer::clusterStationsByFlow(int k, const std::string &method) const {
+  const auto &stations = catalog->getStations();
   ClusterResult result;
 
   if (!passengerFlow || stations.empty()) {
@@ -498,6 +559,7 @@ DataAnalyzer::clusterStationsByFlow(int k, const std::string &method) const {
 
 // 按出行模式聚类
 ClusterResult DataAnalyzer::clusterByTravelPatterns(int k) const {
+  const auto &stations = catalog->getStations();
   ClusterResult result;
 
   if (!passengerFlow) {
@@ -539,6 +601,7 @@ ClusterResult DataAnalyzer::clusterByTravelPatterns(int k) const {
 
 // 按时间模式聚类
 ClusterResult DataAnalyzer::clusterByTimePatterns(int k) const {
+  const auto &stations = catalog->getStations();
   ClusterResult result;
 
   // 分析一周内不同天的客流模式
@@ -609,7 +672,7 @@ AnalysisResult DataAnalyzer::mineTemporalPatterns() const {
   std::vector<int> hourlyTotal(24, 0);
   Date today(2024, 12, 15);
 
-  for (const auto &station : stations) {
+  for (const auto &station : catalog->getStations()) {
     auto hourlyFlow =
         passengerFlow->getStationHourlyFlow(station->getStationId(), today);
     for (size_t i = 0; i < hourlyFlow.size() && i < 24; i++) {
@@ -654,6 +717,7 @@ AnalysisResult DataAnalyzer::mineTemporalPatterns() const {
 
 // 空间模式挖掘
 AnalysisResult DataAnalyzer::mineSpatialPatterns() const {
+  const auto &stations = catalog->getStations();
   AnalysisResult result("空间模式挖掘", "发现客流的空间分布规律");
 
   if (!passengerFlow || stations.empty()) {
@@ -720,6 +784,7 @@ AnalysisResult DataAnalyzer::mineSpatio_TemporalPatterns() const {
 
 // 异常检测
 AnalysisResult DataAnalyzer::identifyFlowAnomalies() const {
+  const auto &stations = catalog->getStations();
   AnalysisResult result("客流异常检测", "识别异常的客流模式");
 
   if (!passengerFlow || stations.empty()) {
@@ -764,6 +829,7 @@ AnalysisResult DataAnalyzer::identifyFlowAnomalies() const {
 
 // 站点关联性分析
 StationCorrelation DataAnalyzer::analyzeStationCorrelations() const {
+  const auto &stations = catalog->getStations();
   StationCorrelation correlation;
 
   if (!passengerFlow || stations.size() < 2) {
@@ -804,28 +870,42 @@ StationCorrelation DataAnalyzer::analyzeStationCorrelations() const {
   return correlation;
 }
 
-// 换乘效率分析
+// 换乘效率分析：换乘站由经停线路数判定。换乘量按客流在各经停线路间
+// 均匀分布估计，k条线路经停时跨线客流占比为1 - 1/k
 AnalysisResult DataAnalyzer::analyzeTransferEfficiency() const {
   AnalysisResult result("换乘效率分析", "分析换乘站点的运营效率");
 
   double totalTransferFlow = 0;
-  int transferStationCount = 0;
+  double totalInterchange = 0;
+  size_t totalRoutes = 0;
+  size_t totalTrains = 0;
+  const auto &transferStations = catalog->getTransferStations();
+
+  for (EntityHandle handle : transferStations) {
+    const auto &station = catalog->getStation(handle);
+    size_t routeCount = catalog->getRoutesAtStation(handle).size();
+    size_t trainCount = catalog->getTrainsAtStation(handle).size();
+    int stationFlow =
+        passengerFlow->getStationTotalFlow(station->getStationId());
+    double interchange =
+        routeCount >= 2 ? stationFlow * (1.0 - 1.0 / routeCount) : 0.0;
+    totalTransferFlow += stationFlow;
+    totalInterchange += interchange;
+    totalRoutes += routeCount;
+    totalTrains += trainCount;
 
-  for (const auto &station : stations) {
-    if (station->getIsTransferStation()) {
-      int stationFlow =
-          passengerFlow->getStationTotalFlow(station->getStationId());
-      totalTransferFlow += stationFlow;
-      transferStationCount++;
-
-      result.data[station->getStationName() + "客流"] =
-          static_cast<double>(stationFlow);
-    }
+    result.data[station->getStationName() + "客流"] =
+        static_cast<double>(stationFlow);
+    result.data[station->getStationName() + "换乘量"] = interchange;
   }
 
-  if (transferStationCount > 0) {
-    result.data["换乘站平均客流"] = totalTransferFlow / transferStationCount;
-    result.data["换乘站数量"] = static_cast<double>(transferStationCount);
+  if (!transferStations.empty()) {
+    double count = static_cast<double>(transferStations.size());
+    result.data["换乘站平均客流"] = totalTransferFlow / count;
+    result.data["换乘站数量"] = count;
+    result.data["换乘站平均线路数"] = totalRoutes / count;
+    result.data["换乘站平均经停列车数"] = totalTrains / count;
+    result.data["估计换乘总量"] = totalInterchange;
   }
 
   return result;
@@ -843,15 +923,11 @@ AnalysisResult DataAnalyzer::optimizeTransferGuidance() const {
 
   for (const auto &pair : correlations.stronglyCorrelated) {
     // 检查是否涉及换乘站
-    bool hasTransferStation = false;
-    for (const auto &station : stations) {
-      if (station->getIsTransferStation() &&
-          (station->getStationName() == pair.first ||
-           station->getStationName() == pair.second)) {
-        hasTransferStation = true;
-        break;
-      }
-    }
+    EntityHandle first = catalog->getStationHandleByName(pair.first);
+    EntityHandle second = catalog->getStationHandleByName(pair.second);
+    bool hasTransferStation =
+        (first != INVALID_HANDLE && catalog->isTransferStation(first)) ||
+        (second != INVALID_HANDLE && catalog->isTransferStation(second));
 
     if (hasTransferStation) {
       improvementPotential += 10.0; // 假设每个相关换乘站对可提升10%效率
@@ -865,32 +941,58 @@ AnalysisResult DataAnalyzer::optimizeTransferGuidance() const {
   return result;
 }
 
-// 网络韧性分析
+// 网络韧性分析：割点与桥，以及关闭各站点后滞留的客流
 AnalysisResult DataAnalyzer::analyzeNetworkResilience() const {
-  AnalysisResult result("网络韧性分析", "评估轨道交通网络的抗干扰能力");
+  const auto &stations = catalog->getStations();
+  AnalysisResult result("网络韧性分析", "评估关闭站点或区间对网络连通性的影响");
 
-  // 计算网络连通性指标
+  // 各站点客流作为滞留客流的权重
+  std::vector<double> flows(stations.size(), 0.0);
   double totalFlow = 0;
-  int criticalStations = 0;
-
-  for (const auto &station : stations) {
-    int stationFlow =
-        passengerFlow->getStationTotalFlow(station->getStationId());
-    totalFlow += stationFlow;
-
-    // 关键站点定义：客流量超过平均值2倍
-    if (stationFlow > (totalFlow / stations.size()) * 2) {
-      criticalStations++;
+  for (size_t i = 0; i < stations.size(); ++i) {
+    flows[i] = passengerFlow->getStationTotalFlow(stations[i]->getStationId());
+    totalFlow += flows[i];
+  }
+
+  RailNetwork network(catalog);
+  NetworkResilience resilience(network, flows);
+  std::vector<EntityHandle> articulationPoints =
+      resilience.getArticulationPoints();
+  int connectedStations = 0;
+  for (EntityHandle station = 0; station < network.getNodeCount();
+       ++station) {
+    if (network.getDegree(station) > 0) {
+      connectedStations++;
     }
   }
 
-  double avgFlow = totalFlow / stations.size();
-  double resilience =
-      1.0 - (static_cast<double>(criticalStations) / stations.size());
-
-  result.data["网络韧性指数"] = resilience;
-  result.data["关键站点数"] = static_cast<double>(criticalStations);
-  result.data["平均站点客流"] = avgFlow;
+  // 韧性指数：关闭后不会使网络分裂的连通站点比例
+  double resilienceIndex =
+      connectedStations > 0
+          ? 1.0 - static_cast<double>(articulationPoints.size()) /
+                      connectedStations
+          : 1.0;
+
+  result.data["网络韧性指数"] = resilienceIndex;
+  result.data["关键站点数"] = static_cast<double>(articulationPoints.size());
+  result.data["平均站点客流"] =
+      stations.empty() ? 0.0 : totalFlow / stations.size();
+  result.data["桥区间数"] = static_cast<double>(resilience.getBridges().size());
+  result.data["连通分量数"] =
+      static_cast<double>(resilience.getComponentCount());
+
+  // 关闭影响最大的前5个站点
+  std::vector<StationImpact> ranking = resilience.rankStations();
+  for (size_t i = 0; i < ranking.size() && i < 5; ++i) {
+    if (!ranking[i].articulation) {
+      break;
+    }
+    const std::string &name =
+        catalog->getStation(ranking[i].station)->getStationName();
+    result.data["滞留客流-" + name] = ranking[i].strandedFlow;
+    result.data["失联站点数-" + name] =
+        static_cast<double>(ranking[i].strandedStations);
+  }
 
   return result;
 }
@@ -985,7 +1087,8 @@ double DataAnalyzer::calculateCorrelation(const std::vector<double> &x,
 std::vector<std::vector<double>> DataAnalyzer::extractStationFeatures() const {
   std::vector<std::vector<double>> features;
 
-  for (const auto &station : stations) {
+  for (EntityHandle handle = 0; handle < catalog->getStationCount(); ++handle) {
+    const auto &station = catalog->getStation(handle);
     std::vector<double> stationFeatures;
 
     // 特征1: 总客流量
@@ -995,8 +1098,8 @@ std::vector<std::vector<double>> DataAnalyzer::extractStationFeatures() const {
     // 特征2: 平台数量
     stationFeatures.push_back(static_cast<double>(station->getPlatformCount()));
 
-    // 特征3: 是否为换乘站
-    stationFeatures.push_back(station->getIsTransferStation() ? 1.0 : 0.0);
+    // 特征3: 是否为换乘站（含多线路经停）
+    stationFeatures.push_back(catalog->isTransferStation(handle) ? 1.0 : 0.0);
 
     features.push_back(stationFeatures);
   }
@@ -1,6 +1,7 @@
 #ifndef DATAANALYZER_H
 #define DATAANALYZER_H
 
+#include "EntityCatalog.h"
 #include "PassengerFlow.h"
 #include "Route.h"
 #include "Station.h"
@@ -64,23 +65,23 @@ struct StationCorrelation {
 
 class DataAnalyzer {
 private:
-  std::vector<std::shared_ptr<Station>> stations;
-  std::vector<std::shared_ptr<Route>> routes;
-  std::vector<std::shared_ptr<Train>> trains;
+  std::shared_ptr<const EntityCatalog> catalog; // 共享只读实体目录
   std::shared_ptr<PassengerFlow> passengerFlow;
 
 public:
   // 构造函数
   DataAnalyzer();
-  DataAnalyzer(std::shared_ptr<PassengerFlow> flow);
+  DataAnalyzer(std::shared_ptr<PassengerFlow> flow,
+               std::shared_ptr<const EntityCatalog> entityCatalog = nullptr);
 
   // 析构函数
   ~DataAnalyzer();
 
   // 数据管理
-  void addStation(std::shared_ptr<Station> station);
-  void addRoute(std::shared_ptr<Route> route);
-  void addTrain(std::shared_ptr<Train> train);
+  void setCatalog(std::shared_ptr<const EntityCatalog> entityCatalog);
+  const std::shared_ptr<const EntityCatalog> &getCatalog() const {
+    return catalog;
+  }
   void setPassengerFlow(std::shared_ptr<PassengerFlow> flow);
 
   // 站点分析
@@ -194,9 +195,9 @@ public:
   std::string generateFullReport() const;
 
   // 统计信息
-  int getTotalStations() const { return static_cast<int>(stations.size()); }
-  int getTotalRoutes() const { return static_cast<int>(routes.size()); }
-  int getTotalTrains() const { return static_cast<int>(trains.size()); }
+  int getTotalStations() const { return catalog->getStationCount(); }
+  int getTotalRoutes() const { return catalog->getRouteCount(); }
+  int getTotalTrains() const { return catalog->getTrainCount(); }
 
   // 辅助方法
   bool isValidStationId(const std::string &stationId) const;
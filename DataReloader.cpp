@@ -0,0 +1,259 @@
+#include "DataReloader.h"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+// 刷新结果描述
+std::string ReloadSummary::toString() const {
+  std::ostringstream oss;
+  oss << "数据刷新: ";
+  if (!anyChange()) {
+    oss << "无变化";
+  } else {
+    if (stationsReloaded)
+      oss << "站点已重载 ";
+    if (routesReloaded)
+      oss << "线路已重载 ";
+    if (trainsReloaded)
+      oss << "列车已重载 ";
+    if (flowReloaded)
+      oss << "客流已全量重载 ";
+    if (appendedFlowRecords > 0)
+      oss << "客流追加" << appendedFlowRecords << "条";
+  }
+  if (!error.empty()) {
+    oss << " (错误: " << error << ")";
+  }
+  return oss.str();
+}
+
+// 构造函数
+DataReloader::DataReloader(FileManager &manager, bool verifyTailHash)
+    : fileManager(manager), verifyContent(verifyTailHash),
+      catalog(EntityCatalog::empty()) {}
+
+// 全量加载
+bool DataReloader::initialLoad(std::vector<std::shared_ptr<Station>> &stations,
+                               std::vector<std::shared_ptr<Route>> &routes,
+                               std::vector<std::shared_ptr<Train>> &trains,
+                               PassengerFlow &passengerFlow) {
+  // 先取指纹再加载，加载期间发生的修改会在下次刷新时被发现
+  stationsPrint = takeFingerprint(fileManager.getStationsPath(), 0);
+  routesPrint = takeFingerprint(fileManager.getRoutesPath(), 0);
+  trainsPrint = takeFingerprint(fileManager.getTrainsPath(), 0);
+  flowPrint = takeFingerprint(fileManager.getFlowRecordsPath(), 0);
+
+  passengerFlow.clearAllRecords();
+  // 客流记录须全部加载，已解析位置为实际消费到的最后一个完整行之后
+  long parsed = 0;
+  bool ok = fileManager.importAllData(stations, routes, trains, passengerFlow,
+                                      FileManager::NO_RECORD_LIMIT, &parsed);
+  rebuildCatalog(stations, routes, trains);
+  if (!ok) {
+    // 清空指纹，下次刷新时全部重新加载
+    stationsPrint = routesPrint = trainsPrint = flowPrint = FileFingerprint();
+    return false;
+  }
+  flowPrint = takeFingerprint(fileManager.getFlowRecordsPath(), parsed);
+  return true;
+}
+
+// 增量刷新
+ReloadSummary DataReloader::refresh(
+    std::vector<std::shared_ptr<Station>> &stations,
+    std::vector<std::shared_ptr<Route>> &routes,
+    std::vector<std::shared_ptr<Train>> &trains,
+    PassengerFlow &passengerFlow) {
+  ReloadSummary summary;
+  fileManager.clearError();
+
+  std::string stationsPath = fileManager.getStationsPath();
+  std::string routesPath = fileManager.getRoutesPath();
+  std::string trainsPath = fileManager.getTrainsPath();
+  FileFingerprint newStations = takeFingerprint(stationsPath, 0);
+  FileFingerprint newRoutes = takeFingerprint(routesPath, 0);
+  FileFingerprint newTrains = takeFingerprint(trainsPath, 0);
+
+  // 依赖关系：站点变化需重建线路；列车表不含线路，但线路变化后需按新
+  // 线路重新生成（合成）列车的线路与时刻表，因此同样重载列车
+  summary.stationsReloaded = !isUnchanged(stationsPrint, newStations);
+  summary.routesReloaded =
+      summary.stationsReloaded || !isUnchanged(routesPrint, newRoutes);
+  summary.trainsReloaded =
+      summary.routesReloaded || !isUnchanged(trainsPrint, newTrains);
+
+  if (summary.trainsReloaded) {
+    std::vector<std::shared_ptr<Station>> loadedStations = stations;
+    std::vector<std::shared_ptr<Route>> loadedRoutes = routes;
+    std::vector<std::shared_ptr<Train>> loadedTrains;
+    std::string error;
+    if (summary.stationsReloaded) {
+      if (!fileManager.importTopology(loadedStations, loadedRoutes,
+                                      loadedTrains)) {
+        error = fileManager.getLastError();
+      }
+    } else {
+      if (summary.routesReloaded) {
+        loadedRoutes = fileManager.loadRoutes(stations);
+      }
+      if (!loadedRoutes.empty()) {
+        loadedTrains = fileManager.loadTrains();
+      }
+    }
+    // 文件缺失或为空均视为加载失败；加载期间文件再次变化说明尚未写完
+    if (error.empty() &&
+        (loadedStations.empty() || loadedRoutes.empty() ||
+         loadedTrains.empty())) {
+      error = fileManager.getLastError().empty()
+                  ? "拓扑文件为空"
+                  : fileManager.getLastError();
+    }
+    if (error.empty() &&
+        (!isUnchanged(newStations, takeFingerprint(stationsPath, 0)) ||
+         !isUnchanged(newRoutes, takeFingerprint(routesPath, 0)) ||
+         !isUnchanged(newTrains, takeFingerprint(trainsPath, 0)))) {
+      error = "拓扑文件在加载期间被修改";
+    }
+
+    if (error.empty()) {
+      stations.swap(loadedStations);
+      routes.swap(loadedRoutes);
+      trains.swap(loadedTrains);
+      stationsPrint = newStations;
+      routesPrint = newRoutes;
+      trainsPrint = newTrains;
+      rebuildCatalog(stations, routes, trains);
+    } else {
+      // loadRoutes会改写现有站点的换乘标记，按现有线路恢复
+      if (!summary.stationsReloaded && summary.routesReloaded) {
+        FileManager::markTransferStations(stations, routes);
+      }
+      summary.stationsReloaded = false;
+      summary.routesReloaded = false;
+      summary.trainsReloaded = false;
+      summary.error = error;
+    }
+  }
+
+  // 客流文件：未变 / 仅追加 / 整体重写。已解析位置之后仍有数据（加载
+  // 期间追加或末尾有未写完的行）时同样交给尾部导入
+  std::string flowPath = fileManager.getFlowRecordsPath();
+  FileFingerprint newFlow = takeFingerprint(flowPath, flowPrint.parsedOffset);
+  if (!newFlow.exists) {
+    if (flowPrint.exists) {
+      summary.error = "客流数据文件不存在: " + flowPath;
+    }
+  } else if (!isUnchanged(flowPrint, newFlow) ||
+             newFlow.size > flowPrint.parsedOffset) {
+    if (isAppendOnly(flowPath, flowPrint, newFlow)) {
+      long nextOffset = flowPrint.parsedOffset;
+      int added = fileManager.loadFlowRecordsTail(
+          passengerFlow, flowPrint.parsedOffset, nextOffset);
+      summary.appendedFlowRecords = added > 0 ? added : 0;
+      flowPrint = takeFingerprint(flowPath, nextOffset);
+    } else {
+      PassengerFlow reloaded;
+      long parsed = 0;
+      if (fileManager.loadFlowRecords(reloaded, FileManager::NO_RECORD_LIMIT,
+                                      &parsed)) {
+        passengerFlow = reloaded;
+        summary.flowReloaded = true;
+        flowPrint = takeFingerprint(flowPath, parsed);
+      } else if (summary.error.empty()) {
+        summary.error = fileManager.getLastError();
+      }
+    }
+  }
+
+  if (summary.error.empty()) {
+    summary.error = fileManager.getLastError();
+  }
+  return summary;
+}
+
+void DataReloader::rebuildCatalog(
+    const std::vector<std::shared_ptr<Station>> &stations,
+    const std::vector<std::shared_ptr<Route>> &routes,
+    const std::vector<std::shared_ptr<Train>> &trains) {
+  if (scheduleBuilder) {
+    scheduleBuilder(routes, trains);
+  }
+  catalog = EntityCatalog::build(stations, routes, trains);
+}
+
+// 生成文件指纹
+FileFingerprint DataReloader::takeFingerprint(const std::string &path,
+                                              long parsedOffset) const {
+  FileFingerprint print;
+  std::error_code ec;
+  auto size = std::filesystem::file_size(path, ec);
+  if (ec) {
+    return print;
+  }
+  auto modified = std::filesystem::last_write_time(path, ec);
+  if (ec) {
+    return print;
+  }
+
+  print.exists = true;
+  print.size = static_cast<long>(size);
+  print.modifiedTime =
+      static_cast<long long>(modified.time_since_epoch().count());
+  print.parsedOffset = std::min(parsedOffset, print.size);
+  if (verifyContent) {
+    print.tailHash = hashTailBlock(path, print.parsedOffset);
+  }
+  return print;
+}
+
+// 计算[endOffset - TAIL_BLOCK_SIZE, endOffset)数据块的FNV-1a哈希
+uint64_t DataReloader::hashTailBlock(const std::string &path,
+                                     long endOffset) const {
+  uint64_t hash = 14695981039346656037ULL;
+  if (endOffset <= 0) {
+    return hash;
+  }
+
+  long begin = std::max(0L, endOffset - TAIL_BLOCK_SIZE);
+  std::ifstream file(path, std::ios::binary);
+  if (!file.is_open()) {
+    return hash;
+  }
+
+  char buffer[TAIL_BLOCK_SIZE];
+  file.seekg(begin);
+  file.read(buffer, endOffset - begin);
+  std::streamsize count = file.gcount();
+  for (std::streamsize i = 0; i < count; ++i) {
+    hash ^= static_cast<unsigned char>(buffer[i]);
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+bool DataReloader::isUnchanged(const FileFingerprint &previous,
+                               const FileFingerprint &current) const {
+  if (previous.exists != current.exists) {
+    return false;
+  }
+  if (!current.exists) {
+    return true;
+  }
+  return previous.size == current.size &&
+         previous.modifiedTime == current.modifiedTime &&
+         previous.tailHash == current.tailHash;
+}
+
+// 判断文件是否只在已解析位置之后追加了内容
+bool DataReloader::isAppendOnly(const std::string &path,
+                                const FileFingerprint &previous,
+                                const FileFingerprint &current) const {
+  if (!previous.exists || !current.exists ||
+      current.size < previous.parsedOffset) {
+    return false;
+  }
+  if (!verifyContent) {
+    return true; // 未启用内容校验时仅依据大小增长判断
+  }
+  return hashTailBlock(path, previous.parsedOffset) == previous.tailHash;
+}
@@ -0,0 +1,113 @@
+#ifndef DATARELOADER_H
+#define DATARELOADER_H
+
+#include "EntityCatalog.h"
+#include "FileManager.h"
+#include "PassengerFlow.h"
+#include "Route.h"
+#include "Station.h"
+#include "Train.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// 文件指纹
+struct FileFingerprint {
+  bool exists;            // 文件是否存在
+  long size;              // 文件大小（字节）
+  long long modifiedTime; // 最后修改时间（文件时钟计数）
+  long parsedOffset;      // 已解析到的字节偏移（仅追加型文件使用）
+  uint64_t tailHash;      // parsedOffset之前末尾数据块的哈希
+
+  FileFingerprint()
+      : exists(false), size(0), modifiedTime(0), parsedOffset(0),
+        tailHash(0) {}
+};
+
+// 单次刷新的结果
+struct ReloadSummary {
+  bool stationsReloaded;
+  bool routesReloaded;
+  bool trainsReloaded;
+  bool flowReloaded;       // 客流文件整体重新加载
+  int appendedFlowRecords; // 客流文件增量追加的记录数
+  std::string error;
+
+  ReloadSummary()
+      : stationsReloaded(false), routesReloaded(false), trainsReloaded(false),
+        flowReloaded(false), appendedFlowRecords(0) {}
+  bool anyChange() const {
+    return stationsReloaded || routesReloaded || trainsReloaded ||
+           flowReloaded || appendedFlowRecords > 0;
+  }
+  std::string toString() const;
+};
+
+// 基于变更检测的增量数据重载管理器。拓扑文件先加载到临时容器，全部
+// 成功且加载期间文件未再变化时才替换现有数据并重建实体目录；失败时保留
+// 现有数据与旧指纹，下次刷新重试
+class DataReloader {
+public:
+  // 为新加载的列车绑定合成线路、生成时刻表（如按需调用TimetableGenerator）
+  using ScheduleBuilder =
+      std::function<void(const std::vector<std::shared_ptr<Route>> &,
+                         const std::vector<std::shared_ptr<Train>> &)>;
+
+private:
+  FileManager &fileManager;
+  bool verifyContent; // 是否校验末尾数据块哈希
+  ScheduleBuilder scheduleBuilder;
+  std::shared_ptr<const EntityCatalog> catalog;
+
+  FileFingerprint stationsPrint;
+  FileFingerprint routesPrint;
+  FileFingerprint trainsPrint;
+  FileFingerprint flowPrint;
+
+public:
+  static const long TAIL_BLOCK_SIZE = 4096; // 末尾校验块大小
+
+  // 构造函数
+  explicit DataReloader(FileManager &manager, bool verifyTailHash = true);
+
+  // 全量加载并记录所有文件指纹
+  bool initialLoad(std::vector<std::shared_ptr<Station>> &stations,
+                   std::vector<std::shared_ptr<Route>> &routes,
+                   std::vector<std::shared_ptr<Train>> &trains,
+                   PassengerFlow &passengerFlow);
+
+  // 列车重新加载后、重建目录前调用
+  void setScheduleBuilder(ScheduleBuilder builder) {
+    scheduleBuilder = std::move(builder);
+  }
+  // 与当前站点、线路、列车一致的共享目录（初次加载与每次拓扑替换后重建）
+  std::shared_ptr<const EntityCatalog> getCatalog() const { return catalog; }
+
+  // 只重新解析发生变化的文件；追加型客流文件只导入新增的尾部
+  ReloadSummary refresh(std::vector<std::shared_ptr<Station>> &stations,
+                        std::vector<std::shared_ptr<Route>> &routes,
+                        std::vector<std::shared_ptr<Train>> &trains,
+                        PassengerFlow &passengerFlow);
+
+  // 查询指纹
+  const FileFingerprint &getStationsFingerprint() const {
+    return stationsPrint;
+  }
+  const FileFingerprint &getFlowFingerprint() const { return flowPrint; }
+
+private:
+  void rebuildCatalog(const std::vector<std::shared_ptr<Station>> &stations,
+                      const std::vector<std::shared_ptr<Route>> &routes,
+                      const std::vector<std::shared_ptr<Train>> &trains);
+  FileFingerprint takeFingerprint(const std::string &path,
+                                  long parsedOffset) const;
+  uint64_t hashTailBlock(const std::string &path, long endOffset) const;
+  bool isUnchanged(const FileFingerprint &previous,
+                   const FileFingerprint &current) const;
+  bool isAppendOnly(const std::string &path, const FileFingerprint &previous,
+                    const FileFingerprint &current) const;
+};
+
+#endif // DATARELOADER_H
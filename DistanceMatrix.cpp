@@ -0,0 +1,344 @@
+#include "DistanceMatrix.h"
+#include "ParallelUtils.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <limits>
+
+namespace {
+
+const float INF_FLOAT = std::numeric_limits<float>::infinity();
+const char FILE_MAGIC[4] = {'R', 'D', 'M', '1'};
+const uint32_t FILE_VERSION = 1;
+const size_t MATRIX_ALIGNMENT = 64;
+
+// 区域子网（局部编号的CSR）
+struct SubNetwork {
+  std::vector<int> offsets;
+  std::vector<int> targets;
+  std::vector<double> weights;
+};
+
+SubNetwork extractSubNetwork(const RailNetwork &network,
+                             const std::vector<EntityHandle> &stations,
+                             const std::vector<int> &rowOfStation,
+                             PathMetric metric) {
+  SubNetwork sub;
+  sub.offsets.assign(stations.size() + 1, 0);
+  const auto &offsets = network.getOffsets();
+  const auto &edges = network.getEdges();
+  for (size_t row = 0; row < stations.size(); ++row) {
+    EntityHandle node = stations[row];
+    for (int e = offsets[node]; e < offsets[node + 1]; ++e) {
+      int target = rowOfStation[edges[e].target];
+      if (target >= 0) {
+        sub.targets.push_back(target);
+        sub.weights.push_back(edges[e].weight(metric));
+      }
+    }
+    sub.offsets[row + 1] = static_cast<int>(sub.targets.size());
+  }
+  return sub;
+}
+
+// 分块Floyd–Warshall：以k块为轴，先算对角块，再算同行同列块，最后其余块
+void floydWarshallBlocked(std::vector<float> &dist, size_t n) {
+  const size_t B = DistanceMatrix::BLOCK_SIZE;
+  size_t blocks = (n + B - 1) / B;
+
+  auto relaxBlock = [&dist, n, B](size_t ib, size_t jb, size_t kb) {
+    size_t iEnd = std::min(n, (ib + 1) * B);
+    size_t jEnd = std::min(n, (jb + 1) * B);
+    size_t kEnd = std::min(n, (kb + 1) * B);
+    for (size_t k = kb * B; k < kEnd; ++k) {
+      const float *rowK = &dist[k * n];
+      for (size_t i = ib * B; i < iEnd; ++i) {
+        float *rowI = &dist[i * n];
+        float viaK = rowI[k];
+        if (viaK == INF_FLOAT) {
+          continue;
+        }
+        for (size_t j = jb * B; j < jEnd; ++j) {
+          float candidate = viaK + rowK[j];
+          if (candidate < rowI[j]) {
+            rowI[j] = candidate;
+          }
+        }
+      }
+    }
+  };
+
+  for (size_t kb = 0; kb < blocks; ++kb) {
+    relaxBlock(kb, kb, kb);
+    parallelFor(blocks, [&](size_t begin, size_t end, unsigned) {
+      for (size_t other = begin; other < end; ++other) {
+        if (other != kb) {
+          relaxBlock(kb, other, kb);
+          relaxBlock(other, kb, kb);
+        }
+      }
+    });
+    parallelFor(blocks * blocks, [&](size_t begin, size_t end, unsigned) {
+      for (size_t index = begin; index < end; ++index) {
+        size_t ib = index / blocks;
+        size_t jb = index % blocks;
+        if (ib != kb && jb != kb) {
+          relaxBlock(ib, jb, kb);
+        }
+      }
+    });
+  }
+}
+
+// 逐源Dijkstra，各工作线程复用自己的距离数组与堆
+void repeatedDijkstra(std::vector<float> &dist, const SubNetwork &sub,
+                      size_t n) {
+  typedef std::pair<double, int> HeapItem;
+  parallelFor(n, [&](size_t begin, size_t end, unsigned) {
+    std::vector<double> local(n);
+    std::vector<HeapItem> heap;
+    std::greater<HeapItem> later;
+    for (size_t source = begin; source < end; ++source) {
+      std::fill(local.begin(), local.end(),
+                std::numeric_limits<double>::infinity());
+      local[source] = 0.0;
+      heap.assign(1, HeapItem(0.0, static_cast<int>(source)));
+      while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), later);
+        HeapItem top = heap.back();
+        heap.pop_back();
+        if (top.first > local[top.second]) {
+          continue;
+        }
+        for (int e = sub.offsets[top.second]; e < sub.offsets[top.second + 1];
+             ++e) {
+          double candidate = top.first + sub.weights[e];
+          if (candidate < local[sub.targets[e]]) {
+            local[sub.targets[e]] = candidate;
+            heap.emplace_back(candidate, sub.targets[e]);
+            std::push_heap(heap.begin(), heap.end(), later);
+          }
+        }
+      }
+      float *row = &dist[source * n];
+      for (size_t j = 0; j < n; ++j) {
+        row[j] = static_cast<float>(local[j]);
+      }
+    }
+  });
+}
+
+} // namespace
+
+// 构造函数
+DistanceMatrix::DistanceMatrix()
+    : matrix(nullptr), metric(PathMetric::Distance), usedMethod(Method::Auto) {
+}
+
+void DistanceMatrix::assignStations(const std::vector<EntityHandle> &region,
+                                    int catalogStationCount) {
+  stations.clear();
+  rowOfStation.assign(catalogStationCount, -1);
+  for (EntityHandle station : region) {
+    if (station >= 0 && station < catalogStationCount &&
+        rowOfStation[station] < 0) {
+      rowOfStation[station] = static_cast<int>(stations.size());
+      stations.push_back(station);
+    }
+  }
+}
+
+void DistanceMatrix::compute(const RailNetwork &network,
+                             const std::vector<EntityHandle> &region,
+                             PathMetric pathMetric, Method method) {
+  mappedFile.close();
+  metric = pathMetric;
+  if (region.empty()) {
+    std::vector<EntityHandle> all(network.getNodeCount());
+    for (int i = 0; i < network.getNodeCount(); ++i) {
+      all[i] = i;
+    }
+    assignStations(all, network.getNodeCount());
+  } else {
+    assignStations(region, network.getNodeCount());
+  }
+
+  size_t n = stations.size();
+  SubNetwork sub = extractSubNetwork(network, stations, rowOfStation, metric);
+
+  if (method == Method::Auto) {
+    double density = (n > 0) ? static_cast<double>(sub.targets.size()) /
+                                   (static_cast<double>(n) * n)
+                             : 0.0;
+    method = (n <= BLOCK_SIZE || density >= DENSE_THRESHOLD)
+                 ? Method::FloydWarshall
+                 : Method::RepeatedDijkstra;
+  }
+  usedMethod = method;
+
+  values.assign(n * n, INF_FLOAT);
+  if (method == Method::FloydWarshall) {
+    for (size_t i = 0; i < n; ++i) {
+      values[i * n + i] = 0.0f;
+      for (int e = sub.offsets[i]; e < sub.offsets[i + 1]; ++e) {
+        float &cell = values[i * n + sub.targets[e]];
+        cell = std::min(cell, static_cast<float>(sub.weights[e]));
+      }
+    }
+    floydWarshallBlocked(values, n);
+  } else {
+    repeatedDijkstra(values, sub, n);
+  }
+  matrix = values.data();
+}
+
+float DistanceMatrix::get(EntityHandle from, EntityHandle to) const {
+  int row = rowOf(from);
+  int column = rowOf(to);
+  if (row < 0 || column < 0) {
+    return INF_FLOAT;
+  }
+  return matrix[static_cast<size_t>(row) * stations.size() + column];
+}
+
+// 文件格式：magic、版本、度量、站点数、矩阵偏移，随后为站点ID表，
+// 矩阵从64字节对齐的偏移处开始
+bool DistanceMatrix::saveToFile(const std::string &path,
+                                const EntityCatalog &catalog) const {
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (!out.is_open()) {
+    lastError = "无法写入矩阵文件: " + path;
+    return false;
+  }
+
+  std::string idTable;
+  for (EntityHandle station : stations) {
+    std::string id = (station != INVALID_HANDLE)
+                         ? catalog.getStation(station)->getStationId()
+                         : std::string();
+    uint32_t length = static_cast<uint32_t>(id.size());
+    idTable.append(reinterpret_cast<const char *>(&length), sizeof(length));
+    idTable.append(id);
+  }
+
+  int32_t metricValue = static_cast<int32_t>(metric);
+  uint32_t count = static_cast<uint32_t>(stations.size());
+  size_t headerSize = sizeof(FILE_MAGIC) + sizeof(FILE_VERSION) +
+                      sizeof(metricValue) + sizeof(count) + sizeof(uint64_t);
+  uint64_t matrixOffset = headerSize + idTable.size();
+  matrixOffset = (matrixOffset + MATRIX_ALIGNMENT - 1) / MATRIX_ALIGNMENT *
+                 MATRIX_ALIGNMENT;
+
+  out.write(FILE_MAGIC, sizeof(FILE_MAGIC));
+  out.write(reinterpret_cast<const char *>(&FILE_VERSION),
+            sizeof(FILE_VERSION));
+  out.write(reinterpret_cast<const char *>(&metricValue), sizeof(metricValue));
+  out.write(reinterpret_cast<const char *>(&count), sizeof(count));
+  out.write(reinterpret_cast<const char *>(&matrixOffset),
+            sizeof(matrixOffset));
+  out.write(idTable.data(), static_cast<std::streamsize>(idTable.size()));
+  std::string padding(matrixOffset - headerSize - idTable.size(), '\0');
+  out.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+  out.write(reinterpret_cast<const char *>(matrix),
+            static_cast<std::streamsize>(stations.size() * stations.size() *
+                                         sizeof(float)));
+  if (!out) {
+    lastError = "写入矩阵文件失败: " + path;
+    return false;
+  }
+  return true;
+}
+
+bool DistanceMatrix::loadFromFile(const std::string &path,
+                                  const EntityCatalog &catalog) {
+  values.clear();
+  stations.clear();
+  rowOfStation.clear();
+  matrix = nullptr;
+  // 查询按站点对随机读取矩阵元素
+  if (!mappedFile.open(path, MappedFile::Access::Random)) {
+    lastError = mappedFile.getLastError();
+    return false;
+  }
+
+  const char *data = mappedFile.data();
+  size_t fileSize = mappedFile.size();
+  size_t headerSize = sizeof(FILE_MAGIC) + sizeof(uint32_t) +
+                      sizeof(int32_t) + sizeof(uint32_t) + sizeof(uint64_t);
+  uint32_t version = 0;
+  int32_t metricValue = 0;
+  uint32_t count = 0;
+  uint64_t matrixOffset = 0;
+  if (fileSize < headerSize ||
+      std::memcmp(data, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0) {
+    lastError = "矩阵文件格式不正确: " + path;
+    mappedFile.close();
+    return false;
+  }
+  const char *cursor = data + sizeof(FILE_MAGIC);
+  std::memcpy(&version, cursor, sizeof(version));
+  cursor += sizeof(version);
+  std::memcpy(&metricValue, cursor, sizeof(metricValue));
+  cursor += sizeof(metricValue);
+  std::memcpy(&count, cursor, sizeof(count));
+  cursor += sizeof(count);
+  std::memcpy(&matrixOffset, cursor, sizeof(matrixOffset));
+  cursor += sizeof(matrixOffset);
+
+  uint64_t matrixBytes = static_cast<uint64_t>(count) * count * sizeof(float);
+  if (version != FILE_VERSION || matrixOffset % MATRIX_ALIGNMENT != 0 ||
+      matrixOffset > fileSize || fileSize - matrixOffset < matrixBytes) {
+    lastError = "矩阵文件内容不完整: " + path;
+    mappedFile.close();
+    return false;
+  }
+
+  // 站点ID表；当前目录中不存在的站点保留行但无法按句柄查询
+  const char *tableEnd = data + matrixOffset;
+  std::vector<EntityHandle> handles;
+  handles.reserve(count);
+  for (uint32_t i = 0; i < count; ++i) {
+    uint32_t length = 0;
+    if (tableEnd - cursor < static_cast<std::ptrdiff_t>(sizeof(length))) {
+      break;
+    }
+    std::memcpy(&length, cursor, sizeof(length));
+    cursor += sizeof(length);
+    if (tableEnd - cursor < static_cast<std::ptrdiff_t>(length)) {
+      break;
+    }
+    handles.push_back(catalog.getStationHandle(std::string(cursor, length)));
+    cursor += length;
+  }
+  if (handles.size() != count) {
+    lastError = "矩阵文件站点表损坏: " + path;
+    mappedFile.close();
+    return false;
+  }
+
+  stations = handles;
+  rowOfStation.assign(catalog.getStationCount(), -1);
+  for (size_t row = 0; row < stations.size(); ++row) {
+    if (stations[row] != INVALID_HANDLE) {
+      rowOfStation[stations[row]] = static_cast<int>(row);
+    }
+  }
+  metric = static_cast<PathMetric>(metricValue);
+  matrix = reinterpret_cast<const float *>(data + matrixOffset);
+  return true;
+}
+
+std::vector<EntityHandle>
+DistanceMatrix::stationsInCities(const EntityCatalog &catalog,
+                                 const std::vector<std::string> &cities) {
+  std::vector<EntityHandle> region;
+  for (const auto &city : cities) {
+    const auto &inCity = catalog.getStationsInCity(city);
+    region.insert(region.end(), inCity.begin(), inCity.end());
+  }
+  std::sort(region.begin(), region.end());
+  region.erase(std::unique(region.begin(), region.end()), region.end());
+  return region;
+}
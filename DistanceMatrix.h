@@ -0,0 +1,76 @@
+#ifndef DISTANCEMATRIX_H
+#define DISTANCEMATRIX_H
+
+#include "MappedFile.h"
+#include "RailNetwork.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+// 区域（线路走廊或城市群）内站点两两之间的最短里程/时间矩阵。
+// 只考虑区域内部的区间；稠密子网用分块Floyd–Warshall，稀疏子网
+// 用多线程逐源Dijkstra。矩阵以float行主序存储，可保存后直接内存映射
+class DistanceMatrix {
+public:
+  enum class Method { Auto, FloydWarshall, RepeatedDijkstra };
+
+private:
+  std::vector<EntityHandle> stations; // 矩阵行/列对应的站点句柄
+  std::vector<int> rowOfStation;      // 站点句柄 -> 行号（-1表示不在区域内）
+  std::vector<float> values;          // 计算结果（从文件映射时为空）
+  MappedFile mappedFile;
+  const float *matrix;
+  PathMetric metric;
+  Method usedMethod;
+  mutable std::string lastError;
+
+public:
+  static const size_t BLOCK_SIZE = 64; // Floyd–Warshall分块边长
+  static constexpr double DENSE_THRESHOLD = 0.05; // 弧数/节点数²≥此值为稠密
+
+  // 构造函数
+  DistanceMatrix();
+
+  DistanceMatrix(const DistanceMatrix &) = delete;
+  DistanceMatrix &operator=(const DistanceMatrix &) = delete;
+
+  // 计算区域内全部站点对；region为空时使用整个网络
+  void compute(const RailNetwork &network,
+               const std::vector<EntityHandle> &region, PathMetric pathMetric,
+               Method method = Method::Auto);
+
+  // 保存为可映射文件；加载时按站点ID对应到catalog中的句柄
+  bool saveToFile(const std::string &path,
+                  const EntityCatalog &catalog) const;
+  bool loadFromFile(const std::string &path, const EntityCatalog &catalog);
+
+  size_t size() const { return stations.size(); }
+  bool isEmpty() const { return stations.empty(); }
+  PathMetric getMetric() const { return metric; }
+  Method getUsedMethod() const { return usedMethod; }
+  // 从文件加载时，当前目录中不存在的站点对应INVALID_HANDLE
+  const std::vector<EntityHandle> &getStations() const { return stations; }
+  std::string getLastError() const { return lastError; }
+
+  // 行号查询（站点不在区域内返回-1）
+  int rowOf(EntityHandle station) const {
+    return (station >= 0 && station < static_cast<int>(rowOfStation.size()))
+               ? rowOfStation[station]
+               : -1;
+  }
+  // 两站之间的代价；不在区域内或不可达返回无穷大
+  float get(EntityHandle from, EntityHandle to) const;
+  // 按行访问（row须有效）
+  const float *getRow(int row) const { return matrix + row * stations.size(); }
+
+  // 选出位于指定城市的站点（例如川渝：{"成都", "重庆", ...}）
+  static std::vector<EntityHandle>
+  stationsInCities(const EntityCatalog &catalog,
+                   const std::vector<std::string> &cities);
+
+private:
+  void assignStations(const std::vector<EntityHandle> &region,
+                      int catalogStationCount);
+};
+
+#endif // DISTANCEMATRIX_H
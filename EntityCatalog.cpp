@@ -0,0 +1,224 @@
+#include "EntityCatalog.h"
+#include <algorithm>
+
+namespace {
+
+const std::vector<EntityHandle> &emptyHandles() {
+  static const std::vector<EntityHandle> handles;
+  return handles;
+}
+
+EntityHandle lookup(const std::unordered_map<std::string, EntityHandle> &index,
+                    const std::string &key) {
+  auto it = index.find(key);
+  return (it != index.end()) ? it->second : INVALID_HANDLE;
+}
+
+} // namespace
+
+// 默认构造函数
+EntityCatalog::EntityCatalog() {}
+
+// 构建所有索引
+EntityCatalog::EntityCatalog(
+    const std::vector<std::shared_ptr<Station>> &stationList,
+    const std::vector<std::shared_ptr<Route>> &routeList,
+    const std::vector<std::shared_ptr<Train>> &trainList) {
+  stations.reserve(stationList.size());
+  stationById.reserve(stationList.size());
+  stationByName.reserve(stationList.size());
+  for (const auto &station : stationList) {
+    if (!station) {
+      continue;
+    }
+    EntityHandle handle = static_cast<EntityHandle>(stations.size());
+    if (!stationById.emplace(station->getStationId(), handle).second) {
+      continue;
+    }
+    stations.push_back(station);
+    stationByName.emplace(station->getStationName(), handle);
+    stationsByCity[station->getCityName()].push_back(handle);
+  }
+  routesByStation.resize(stations.size());
+  trainsByStation.resize(stations.size());
+
+  routes.reserve(routeList.size());
+  routeById.reserve(routeList.size());
+  for (const auto &route : routeList) {
+    if (!route) {
+      continue;
+    }
+    EntityHandle handle = static_cast<EntityHandle>(routes.size());
+    if (!routeById.emplace(route->getRouteId(), handle).second) {
+      continue;
+    }
+    routes.push_back(route);
+    routeByName.emplace(route->getRouteName(), handle);
+
+    // 同一线路的句柄连续追加，比较末尾即可去掉环线等重复经停
+    for (const auto &station : route->getStations()) {
+      EntityHandle stationHandle =
+          station ? getStationHandle(station->getStationId()) : INVALID_HANDLE;
+      if (stationHandle != INVALID_HANDLE &&
+          (routesByStation[stationHandle].empty() ||
+           routesByStation[stationHandle].back() != handle)) {
+        routesByStation[stationHandle].push_back(handle);
+      }
+    }
+  }
+  for (EntityHandle station = 0; station < getStationCount(); ++station) {
+    if (isTransferStation(station)) {
+      transferStations.push_back(station);
+    }
+  }
+
+  trains.reserve(trainList.size());
+  trainById.reserve(trainList.size());
+  for (const auto &train : trainList) {
+    if (!train) {
+      continue;
+    }
+    EntityHandle handle = static_cast<EntityHandle>(trains.size());
+    if (!trainById.emplace(train->getTrainId(), handle).second) {
+      continue;
+    }
+    trains.push_back(train);
+    trainsByType[train->getTrainType()].push_back(handle);
+
+    auto addStop = [this, handle](const std::string &stationId) {
+      EntityHandle stationHandle = getStationHandle(stationId);
+      if (stationHandle != INVALID_HANDLE &&
+          (trainsByStation[stationHandle].empty() ||
+           trainsByStation[stationHandle].back() != handle)) {
+        trainsByStation[stationHandle].push_back(handle);
+      }
+    };
+    if (!train->getSchedule().empty()) {
+      for (const auto &entry : train->getSchedule()) {
+        addStop(entry.stationId);
+      }
+    } else if (train->getRoute()) {
+      for (const auto &station : train->getRoute()->getStations()) {
+        if (station) {
+          addStop(station->getStationId());
+        }
+      }
+    }
+  }
+}
+
+std::shared_ptr<const EntityCatalog>
+EntityCatalog::build(const std::vector<std::shared_ptr<Station>> &stationList,
+                     const std::vector<std::shared_ptr<Route>> &routeList,
+                     const std::vector<std::shared_ptr<Train>> &trainList) {
+  return std::make_shared<const EntityCatalog>(stationList, routeList,
+                                               trainList);
+}
+
+const std::shared_ptr<const EntityCatalog> &EntityCatalog::empty() {
+  static const std::shared_ptr<const EntityCatalog> catalog =
+      std::make_shared<const EntityCatalog>();
+  return catalog;
+}
+
+// 句柄查找
+EntityHandle
+EntityCatalog::getStationHandle(const std::string &stationId) const {
+  return lookup(stationById, stationId);
+}
+
+EntityHandle
+EntityCatalog::getStationHandleByName(const std::string &stationName) const {
+  return lookup(stationByName, stationName);
+}
+
+EntityHandle EntityCatalog::getRouteHandle(const std::string &routeId) const {
+  return lookup(routeById, routeId);
+}
+
+EntityHandle
+EntityCatalog::getRouteHandleByName(const std::string &routeName) const {
+  return lookup(routeByName, routeName);
+}
+
+EntityHandle EntityCatalog::getTrainHandle(const std::string &trainId) const {
+  return lookup(trainById, trainId);
+}
+
+// 按ID/名称查找
+std::shared_ptr<Station>
+EntityCatalog::findStation(const std::string &stationId) const {
+  EntityHandle handle = getStationHandle(stationId);
+  return (handle != INVALID_HANDLE) ? stations[handle] : nullptr;
+}
+
+std::shared_ptr<Station>
+EntityCatalog::findStationByName(const std::string &stationName) const {
+  EntityHandle handle = getStationHandleByName(stationName);
+  return (handle != INVALID_HANDLE) ? stations[handle] : nullptr;
+}
+
+std::shared_ptr<Route>
+EntityCatalog::findRoute(const std::string &routeId) const {
+  EntityHandle handle = getRouteHandle(routeId);
+  return (handle != INVALID_HANDLE) ? routes[handle] : nullptr;
+}
+
+std::shared_ptr<Route>
+EntityCatalog::findRouteByName(const std::string &routeName) const {
+  EntityHandle handle = getRouteHandleByName(routeName);
+  return (handle != INVALID_HANDLE) ? routes[handle] : nullptr;
+}
+
+std::shared_ptr<Train>
+EntityCatalog::findTrain(const std::string &trainId) const {
+  EntityHandle handle = getTrainHandle(trainId);
+  return (handle != INVALID_HANDLE) ? trains[handle] : nullptr;
+}
+
+// 二级索引
+const std::vector<EntityHandle> &
+EntityCatalog::getStationsInCity(const std::string &cityName) const {
+  auto it = stationsByCity.find(cityName);
+  return (it != stationsByCity.end()) ? it->second : emptyHandles();
+}
+
+const std::vector<EntityHandle> &
+EntityCatalog::getTrainsOfType(const std::string &trainType) const {
+  auto it = trainsByType.find(trainType);
+  return (it != trainsByType.end()) ? it->second : emptyHandles();
+}
+
+// 沿线路各站的倒排表累计共用站点数
+std::vector<std::pair<EntityHandle, int>>
+EntityCatalog::getRouteOverlaps(EntityHandle route) const {
+  std::vector<int> shared(routes.size(), 0);
+  std::vector<EntityHandle> touched;
+  std::vector<char> seen(stations.size(), 0);
+  for (const auto &station : routes[route]->getStations()) {
+    EntityHandle stationHandle =
+        station ? getStationHandle(station->getStationId()) : INVALID_HANDLE;
+    if (stationHandle == INVALID_HANDLE || seen[stationHandle]) {
+      continue;
+    }
+    seen[stationHandle] = 1;
+    for (EntityHandle other : routesByStation[stationHandle]) {
+      if (other != route && shared[other]++ == 0) {
+        touched.push_back(other);
+      }
+    }
+  }
+
+  std::vector<std::pair<EntityHandle, int>> overlaps;
+  overlaps.reserve(touched.size());
+  for (EntityHandle other : touched) {
+    overlaps.emplace_back(other, shared[other]);
+  }
+  std::sort(overlaps.begin(), overlaps.end(),
+            [](const std::pair<EntityHandle, int> &a,
+               const std::pair<EntityHandle, int> &b) {
+              return a.second != b.second ? a.second > b.second
+                                          : a.first < b.first;
+            });
+  return overlaps;
+}
@@ -0,0 +1,123 @@
+#ifndef ENTITYCATALOG_H
+#define ENTITYCATALOG_H
+
+#include "Route.h"
+#include "Station.h"
+#include "Train.h"
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// 实体句柄：目录内从0开始的连续下标
+using EntityHandle = int;
+const EntityHandle INVALID_HANDLE = -1;
+
+// 站点、线路、列车的只读目录。构建后不再修改，可由多个分析器共享：
+// 按ID/名称哈希查找，按城市、列车类型建立二级索引，并建立站点到
+// 经停线路、列车的倒排索引（换乘站由经停线路数判定）
+class EntityCatalog {
+private:
+  std::vector<std::shared_ptr<Station>> stations;
+  std::vector<std::shared_ptr<Route>> routes;
+  std::vector<std::shared_ptr<Train>> trains;
+
+  std::unordered_map<std::string, EntityHandle> stationById;
+  std::unordered_map<std::string, EntityHandle> stationByName;
+  std::unordered_map<std::string, EntityHandle> routeById;
+  std::unordered_map<std::string, EntityHandle> routeByName;
+  std::unordered_map<std::string, EntityHandle> trainById;
+
+  std::unordered_map<std::string, std::vector<EntityHandle>> stationsByCity;
+  std::vector<EntityHandle> transferStations;
+  std::unordered_map<std::string, std::vector<EntityHandle>> trainsByType;
+
+  // 倒排索引（按站点句柄，句柄升序）
+  std::vector<std::vector<EntityHandle>> routesByStation;
+  std::vector<std::vector<EntityHandle>> trainsByStation;
+
+public:
+  // 构造函数（空指针会被忽略；ID重复时以首次出现为准）
+  EntityCatalog();
+  EntityCatalog(const std::vector<std::shared_ptr<Station>> &stationList,
+                const std::vector<std::shared_ptr<Route>> &routeList,
+                const std::vector<std::shared_ptr<Train>> &trainList);
+
+  // 构建共享目录
+  static std::shared_ptr<const EntityCatalog>
+  build(const std::vector<std::shared_ptr<Station>> &stationList,
+        const std::vector<std::shared_ptr<Route>> &routeList,
+        const std::vector<std::shared_ptr<Train>> &trainList);
+  // 空目录（分析器未设置目录时使用）
+  static const std::shared_ptr<const EntityCatalog> &empty();
+
+  // 全量访问
+  const std::vector<std::shared_ptr<Station>> &getStations() const {
+    return stations;
+  }
+  const std::vector<std::shared_ptr<Route>> &getRoutes() const {
+    return routes;
+  }
+  const std::vector<std::shared_ptr<Train>> &getTrains() const {
+    return trains;
+  }
+  int getStationCount() const { return static_cast<int>(stations.size()); }
+  int getRouteCount() const { return static_cast<int>(routes.size()); }
+  int getTrainCount() const { return static_cast<int>(trains.size()); }
+
+  // 句柄查找（不存在返回INVALID_HANDLE）
+  EntityHandle getStationHandle(const std::string &stationId) const;
+  EntityHandle getStationHandleByName(const std::string &stationName) const;
+  EntityHandle getRouteHandle(const std::string &routeId) const;
+  EntityHandle getRouteHandleByName(const std::string &routeName) const;
+  EntityHandle getTrainHandle(const std::string &trainId) const;
+
+  // 句柄访问（调用方保证句柄有效）
+  const std::shared_ptr<Station> &getStation(EntityHandle handle) const {
+    return stations[handle];
+  }
+  const std::shared_ptr<Route> &getRoute(EntityHandle handle) const {
+    return routes[handle];
+  }
+  const std::shared_ptr<Train> &getTrain(EntityHandle handle) const {
+    return trains[handle];
+  }
+
+  // 按ID/名称查找（不存在返回nullptr）
+  std::shared_ptr<Station> findStation(const std::string &stationId) const;
+  std::shared_ptr<Station>
+  findStationByName(const std::string &stationName) const;
+  std::shared_ptr<Route> findRoute(const std::string &routeId) const;
+  std::shared_ptr<Route> findRouteByName(const std::string &routeName) const;
+  std::shared_ptr<Train> findTrain(const std::string &trainId) const;
+
+  // 二级索引
+  const std::vector<EntityHandle> &
+  getStationsInCity(const std::string &cityName) const;
+  const std::vector<EntityHandle> &getTransferStations() const {
+    return transferStations;
+  }
+  const std::vector<EntityHandle> &
+  getTrainsOfType(const std::string &trainType) const;
+
+  // 倒排索引：经停某站的线路与列车（列车无时刻表时按其线路全部站点）
+  const std::vector<EntityHandle> &
+  getRoutesAtStation(EntityHandle station) const {
+    return routesByStation[station];
+  }
+  const std::vector<EntityHandle> &
+  getTrainsAtStation(EntityHandle station) const {
+    return trainsByStation[station];
+  }
+  // 换乘站：至少两条线路经停，或站点数据明确标记为换乘站
+  bool isTransferStation(EntityHandle station) const {
+    return routesByStation[station].size() >= 2 ||
+           stations[station]->getIsTransferStation();
+  }
+  // 与指定线路共用站点的其他线路及共用站点数，按共用站点数降序
+  std::vector<std::pair<EntityHandle, int>>
+  getRouteOverlaps(EntityHandle route) const;
+};
+
+#endif // ENTITYCATALOG_H
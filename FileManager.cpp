@@ -1,7 +1,15 @@
 #include "FileManager.h"
+#include "BackupStore.h"
+#include "CsvWriter.h"
 #include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <filesystem>
 #include <fstream>
+#include <future>
+#include <iomanip>
 #include <iostream>
+#include <map>
 #include <sstream>
 
 // 构造函数
@@ -60,74 +68,27 @@ void FileManager::setConfigFile(const std::string &filename) {
 // 站点数据操作
 bool FileManager::saveStations(
     const std::vector<std::shared_ptr<Station>> &stations) {
-  std::string fullPath = getFullPath(stationsFile);
-  std::ofstream file(fullPath);
-
-  if (!file.is_open()) {
-    lastError = "无法打开文件: " + fullPath;
-    return false;
-  }
-
-  // 写入CSV头部
-  file << "StationID,StationName,CityName,Longitude,Latitude,StationType,"
-          "PlatformCount,IsTransferStation\n";
-
-  // 写入数据
-  for (const auto &station : stations) {
-    if (station) {
-      file << formatStationToCSV(*station) << "\n";
-    }
-  }
-
-  file.close();
-  return true;
+  return writeStationsCSV(stations, getFullPath(stationsFile));
 }
 
 std::vector<std::shared_ptr<Station>> FileManager::loadStations() {
-  std::vector<std::shared_ptr<Station>> stations;
   std::string fullPath = getFullPath(stationsFile);
-  std::ifstream file(fullPath);
+  std::string content;
 
-  if (!file.is_open()) {
+  if (!readFileContent(fullPath, content)) {
     lastError = "无法打开文件: " + fullPath;
-    return stations;
+    return {};
   }
 
-  std::string line;
-  bool firstLine = true;
-
-  while (std::getline(file, line)) {
-    if (firstLine) {
-      firstLine = false;
-      continue; // 跳过CSV头部
-    }
-
-    auto fields = splitCSVLine(line);
-    if (fields.size() >= 8) {
-      auto station = parseStationFromCSV(fields);
-      if (station) {
-        stations.push_back(station);
-      }
-    }
-  }
-
-  file.close();
-  return stations;
+  return parseStationRows(splitCSVContent(content));
 }
 
 bool FileManager::saveStation(const Station &station) {
   // 简化实现：追加到文件末尾
   std::string fullPath = getFullPath(stationsFile);
-  std::ofstream file(fullPath, std::ios::app);
-
-  if (!file.is_open()) {
-    lastError = "无法打开文件: " + fullPath;
-    return false;
-  }
-
-  file << formatStationToCSV(station) << "\n";
-  file.close();
-  return true;
+  std::string line;
+  formatStationToCSV(station, line);
+  return appendCSVLine(fullPath, line);
 }
 
 // 文件工具方法
@@ -137,7 +98,12 @@ bool FileManager::fileExists(const std::string &filename) const {
 }
 
 bool FileManager::createDirectory(const std::string &dirPath) const {
-  // 简化实现，实际应该使用filesystem库
+  std::error_code ec;
+  std::filesystem::create_directories(dirPath, ec);
+  if (ec) {
+    lastError = "无法创建目录: " + dirPath;
+    return false;
+  }
   return true;
 }
 
@@ -152,7 +118,23 @@ long FileManager::getFileSize(const std::string &filename) const {
 
 std::string
 FileManager::getLastModifiedTime(const std::string &filename) const {
-  return "未实现";
+  std::error_code ec;
+  auto fileTime = std::filesystem::last_write_time(filename, ec);
+  if (ec) {
+    lastError = "无法获取文件修改时间: " + filename;
+    return "";
+  }
+
+  // C++17 中 file_clock 与 system_clock 无直接转换，按当前时刻差值换算
+  auto systemTime = std::chrono::time_point_cast<std::chrono::seconds>(
+      fileTime - std::filesystem::file_time_type::clock::now() +
+      std::chrono::system_clock::now());
+  std::time_t tt = std::chrono::system_clock::to_time_t(systemTime);
+  std::tm tmValue = *std::localtime(&tt);
+
+  std::ostringstream oss;
+  oss << std::put_time(&tmValue, "%Y-%m-%d %H:%M:%S");
+  return oss.str();
 }
 
 // 辅助方法
@@ -163,22 +145,285 @@ std::string FileManager::getFullPath(const std::string &filename) const {
   return dataDirectory + "/" + filename;
 }
 
+// 支持引号字段（RFC 4180）；空行返回空列表，行尾逗号后的空字段忽略
 std::vector<std::string>
 FileManager::splitCSVLine(const std::string &line) const {
   std::vector<std::string> fields;
-  std::stringstream ss(line);
-  std::string field;
+  if (line.find('"') == std::string::npos) {
+    size_t start = 0;
+    while (start < line.size()) {
+      size_t comma = line.find(',', start);
+      if (comma == std::string::npos) {
+        fields.emplace_back(line, start);
+        break;
+      }
+      fields.emplace_back(line, start, comma - start);
+      start = comma + 1;
+    }
+    return fields;
+  }
 
-  while (std::getline(ss, field, ',')) {
+  std::string field;
+  bool inQuotes = false;
+  bool pending = false; // 当前字段是否有内容待提交
+  for (size_t i = 0; i < line.size(); ++i) {
+    char c = line[i];
+    if (inQuotes) {
+      if (c == '"') {
+        if (i + 1 < line.size() && line[i + 1] == '"') {
+          field.push_back('"');
+          ++i;
+        } else {
+          inQuotes = false;
+        }
+      } else {
+        field.push_back(c);
+      }
+    } else if (c == '"') {
+      inQuotes = true;
+      pending = true;
+    } else if (c == ',') {
+      fields.push_back(field);
+      field.clear();
+      pending = false;
+    } else {
+      field.push_back(c);
+      pending = true;
+    }
+  }
+  if (pending || !field.empty()) {
     fields.push_back(field);
   }
-
   return fields;
 }
 
+// 一次性读取整个文件，减少逐行读取的系统调用开销
+bool FileManager::readFileContent(const std::string &fullPath,
+                                  std::string &content) const {
+  std::ifstream file(fullPath, std::ios::binary | std::ios::ate);
+  if (!file.is_open()) {
+    return false;
+  }
+
+  std::streamoff size = file.tellg();
+  content.clear();
+  if (size > 0) {
+    content.resize(static_cast<size_t>(size));
+    file.seekg(0);
+    file.read(&content[0], size);
+    content.resize(static_cast<size_t>(file.gcount()));
+  }
+  return true;
+}
+
+size_t FileManager::trimToCompleteLines(std::string &content) {
+  size_t lastNewline = content.rfind('\n');
+  content.resize(lastNewline == std::string::npos ? 0 : lastNewline + 1);
+  return content.size();
+}
+
+// 将文件内容拆分为字段行（跳过CSV头部和空行）
+std::vector<std::vector<std::string>>
+FileManager::splitCSVContent(const std::string &content,
+                             bool skipHeader) const {
+  std::vector<std::vector<std::string>> rows;
+  size_t pos = 0;
+  if (skipHeader) {
+    pos = content.find('\n');
+    if (pos == std::string::npos) {
+      return rows; // 只有头部或空文件
+    }
+    ++pos;
+  }
+
+  while (pos < content.size()) {
+    size_t end = content.find('\n', pos);
+    if (end == std::string::npos) {
+      end = content.size();
+    }
+
+    size_t lineEnd = end;
+    if (lineEnd > pos && content[lineEnd - 1] == '\r') {
+      --lineEnd;
+    }
+
+    std::string line = content.substr(pos, lineEnd - pos);
+    if (line.find_first_not_of(" \t") != std::string::npos) {
+      rows.push_back(splitCSVLine(line));
+    }
+    pos = end + 1;
+  }
+
+  return rows;
+}
+
+std::vector<std::shared_ptr<Station>> FileManager::parseStationRows(
+    const std::vector<std::vector<std::string>> &rows) const {
+  std::vector<std::shared_ptr<Station>> stations;
+  stations.reserve(rows.size());
+
+  for (const auto &fields : rows) {
+    if (fields.size() >= 8) {
+      auto station = parseStationFromCSV(fields);
+      if (station) {
+        stations.push_back(station);
+      }
+    }
+  }
+  return stations;
+}
+
+std::vector<std::shared_ptr<Route>> FileManager::parseRouteRows(
+    const std::vector<std::vector<std::string>> &rows,
+    const std::vector<std::shared_ptr<Station>> &stations) const {
+  // 站点ID索引，避免逐个站点线性查找
+  std::unordered_map<std::string, std::shared_ptr<Station>> stationIndex;
+  stationIndex.reserve(stations.size());
+  for (const auto &station : stations) {
+    if (station) {
+      stationIndex.emplace(station->getStationId(), station);
+    }
+  }
+
+  // 运营线路格式：每行一个线路站点
+  if (!rows.empty() && rows.front().size() >= 14) {
+    return parseOperationalRouteRows(rows, stations);
+  }
+
+  std::vector<std::shared_ptr<Route>> routes;
+  routes.reserve(rows.size());
+  for (const auto &fields : rows) {
+    auto route = parseRouteFromCSV(fields, stationIndex);
+    if (route)
+      routes.push_back(route);
+  }
+  return routes;
+}
+
+// 运营线路格式：yyxlbm（线路编码）,zdid（站点编号）,,xlzdid（线路站序）,
+// Q_zdid（上一站）,yqzdjjl（站间距离）,H_zdid（下一站）,...,ysjl,xldm,sfytk
+std::vector<std::shared_ptr<Route>> FileManager::parseOperationalRouteRows(
+    const std::vector<std::vector<std::string>> &rows,
+    const std::vector<std::shared_ptr<Station>> &stations) const {
+  std::unordered_map<std::string, std::shared_ptr<Station>> codeIndex;
+  codeIndex.reserve(stations.size());
+  for (const auto &station : stations) {
+    if (station && !station->getStationCode().empty()) {
+      codeIndex.emplace(station->getStationCode(), station);
+    }
+  }
+
+  struct RouteStop {
+    long long order;
+    std::string stationCode;
+    double segmentDistance; // 负数表示缺失
+  };
+  std::map<long long, std::vector<RouteStop>> routeStops;
+
+  for (const auto &fields : rows) {
+    if (fields.size() < 6) {
+      continue;
+    }
+    try {
+      // 第二行中文表头等非数字行直接跳过
+      long long routeCode = std::stoll(fields[0]);
+      long long order = std::stoll(fields[3]);
+      double segment = -1.0;
+      if (!fields[5].empty() && fields[5] != "NULL") {
+        segment = std::stod(fields[5]);
+      }
+      routeStops[routeCode].push_back({order, fields[1], segment});
+    } catch (const std::exception &) {
+      continue;
+    }
+  }
+
+  std::vector<std::shared_ptr<Route>> routes;
+  routes.reserve(routeStops.size());
+  for (auto &entry : routeStops) {
+    auto &stops = entry.second;
+    std::stable_sort(stops.begin(), stops.end(),
+                     [](const RouteStop &a, const RouteStop &b) {
+                       return a.order < b.order;
+                     });
+
+    auto route = std::make_shared<Route>(std::to_string(entry.first), "",
+                                         "普通", 0.0);
+    // 找不到的站点跳过，其站间距离并入下一段，保持沿线里程不变
+    double pendingDistance = 0.0;
+    bool pendingMissing = false;
+    for (const auto &stop : stops) {
+      auto it = codeIndex.find(stop.stationCode);
+      if (route->getStationCount() > 0) {
+        if (stop.segmentDistance < 0.0) {
+          pendingMissing = true;
+        } else {
+          pendingDistance += stop.segmentDistance;
+        }
+      }
+      if (it == codeIndex.end()) {
+        continue;
+      }
+      route->addStation(it->second, pendingMissing ? -1.0 : pendingDistance);
+      pendingDistance = 0.0;
+      pendingMissing = false;
+    }
+
+    if (route->getStationCount() == 0) {
+      continue;
+    }
+    const auto &routeStations = route->getStations();
+    route->setRouteName(routeStations.front()->getStationName() + "-" +
+                        routeStations.back()->getStationName());
+    routes.push_back(route);
+  }
+  return routes;
+}
+
+std::vector<std::shared_ptr<Train>> FileManager::parseTrainRows(
+    const std::vector<std::vector<std::string>> &rows) const {
+  std::vector<std::shared_ptr<Train>> trains;
+  trains.reserve(rows.size());
+  for (const auto &fields : rows) {
+    auto train = parseTrainFromCSV(fields);
+    if (train)
+      trains.push_back(train);
+  }
+  return trains;
+}
+
+int FileManager::parseFlowRecordRows(
+    const std::vector<std::vector<std::string>> &rows,
+    std::vector<FlowRecord> &records, int maxRecords) const {
+  int validRecords = 0;
+
+  for (const auto &fields : rows) {
+    try {
+      if (fields.size() >= 9) { // 确保有足够的字段
+        auto record = parseFlowRecordFromCSV(fields);
+        if (!record.getRecordId().empty()) { // 确保记录有效
+          records.push_back(std::move(record));
+          validRecords++;
+        }
+      }
+    } catch (const std::exception &) {
+      // 跳过无法解析的行
+      continue;
+    }
+
+    // 限制加载数量避免内存问题
+    if (maxRecords != NO_RECORD_LIMIT && validRecords >= maxRecords) {
+      break;
+    }
+  }
+
+  return validRecords;
+}
+
 std::string FileManager::escapeCSVValue(const std::string &value) const {
-  // 简化实现
-  return value;
+  std::string escaped;
+  CsvWriter::appendEscaped(escaped, value);
+  return escaped;
 }
 
 bool FileManager::parseDateFromString(const std::string &dateStr,
@@ -223,8 +468,40 @@ bool FileManager::parseDateFromString(const std::string &dateStr,
 }
 
 std::string FileManager::dateToString(const Date &date) const {
-  return std::to_string(date.year) + "-" + std::to_string(date.month) + "-" +
-         std::to_string(date.day);
+  std::string text;
+  appendDate(text, date);
+  return text;
+}
+
+void FileManager::appendDate(std::string &out, const Date &date) {
+  CsvWriter::appendNumber(out, static_cast<long long>(date.year));
+  out.push_back('-');
+  CsvWriter::appendNumber(out, static_cast<long long>(date.month));
+  out.push_back('-');
+  CsvWriter::appendNumber(out, static_cast<long long>(date.day));
+}
+
+void FileManager::estimateStationPosition(const std::string &stationName,
+                                          double &longitude,
+                                          double &latitude) {
+  size_t hash = std::hash<std::string>{}(stationName);
+  if (stationName.find("成都") != std::string::npos) {
+    longitude = 104.0 + (hash % 20) * 0.01;
+    latitude = 30.5 + (hash % 20) * 0.01;
+  } else if (stationName.find("重庆") != std::string::npos) {
+    longitude = 106.4 + (hash % 20) * 0.01;
+    latitude = 29.5 + (hash % 20) * 0.01;
+  } else if (stationName.find("简阳") != std::string::npos) {
+    longitude = 104.5;
+    latitude = 30.4;
+  } else if (stationName.find("资阳") != std::string::npos) {
+    longitude = 104.8;
+    latitude = 30.2;
+  } else {
+    // 其他站点在成都-重庆之间分布
+    longitude = 104.0 + (hash % 250) * 0.01;
+    latitude = 29.5 + (hash % 150) * 0.01;
+  }
 }
 
 // 数据解析方法 - 适应实际CSV文件格式
@@ -252,21 +529,11 @@ FileManager::parseStationFromCSV(const std::vector<std::string> &fields) const {
     }
 
     // 设置默认值
-    double longitude = 106.5 + (rand() % 200 - 100) * 0.01; // 模拟经度
-    double latitude = 29.5 + (rand() % 200 - 100) * 0.01;   // 模拟纬度
+    double longitude, latitude; // 估算的占位坐标
+    estimateStationPosition(name, longitude, latitude);
     std::string type = "客运站";
-    int platformCount = 2 + rand() % 6; // 2-8个站台
-    bool isTransfer = false;
-
-    // 判断是否为重要站点（包含"东"、"西"、"南"、"北"等的大站）
-    if (name.find("东") != std::string::npos ||
-        name.find("西") != std::string::npos ||
-        name.find("南") != std::string::npos ||
-        name.find("北") != std::string::npos ||
-        name.find("中心") != std::string::npos) {
-      platformCount = 6 + rand() % 6; // 6-12个站台
-      isTransfer = true;
-    }
+    int platformCount = 0;   // 站点表不含站台数，记为未知
+    bool isTransfer = false; // 由线路经停情况确定，见markTransferStations
 
     // 确定城市名称
     std::string city = "其他";
@@ -283,29 +550,43 @@ FileManager::parseStationFromCSV(const std::vector<std::string> &fields) const {
     else if (name.find("石家庄") != std::string::npos)
       city = "石家庄";
 
-    return std::make_shared<Station>(id, name, city, longitude, latitude, type,
-                                     platformCount, isTransfer);
+    auto station = std::make_shared<Station>(id, name, city, longitude,
+                                             latitude, type, platformCount,
+                                             isTransfer);
+    std::string stationCode = fields[0]; // zdid（站点编号）
+    stationCode.erase(stationCode.find_last_not_of(" \t\r") + 1);
+    station->setStationCode(stationCode);
+    return station;
   } catch (const std::exception &e) {
     lastError = std::string("解析站点数据错误: ") + e.what();
     return nullptr;
   }
 }
 
-// 数据格式化方法
-std::string FileManager::formatStationToCSV(const Station &station) const {
-  std::ostringstream oss;
-  oss << station.getStationId() << "," << station.getStationName() << ","
-      << station.getCityName() << "," << station.getLongitude() << ","
-      << station.getLatitude() << "," << station.getStationType() << ","
-      << station.getPlatformCount() << ","
-      << (station.getIsTransferStation() ? "1" : "0");
-  return oss.str();
+// 数据格式化方法（追加到out，不含换行符）
+void FileManager::formatStationToCSV(const Station &station, std::string &out) {
+  CsvWriter::appendEscaped(out, station.getStationId());
+  out.push_back(',');
+  CsvWriter::appendEscaped(out, station.getStationName());
+  out.push_back(',');
+  CsvWriter::appendEscaped(out, station.getCityName());
+  out.push_back(',');
+  CsvWriter::appendNumber(out, station.getLongitude());
+  out.push_back(',');
+  CsvWriter::appendNumber(out, station.getLatitude());
+  out.push_back(',');
+  CsvWriter::appendEscaped(out, station.getStationType());
+  out.push_back(',');
+  CsvWriter::appendNumber(out,
+                          static_cast<long long>(station.getPlatformCount()));
+  out.append(station.getIsTransferStation() ? ",1" : ",0");
 }
 
 // 解析线路CSV字段
 std::shared_ptr<Route> FileManager::parseRouteFromCSV(
     const std::vector<std::string> &fields,
-    const std::vector<std::shared_ptr<Station>> &stations) const {
+    const std::unordered_map<std::string, std::shared_ptr<Station>>
+        &stationIndex) const {
   if (fields.size() < 6) {
     return nullptr;
   }
@@ -319,15 +600,36 @@ std::shared_ptr<Route> FileManager::parseRouteFromCSV(
 
     auto route = std::make_shared<Route>(id, name, type, distance, speed);
 
+    // 可选的第7列为站间距离，与站点列表一一对应
+    std::vector<double> segments;
+    if (fields.size() >= 7) {
+      std::stringstream segmentStream(fields[6]);
+      std::string segment;
+      while (std::getline(segmentStream, segment, ';')) {
+        segments.push_back(segment.empty() ? -1.0 : std::stod(segment));
+      }
+    }
+
     std::stringstream ss(fields[5]);
     std::string stId;
+    size_t position = 0;
+    double pendingDistance = 0.0;
+    bool pendingMissing = false;
     while (std::getline(ss, stId, ';')) {
-      auto it = std::find_if(stations.begin(), stations.end(),
-                             [&](const std::shared_ptr<Station> &st) {
-                               return st && st->getStationId() == stId;
-                             });
-      if (it != stations.end()) {
-        route->addStation(*it);
+      double segment = position < segments.size() ? segments[position] : -1.0;
+      ++position;
+      if (route->getStationCount() > 0) {
+        if (segment < 0.0) {
+          pendingMissing = true;
+        } else {
+          pendingDistance += segment;
+        }
+      }
+      auto it = stationIndex.find(stId);
+      if (it != stationIndex.end()) {
+        route->addStation(it->second, pendingMissing ? -1.0 : pendingDistance);
+        pendingDistance = 0.0;
+        pendingMissing = false;
       }
     }
 
@@ -338,27 +640,39 @@ std::shared_ptr<Route> FileManager::parseRouteFromCSV(
   }
 }
 
-std::string FileManager::formatRouteToCSV(const Route &route) const {
-  std::ostringstream oss;
-  oss << route.getRouteId() << ',' << route.getRouteName() << ','
-      << route.getRouteType() << ',' << route.getTotalDistance() << ','
-      << route.getMaxSpeed() << ',';
-
+void FileManager::formatRouteToCSV(const Route &route, std::string &out) {
+  CsvWriter::appendEscaped(out, route.getRouteId());
+  out.push_back(',');
+  CsvWriter::appendEscaped(out, route.getRouteName());
+  out.push_back(',');
+  CsvWriter::appendEscaped(out, route.getRouteType());
+  out.push_back(',');
+  CsvWriter::appendNumber(out, route.getTotalDistance());
+  out.push_back(',');
+  CsvWriter::appendNumber(out, static_cast<long long>(route.getMaxSpeed()));
+  out.push_back(',');
+
+  // 站点ID和站间距离以分号分隔，各自整体作为一个字段转义
+  std::string stationIds;
+  std::string segments;
   const auto &sts = route.getStations();
   for (size_t i = 0; i < sts.size(); ++i) {
-    if (sts[i]) {
-      if (i > 0)
-        oss << ';';
-      oss << sts[i]->getStationId();
+    if (i > 0) {
+      stationIds.push_back(';');
+      segments.push_back(';');
     }
+    stationIds.append(sts[i]->getStationId());
+    CsvWriter::appendNumber(segments,
+                            route.getSegmentDistance(static_cast<int>(i)));
   }
-  return oss.str();
+  CsvWriter::appendEscaped(out, stationIds);
+  out.push_back(',');
+  CsvWriter::appendEscaped(out, segments);
 }
 
 // 解析列车CSV字段 - 适应实际CSV文件格式
 std::shared_ptr<Train> FileManager::parseTrainFromCSV(
-    const std::vector<std::string> &fields,
-    const std::vector<std::shared_ptr<Route>> &routes) const {
+    const std::vector<std::string> &fields) const {
   // 实际CSV格式：lcbm（列车编码）,sxxbm,ysfsbm,lcdm（列车代码）,cc（车次）,sfzt,lcyn（列车运能）
   if (fields.size() < 7) {
     return nullptr;
@@ -397,27 +711,24 @@ std::shared_ptr<Train> FileManager::parseTrainFromCSV(
     else if (trainCode.find("T") == 0)
       type = "特快";
 
-    // 暂时不关联具体线路，设为空
-    std::shared_ptr<Route> route = nullptr;
-    if (!routes.empty()) {
-      route = routes[0]; // 使用第一条线路作为默认
-    }
-
-    return std::make_shared<Train>(trainCode, type, route, capacity);
+    // 列车表不含运行线路，不绑定线路（需要时由TimetableGenerator合成）
+    return std::make_shared<Train>(trainCode, type, nullptr, capacity);
   } catch (const std::exception &e) {
     lastError = std::string("解析列车数据错误: ") + e.what();
     return nullptr;
   }
 }
 
-std::string FileManager::formatTrainToCSV(const Train &train) const {
-  std::ostringstream oss;
-  oss << train.getTrainId() << ',' << train.getTrainType() << ',';
+void FileManager::formatTrainToCSV(const Train &train, std::string &out) {
+  CsvWriter::appendEscaped(out, train.getTrainId());
+  out.push_back(',');
+  CsvWriter::appendEscaped(out, train.getTrainType());
+  out.push_back(',');
   if (train.getRoute()) {
-    oss << train.getRoute()->getRouteId();
+    CsvWriter::appendEscaped(out, train.getRoute()->getRouteId());
   }
-  oss << ',' << train.getTotalCapacity();
-  return oss.str();
+  out.push_back(',');
+  CsvWriter::appendNumber(out, static_cast<long long>(train.getTotalCapacity()));
 }
 
 FlowRecord FileManager::parseFlowRecordFromCSV(
@@ -468,249 +779,312 @@ FlowRecord FileManager::parseFlowRecordFromCSV(
   }
 }
 
-std::string FileManager::formatFlowRecordToCSV(const FlowRecord &record) const {
-  std::ostringstream oss;
-  oss << record.getRecordId() << ',' << record.getStationId() << ','
-      << record.getStationName() << ',' << dateToString(record.getDate()) << ','
-      << record.getHour() << ',' << record.getBoardingCount() << ','
-      << record.getAlightingCount() << ',' << record.getTrainId() << ','
-      << record.getDirection();
-  return oss.str();
+void FileManager::formatFlowRecordToCSV(const FlowRecord &record,
+                                        std::string &out) {
+  CsvWriter::appendEscaped(out, record.getRecordId());
+  out.push_back(',');
+  CsvWriter::appendEscaped(out, record.getStationId());
+  out.push_back(',');
+  CsvWriter::appendEscaped(out, record.getStationName());
+  out.push_back(',');
+  appendDate(out, record.getDate());
+  out.push_back(',');
+  CsvWriter::appendNumber(out, static_cast<long long>(record.getHour()));
+  out.push_back(',');
+  CsvWriter::appendNumber(out,
+                          static_cast<long long>(record.getBoardingCount()));
+  out.push_back(',');
+  CsvWriter::appendNumber(out,
+                          static_cast<long long>(record.getAlightingCount()));
+  out.push_back(',');
+  CsvWriter::appendEscaped(out, record.getTrainId());
+  out.push_back(',');
+  CsvWriter::appendEscaped(out, record.getDirection());
 }
 
-// 其他未实现的方法（简化版本）
-std::vector<std::shared_ptr<Route>>
-FileManager::loadRoutes(const std::vector<std::shared_ptr<Station>> &stations) {
-  std::vector<std::shared_ptr<Route>> routes;
-  std::string fullPath = getFullPath(routesFile);
-  std::ifstream file(fullPath);
-  if (!file.is_open()) {
+// ========== 批量写出 ==========
+
+bool FileManager::writeStationsCSV(
+    const std::vector<std::shared_ptr<Station>> &stations,
+    const std::string &fullPath) {
+  CsvWriter writer(fullPath);
+  if (!writer.isOpen()) {
     lastError = "无法打开文件: " + fullPath;
-    return routes;
+    return false;
   }
-  std::string line;
-  bool first = true;
-  while (std::getline(file, line)) {
-    if (first) {
-      first = false;
-      continue;
-    }
-    auto fields = splitCSVLine(line);
-    auto route = parseRouteFromCSV(fields, stations);
-    if (route)
-      routes.push_back(route);
+
+  writer.writeRaw("StationID,StationName,CityName,Longitude,Latitude,"
+                  "StationType,PlatformCount,IsTransferStation\n");
+  writer.writeRowsParallel(
+      stations, [](std::string &out, const std::shared_ptr<Station> &station) {
+        if (station) {
+          formatStationToCSV(*station, out);
+          out.push_back('\n');
+        }
+      });
+
+  if (!writer.close()) {
+    lastError = "写入文件失败: " + fullPath;
+    return false;
   }
-  return routes;
+  return true;
 }
 
-bool FileManager::saveRoutes(
-    const std::vector<std::shared_ptr<Route>> &routes) {
-  std::string fullPath = getFullPath(routesFile);
-  std::ofstream file(fullPath);
-  if (!file.is_open()) {
+bool FileManager::writeRoutesCSV(
+    const std::vector<std::shared_ptr<Route>> &routes,
+    const std::string &fullPath) {
+  CsvWriter writer(fullPath);
+  if (!writer.isOpen()) {
     lastError = "无法打开文件: " + fullPath;
     return false;
   }
-  file << "RouteID,RouteName,RouteType,TotalDistance,MaxSpeed,StationIDs\n";
-  for (const auto &r : routes) {
-    if (r)
-      file << formatRouteToCSV(*r) << '\n';
+
+  writer.writeRaw(
+      "RouteID,RouteName,RouteType,TotalDistance,MaxSpeed,StationIDs,"
+      "SegmentDistances\n");
+  writer.writeRowsParallel(
+      routes, [](std::string &out, const std::shared_ptr<Route> &route) {
+        if (route) {
+          formatRouteToCSV(*route, out);
+          out.push_back('\n');
+        }
+      });
+
+  if (!writer.close()) {
+    lastError = "写入文件失败: " + fullPath;
+    return false;
   }
   return true;
 }
 
-bool FileManager::saveRoute(const Route &route) {
-  std::string fullPath = getFullPath(routesFile);
-  std::ofstream file(fullPath, std::ios::app);
-  if (!file.is_open()) {
+bool FileManager::writeFlowRecordsCSV(const PassengerFlow &passengerFlow,
+                                      const std::string &fullPath) {
+  CsvWriter writer(fullPath);
+  if (!writer.isOpen()) {
     lastError = "无法打开文件: " + fullPath;
     return false;
   }
-  file << formatRouteToCSV(route) << '\n';
+
+  writer.writeRaw("RecordID,StationID,StationName,Date,Hour,BoardingCount,"
+                  "AlightingCount,TrainID,Direction\n");
+  writer.writeRowsParallel(passengerFlow.getRecords(),
+                           [](std::string &out, const FlowRecord &record) {
+                             formatFlowRecordToCSV(record, out);
+                             out.push_back('\n');
+                           });
+
+  if (!writer.close()) {
+    lastError = "写入文件失败: " + fullPath;
+    return false;
+  }
   return true;
 }
 
-std::vector<std::shared_ptr<Train>>
-FileManager::loadTrains(const std::vector<std::shared_ptr<Route>> &routes) {
-  std::vector<std::shared_ptr<Train>> trains;
-  std::string fullPath = getFullPath(trainsFile);
-  std::ifstream file(fullPath);
-  if (!file.is_open()) {
+bool FileManager::appendCSVLine(const std::string &fullPath,
+                                std::string &line) {
+  line.push_back('\n');
+  CsvWriter writer(fullPath, true, line.size() + 1);
+  if (!writer.isOpen()) {
     lastError = "无法打开文件: " + fullPath;
-    return trains;
+    return false;
   }
-  std::string line;
-  bool first = true;
-  while (std::getline(file, line)) {
-    if (first) {
-      first = false;
+  writer.writeRaw(line);
+  return writer.close();
+}
+
+// 其他未实现的方法（简化版本）
+std::vector<std::shared_ptr<Route>>
+FileManager::loadRoutes(const std::vector<std::shared_ptr<Station>> &stations) {
+  std::string fullPath = getFullPath(routesFile);
+  std::string content;
+  if (!readFileContent(fullPath, content)) {
+    lastError = "无法打开文件: " + fullPath;
+    return {};
+  }
+  auto routes = parseRouteRows(splitCSVContent(content), stations);
+  markTransferStations(stations, routes);
+  return routes;
+}
+
+void FileManager::markTransferStations(
+    const std::vector<std::shared_ptr<Station>> &stations,
+    const std::vector<std::shared_ptr<Route>> &routes) {
+  // 清除旧标记，避免重载或线路变更后残留
+  for (const auto &station : stations) {
+    if (station) {
+      station->setIsTransferStation(false);
+    }
+  }
+  for (const auto &route : routes) {
+    if (!route) {
       continue;
     }
-    auto fields = splitCSVLine(line);
-    auto train = parseTrainFromCSV(fields, routes);
-    if (train)
-      trains.push_back(train);
+    for (const auto &station : route->getStations()) {
+      if (station) {
+        station->setIsTransferStation(false);
+      }
+    }
+  }
+
+  // 站点 -> (最近经停的线路序号, 经停线路数)
+  std::unordered_map<Station *, std::pair<size_t, int>> servedBy;
+  for (size_t i = 0; i < routes.size(); ++i) {
+    if (!routes[i]) {
+      continue;
+    }
+    for (const auto &station : routes[i]->getStations()) {
+      if (!station) {
+        continue;
+      }
+      auto inserted = servedBy.emplace(station.get(), std::make_pair(i, 1));
+      auto &entry = inserted.first->second;
+      if (!inserted.second && entry.first != i) {
+        entry.first = i;
+        if (++entry.second == 2) {
+          station->setIsTransferStation(true);
+        }
+      }
+    }
   }
-  return trains;
+}
+
+bool FileManager::saveRoutes(
+    const std::vector<std::shared_ptr<Route>> &routes) {
+  return writeRoutesCSV(routes, getFullPath(routesFile));
+}
+
+bool FileManager::saveRoute(const Route &route) {
+  std::string line;
+  formatRouteToCSV(route, line);
+  return appendCSVLine(getFullPath(routesFile), line);
+}
+
+std::vector<std::shared_ptr<Train>> FileManager::loadTrains() {
+  std::string fullPath = getFullPath(trainsFile);
+  std::string content;
+  if (!readFileContent(fullPath, content)) {
+    lastError = "无法打开文件: " + fullPath;
+    return {};
+  }
+  return parseTrainRows(splitCSVContent(content));
 }
 
 bool FileManager::saveTrains(
     const std::vector<std::shared_ptr<Train>> &trains) {
   std::string fullPath = getFullPath(trainsFile);
-  std::ofstream file(fullPath);
-  if (!file.is_open()) {
+  CsvWriter writer(fullPath);
+  if (!writer.isOpen()) {
     lastError = "无法打开文件: " + fullPath;
     return false;
   }
-  file << "TrainID,TrainType,RouteID,TotalCapacity\n";
-  for (const auto &t : trains) {
-    if (t)
-      file << formatTrainToCSV(*t) << '\n';
+
+  writer.writeRaw("TrainID,TrainType,RouteID,TotalCapacity\n");
+  writer.writeRowsParallel(
+      trains, [](std::string &out, const std::shared_ptr<Train> &train) {
+        if (train) {
+          formatTrainToCSV(*train, out);
+          out.push_back('\n');
+        }
+      });
+
+  if (!writer.close()) {
+    lastError = "写入文件失败: " + fullPath;
+    return false;
   }
   return true;
 }
 
 bool FileManager::saveTrain(const Train &train) {
-  std::string fullPath = getFullPath(trainsFile);
-  std::ofstream file(fullPath, std::ios::app);
-  if (!file.is_open()) {
-    lastError = "无法打开文件: " + fullPath;
-    return false;
-  }
-  file << formatTrainToCSV(train) << '\n';
-  return true;
+  std::string line;
+  formatTrainToCSV(train, line);
+  return appendCSVLine(getFullPath(trainsFile), line);
 }
 
 bool FileManager::saveFlowRecords(const PassengerFlow &passengerFlow) {
+  return writeFlowRecordsCSV(passengerFlow, getFullPath(flowRecordsFile));
+}
+
+bool FileManager::loadFlowRecords(PassengerFlow &passengerFlow,
+                                  int maxRecords, long *parsedOffset) {
   std::string fullPath = getFullPath(flowRecordsFile);
-  std::ofstream file(fullPath);
-  if (!file.is_open()) {
-    lastError = "无法打开文件: " + fullPath;
+  std::string content;
+  if (!readFileContent(fullPath, content)) {
+    lastError = "客流数据文件不存在或无法打开: " + fullPath;
     return false;
   }
-  file << "RecordID,StationID,StationName,Date,Hour,BoardingCount,"
-          "AlightingCount,TrainID,Direction\n";
-  auto records =
-      passengerFlow.getRecordsByDateRange(Date(0, 1, 1), Date(9999, 12, 31));
-  for (const auto &rec : records) {
-    file << formatFlowRecordToCSV(rec) << '\n';
+  if (parsedOffset) {
+    *parsedOffset = static_cast<long>(trimToCompleteLines(content));
+  }
+
+  std::vector<FlowRecord> records;
+  if (parseFlowRecordRows(splitCSVContent(content), records, maxRecords) ==
+      0) {
+    lastError = "未找到有效的客流数据记录";
+    return false;
   }
+
+  passengerFlow.addRecords(std::move(records));
   return true;
 }
 
-bool FileManager::loadFlowRecords(PassengerFlow &passengerFlow) {
+int FileManager::loadFlowRecordsTail(PassengerFlow &passengerFlow, long offset,
+                                     long &nextOffset) {
   std::string fullPath = getFullPath(flowRecordsFile);
-  std::ifstream file(fullPath);
+  std::ifstream file(fullPath, std::ios::binary | std::ios::ate);
+  nextOffset = offset;
   if (!file.is_open()) {
     lastError = "客流数据文件不存在或无法打开: " + fullPath;
-    return false;
+    return -1;
   }
 
-  std::string line;
-  bool first = true;
-  int validRecords = 0;
-  int totalLines = 0;
-
-  while (std::getline(file, line)) {
-    totalLines++;
-    if (first) {
-      first = false;
-      continue; // 跳过头行
-    }
-
-    // 跳过空行或无效行
-    if (line.empty() ||
-        line.find_first_not_of(" \t\r\n") == std::string::npos) {
-      continue;
-    }
+  long size = static_cast<long>(file.tellg());
+  if (size <= offset) {
+    return 0;
+  }
 
-    try {
-      auto fields = splitCSVLine(line);
-      if (fields.size() >= 9) { // 确保有足够的字段
-        auto record = parseFlowRecordFromCSV(fields);
-        if (!record.getRecordId().empty()) { // 确保记录有效
-          passengerFlow.addRecord(record);
-          validRecords++;
-        }
-      }
-    } catch (const std::exception &) {
-      // 跳过无法解析的行
-      continue;
-    }
+  std::string content(static_cast<size_t>(size - offset), '\0');
+  file.seekg(offset);
+  file.read(&content[0], size - offset);
+  content.resize(static_cast<size_t>(file.gcount()));
 
-    // 限制加载数量避免内存问题
-    if (validRecords >= 10000) {
-      break;
-    }
+  // 只消费完整的行，末尾未写完的行留到下次
+  if (trimToCompleteLines(content) == 0) {
+    return 0;
   }
-
-  if (validRecords == 0) {
-    lastError = "未找到有效的客流数据记录";
-    return false;
+  nextOffset = offset + static_cast<long>(content.size());
+
+  // 文件原本为空时，追加内容的第一行是CSV头部
+  std::vector<FlowRecord> records;
+  parseFlowRecordRows(splitCSVContent(content, offset == 0), records,
+                      NO_RECORD_LIMIT);
+  int added = static_cast<int>(records.size());
+  if (added > 0) {
+    passengerFlow.addRecords(std::move(records));
   }
-
-  return true;
+  return added;
 }
 
 bool FileManager::appendFlowRecord(const FlowRecord &record) {
-  std::string fullPath = getFullPath(flowRecordsFile);
-  std::ofstream file(fullPath, std::ios::app);
-  if (!file.is_open()) {
-    lastError = "无法打开文件: " + fullPath;
-    return false;
-  }
-  file << formatFlowRecordToCSV(record) << '\n';
-  return true;
+  std::string line;
+  formatFlowRecordToCSV(record, line);
+  return appendCSVLine(getFullPath(flowRecordsFile), line);
 }
 
 bool FileManager::exportStationsToCSV(
     const std::vector<std::shared_ptr<Station>> &stations,
     const std::string &filename) {
-  std::ofstream file(getFullPath(filename));
-  if (!file.is_open()) {
-    lastError = "无法打开文件: " + getFullPath(filename);
-    return false;
-  }
-  file << "StationID,StationName,CityName,Longitude,Latitude,StationType,"
-          "PlatformCount,IsTransferStation\n";
-  for (const auto &station : stations) {
-    if (station)
-      file << formatStationToCSV(*station) << '\n';
-  }
-  return true;
+  return writeStationsCSV(stations, getFullPath(filename));
 }
 
 bool FileManager::exportRoutesToCSV(
     const std::vector<std::shared_ptr<Route>> &routes,
     const std::string &filename) {
-  std::ofstream file(getFullPath(filename));
-  if (!file.is_open()) {
-    lastError = "无法打开文件: " + getFullPath(filename);
-    return false;
-  }
-  file << "RouteID,RouteName,RouteType,TotalDistance,MaxSpeed,StationIDs\n";
-  for (const auto &route : routes) {
-    if (route)
-      file << formatRouteToCSV(*route) << '\n';
-  }
-  return true;
+  return writeRoutesCSV(routes, getFullPath(filename));
 }
 
 bool FileManager::exportFlowRecordsToCSV(const PassengerFlow &passengerFlow,
                                          const std::string &filename) {
-  std::ofstream file(getFullPath(filename));
-  if (!file.is_open()) {
-    lastError = "无法打开文件: " + getFullPath(filename);
-    return false;
-  }
-  file << "RecordID,StationID,StationName,Date,Hour,BoardingCount,"
-          "AlightingCount,TrainID,Direction\n";
-  auto records =
-      passengerFlow.getRecordsByDateRange(Date(0, 1, 1), Date(9999, 12, 31));
-  for (const auto &rec : records) {
-    file << formatFlowRecordToCSV(rec) << '\n';
-  }
-  return true;
+  return writeFlowRecordsCSV(passengerFlow, getFullPath(filename));
 }
 
 bool FileManager::importStationsFromCSV(
@@ -747,16 +1121,17 @@ bool FileManager::importRoutesFromCSV(
   }
   std::string line;
   bool first = true;
+  std::vector<std::vector<std::string>> rows;
   while (std::getline(file, line)) {
     if (first) {
       first = false;
       continue;
     }
-    auto fields = splitCSVLine(line);
-    auto rt = parseRouteFromCSV(fields, stations);
-    if (rt)
-      routes.push_back(rt);
+    rows.push_back(splitCSVLine(line));
   }
+  auto parsed = parseRouteRows(rows, stations);
+  routes.insert(routes.end(), parsed.begin(), parsed.end());
+  markTransferStations(stations, routes);
   return true;
 }
 
@@ -781,6 +1156,43 @@ bool FileManager::importFlowRecordsFromCSV(const std::string &filename,
   return true;
 }
 
+// 数据备份：内容定义分块，仓库中已有的数据块不再重复写入
+bool FileManager::backupData(const std::string &backupDir) {
+  std::vector<std::string> files;
+  for (const auto &name :
+       {stationsFile, routesFile, trainsFile, flowRecordsFile, configFile}) {
+    if (fileExists(getFullPath(name))) {
+      files.push_back(name);
+    }
+  }
+  if (files.empty()) {
+    lastError = "没有可备份的数据文件: " + dataDirectory;
+    return false;
+  }
+
+  BackupStore store(backupDir);
+  BackupStats stats;
+  if (!store.backup(dataDirectory, files, stats)) {
+    lastError = store.getLastError();
+    return false;
+  }
+  return true;
+}
+
+// 数据恢复：按最近一次备份清单并行还原数据块
+bool FileManager::restoreData(const std::string &backupDir) {
+  if (!dataDirectory.empty() && !createDirectory(dataDirectory)) {
+    return false;
+  }
+
+  BackupStore store(backupDir);
+  if (!store.restore(dataDirectory)) {
+    lastError = store.getLastError();
+    return false;
+  }
+  return true;
+}
+
 bool FileManager::exportAllData(
     const std::vector<std::shared_ptr<Station>> &stations,
     const std::vector<std::shared_ptr<Route>> &routes,
@@ -793,17 +1205,193 @@ bool FileManager::exportAllData(
 bool FileManager::importAllData(std::vector<std::shared_ptr<Station>> &stations,
                                 std::vector<std::shared_ptr<Route>> &routes,
                                 std::vector<std::shared_ptr<Train>> &trains,
-                                PassengerFlow &passengerFlow) {
-  stations = loadStations();
-  if (!lastError.empty() && stations.empty())
+                                PassengerFlow &passengerFlow,
+                                int maxFlowRecords, long *flowParsedOffset) {
+  // 客流文件与拓扑文件互不依赖，与拓扑导入并行读取和解析
+  std::string flowPath = getFullPath(flowRecordsFile);
+  auto flowTask = std::async(std::launch::async, [this, flowPath,
+                                                  maxFlowRecords,
+                                                  flowParsedOffset]() {
+    std::pair<bool, std::vector<FlowRecord>> result;
+    std::string content;
+    result.first = readFileContent(flowPath, content);
+    if (result.first) {
+      if (flowParsedOffset) {
+        *flowParsedOffset = static_cast<long>(trimToCompleteLines(content));
+      }
+      parseFlowRecordRows(splitCSVContent(content), result.second,
+                          maxFlowRecords);
+    }
+    return result;
+  });
+
+  bool topologyLoaded = importTopology(stations, routes, trains);
+  auto flow = flowTask.get();
+
+  if (!topologyLoaded)
+    return false;
+  if (!flow.first) {
+    lastError = "客流数据文件不存在或无法打开: " + flowPath;
+    return false;
+  }
+  if (flow.second.empty()) {
+    lastError = "未找到有效的客流数据记录";
     return false;
-  routes = loadRoutes(stations);
-  if (!lastError.empty())
+  }
+
+  passengerFlow.addRecords(std::move(flow.second));
+  return true;
+}
+
+bool FileManager::importTopology(
+    std::vector<std::shared_ptr<Station>> &stations,
+    std::vector<std::shared_ptr<Route>> &routes,
+    std::vector<std::shared_ptr<Train>> &trains) {
+  using Rows = std::vector<std::vector<std::string>>;
+  stations.clear();
+  routes.clear();
+  trains.clear();
+
+  // 读取并拆分文件内容；失败时返回false，由调用线程统一设置lastError
+  auto readRows = [this](const std::string &fullPath, Rows &rows) {
+    std::string content;
+    if (!readFileContent(fullPath, content)) {
+      return false;
+    }
+    rows = splitCSVContent(content);
+    return true;
+  };
+
+  std::string stationsPath = getFullPath(stationsFile);
+  std::string routesPath = getFullPath(routesFile);
+  std::string trainsPath = getFullPath(trainsFile);
+
+  // 三个文件的I/O与字段拆分并行；站点解析在其工作线程内完成。
+  // 解析过程中只有站点任务可能写入lastError，调用线程在get()上等待。
+  Rows routeRows, trainRows;
+  auto stationTask =
+      std::async(std::launch::async, [this, &readRows, stationsPath]() {
+        std::pair<bool, std::vector<std::shared_ptr<Station>>> result;
+        Rows rows;
+        result.first = readRows(stationsPath, rows);
+        if (result.first) {
+          result.second = parseStationRows(rows);
+        }
+        return result;
+      });
+  auto routeTask =
+      std::async(std::launch::async, [&readRows, &routeRows, routesPath]() {
+        return readRows(routesPath, routeRows);
+      });
+  bool trainsRead = readRows(trainsPath, trainRows);
+
+  auto stationResult = stationTask.get();
+  bool routesRead = routeTask.get();
+
+  if (!stationResult.first) {
+    lastError = "无法打开文件: " + stationsPath;
+    return false;
+  }
+  stations = std::move(stationResult.second);
+
+  // 依赖汇合：线路需要站点
+  if (!routesRead) {
+    lastError = "无法打开文件: " + routesPath;
+    return false;
+  }
+  routes = parseRouteRows(routeRows, stations);
+  markTransferStations(stations, routes);
+
+  if (!trainsRead) {
+    lastError = "无法打开文件: " + trainsPath;
     return false;
-  trains = loadTrains(routes);
-  if (!lastError.empty())
+  }
+  trains = parseTrainRows(trainRows);
+  return true;
+}
+
+// 报告生成
+bool FileManager::writeTextFile(const std::string &fullPath,
+                                const std::string &text) {
+  CsvWriter writer(fullPath);
+  if (!writer.isOpen()) {
+    lastError = "无法打开文件: " + fullPath;
     return false;
-  if (!loadFlowRecords(passengerFlow))
+  }
+  writer.writeRaw(text);
+  if (!writer.close()) {
+    lastError = "写入文件失败: " + fullPath;
     return false;
+  }
   return true;
 }
+
+bool FileManager::generateReport(const std::string &reportContent,
+                                 const std::string &filename) {
+  return writeTextFile(getFullPath(filename), reportContent);
+}
+
+bool FileManager::generateAnalysisReport(const std::string &analysisData,
+                                         const std::string &filename) {
+  std::string report;
+  report.reserve(analysisData.size() + 128);
+  report.append("# 轨道交通客流分析报告\n");
+  report.append("# 生成时间: ");
+  std::time_t now = std::time(nullptr);
+  char timeText[32];
+  std::strftime(timeText, sizeof(timeText), "%Y-%m-%d %H:%M:%S",
+                std::localtime(&now));
+  report.append(timeText);
+  report.append("\n\n");
+  report.append(analysisData);
+  if (!report.empty() && report.back() != '\n') {
+    report.push_back('\n');
+  }
+  return writeTextFile(getFullPath(filename), report);
+}
+
+// 数据验证
+bool FileManager::checkValidation(const ValidationReport &report,
+                                  DataFileKind kind) const {
+  if (report.countOf(kind) == 0) {
+    return true;
+  }
+  lastError = report.toString(20);
+  return false;
+}
+
+bool FileManager::validateStationData(const std::string &filename) const {
+  ValidationEngine engine;
+  engine.setFile(DataFileKind::Stations, getFullPath(filename));
+  return checkValidation(engine.run(), DataFileKind::Stations);
+}
+
+bool FileManager::validateRouteData(const std::string &filename) const {
+  // 站点文件仅用于检查引用完整性
+  ValidationEngine engine;
+  engine.setFile(DataFileKind::Stations, getFullPath(stationsFile), false);
+  engine.setFile(DataFileKind::Routes, getFullPath(filename));
+  return checkValidation(engine.run(), DataFileKind::Routes);
+}
+
+bool FileManager::validateFlowData(const std::string &filename) const {
+  ValidationEngine engine;
+  engine.setFile(DataFileKind::Stations, getFullPath(stationsFile), false);
+  engine.setFile(DataFileKind::Trains, getFullPath(trainsFile), false);
+  engine.setFile(DataFileKind::FlowRecords, getFullPath(filename));
+  return checkValidation(engine.run(), DataFileKind::FlowRecords);
+}
+
+ValidationReport FileManager::validateAllData() const {
+  ValidationEngine engine;
+  engine.setFile(DataFileKind::Stations, getFullPath(stationsFile));
+  engine.setFile(DataFileKind::Routes, getFullPath(routesFile));
+  engine.setFile(DataFileKind::Trains, getFullPath(trainsFile));
+  engine.setFile(DataFileKind::FlowRecords, getFullPath(flowRecordsFile),
+                 false);
+  ValidationReport report = engine.run();
+  if (!report.isValid()) {
+    lastError = report.toString(20);
+  }
+  return report;
+}
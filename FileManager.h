@@ -5,9 +5,11 @@
 #include "Route.h"
 #include "Station.h"
 #include "Train.h"
+#include "ValidationEngine.h"
 #include <fstream>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 
@@ -36,7 +38,19 @@ public:
   void setFlowRecordsFile(const std::string &filename);
   void setConfigFile(const std::string &filename);
 
+  // 数据文件完整路径
+  std::string getStationsPath() const { return getFullPath(stationsFile); }
+  std::string getRoutesPath() const { return getFullPath(routesFile); }
+  std::string getTrainsPath() const { return getFullPath(trainsFile); }
+  std::string getFlowRecordsPath() const {
+    return getFullPath(flowRecordsFile);
+  }
+
   // 站点数据操作
+  // 站点CSV不含经纬度：按站名确定性估算的占位坐标（成都、重庆等站聚在
+  // 各自城区附近，其余站点散布在成渝之间），并非真实位置
+  static void estimateStationPosition(const std::string &stationName,
+                                      double &longitude, double &latitude);
   bool saveStations(const std::vector<std::shared_ptr<Station>> &stations);
   std::vector<std::shared_ptr<Station>> loadStations();
   bool saveStation(const Station &station);
@@ -46,17 +60,33 @@ public:
   std::vector<std::shared_ptr<Route>>
   loadRoutes(const std::vector<std::shared_ptr<Station>> &stations);
   bool saveRoute(const Route &route);
+  // 重新计算换乘站标记：先清除stations及各线路经停站点的标记，
+  // 再将至少两条线路经停的站点标记为换乘站
+  static void
+  markTransferStations(const std::vector<std::shared_ptr<Station>> &stations,
+                       const std::vector<std::shared_ptr<Route>> &routes);
 
   // 列车数据操作
   bool saveTrains(const std::vector<std::shared_ptr<Train>> &trains);
-  std::vector<std::shared_ptr<Train>>
-  loadTrains(const std::vector<std::shared_ptr<Route>> &routes);
+  // 列车表不含运行线路，加载的列车均未绑定线路
+  std::vector<std::shared_ptr<Train>> loadTrains();
   bool saveTrain(const Train &train);
 
-  // 客流记录操作
+  // 客流记录操作。maxRecords为加载条数上限，NO_RECORD_LIMIT表示不限；
+  // 需要记录已解析位置的增量加载必须不限条数，否则超出部分会被跳过。
+  // parsedOffset非空时只解析到最后一个换行符为止的完整行，并写入其后的
+  // 字节偏移，末尾未写完的行留给loadFlowRecordsTail
+  static constexpr int DEFAULT_FLOW_RECORD_LIMIT = 10000;
+  static constexpr int NO_RECORD_LIMIT = 0;
   bool saveFlowRecords(const PassengerFlow &passengerFlow);
-  bool loadFlowRecords(PassengerFlow &passengerFlow);
+  bool loadFlowRecords(PassengerFlow &passengerFlow,
+                       int maxRecords = DEFAULT_FLOW_RECORD_LIMIT,
+                       long *parsedOffset = nullptr);
   bool appendFlowRecord(const FlowRecord &record);
+  // 增量导入：解析客流文件中从offset开始追加的全部完整行（不限条数），
+  // 返回新增记录数
+  int loadFlowRecordsTail(PassengerFlow &passengerFlow, long offset,
+                          long &nextOffset);
 
   // 批量数据操作
   bool exportAllData(const std::vector<std::shared_ptr<Station>> &stations,
@@ -67,7 +97,14 @@ public:
   bool importAllData(std::vector<std::shared_ptr<Station>> &stations,
                      std::vector<std::shared_ptr<Route>> &routes,
                      std::vector<std::shared_ptr<Train>> &trains,
-                     PassengerFlow &passengerFlow);
+                     PassengerFlow &passengerFlow,
+                     int maxFlowRecords = DEFAULT_FLOW_RECORD_LIMIT,
+                     long *flowParsedOffset = nullptr);
+
+  // 并发导入站点、线路、列车（各文件的读取与解析并行，仅在依赖处汇合）
+  bool importTopology(std::vector<std::shared_ptr<Station>> &stations,
+                      std::vector<std::shared_ptr<Route>> &routes,
+                      std::vector<std::shared_ptr<Train>> &trains);
 
   // 数据备份和恢复
   bool backupData(const std::string &backupDir);
@@ -108,10 +145,12 @@ public:
   long getFileSize(const std::string &filename) const;
   std::string getLastModifiedTime(const std::string &filename) const;
 
-  // 数据验证
+  // 数据验证（失败时lastError为校验报告摘要）
   bool validateStationData(const std::string &filename) const;
   bool validateRouteData(const std::string &filename) const;
   bool validateFlowData(const std::string &filename) const;
+  // 一次并行扫描校验全部数据文件，用于导入前的检查
+  ValidationReport validateAllData() const;
 
   // 错误处理
   std::string getLastError() const { return lastError; }
@@ -127,23 +166,58 @@ private:
   bool parseDateFromString(const std::string &dateStr, Date &date) const;
   std::string dateToString(const Date &date) const;
 
+  // 批量读取与解析（不修改lastError以外的状态，可在工作线程中调用）
+  bool readFileContent(const std::string &fullPath, std::string &content) const;
+  // 截去最后一个换行符之后未写完的行，返回剩余（已完整的）字节数
+  static size_t trimToCompleteLines(std::string &content);
+  std::vector<std::vector<std::string>>
+  splitCSVContent(const std::string &content, bool skipHeader = true) const;
+  std::vector<std::shared_ptr<Station>>
+  parseStationRows(const std::vector<std::vector<std::string>> &rows) const;
+  std::vector<std::shared_ptr<Route>>
+  parseRouteRows(const std::vector<std::vector<std::string>> &rows,
+                 const std::vector<std::shared_ptr<Station>> &stations) const;
+  std::vector<std::shared_ptr<Route>> parseOperationalRouteRows(
+      const std::vector<std::vector<std::string>> &rows,
+      const std::vector<std::shared_ptr<Station>> &stations) const;
+  std::vector<std::shared_ptr<Train>>
+  parseTrainRows(const std::vector<std::vector<std::string>> &rows) const;
+  int parseFlowRecordRows(const std::vector<std::vector<std::string>> &rows,
+                          std::vector<FlowRecord> &records,
+                          int maxRecords) const;
+
   // 数据解析方法
   std::shared_ptr<Station>
   parseStationFromCSV(const std::vector<std::string> &fields) const;
   std::shared_ptr<Route> parseRouteFromCSV(
       const std::vector<std::string> &fields,
-      const std::vector<std::shared_ptr<Station>> &stations) const;
+      const std::unordered_map<std::string, std::shared_ptr<Station>>
+          &stationIndex) const;
   std::shared_ptr<Train>
-  parseTrainFromCSV(const std::vector<std::string> &fields,
-                    const std::vector<std::shared_ptr<Route>> &routes) const;
+  parseTrainFromCSV(const std::vector<std::string> &fields) const;
   FlowRecord
   parseFlowRecordFromCSV(const std::vector<std::string> &fields) const;
 
-  // 数据格式化方法
-  std::string formatStationToCSV(const Station &station) const;
-  std::string formatRouteToCSV(const Route &route) const;
-  std::string formatTrainToCSV(const Train &train) const;
-  std::string formatFlowRecordToCSV(const FlowRecord &record) const;
+  // 数据格式化方法（追加到out，无中间字符串，可在工作线程中调用）
+  static void formatStationToCSV(const Station &station, std::string &out);
+  static void formatRouteToCSV(const Route &route, std::string &out);
+  static void formatTrainToCSV(const Train &train, std::string &out);
+  static void formatFlowRecordToCSV(const FlowRecord &record,
+                                    std::string &out);
+  static void appendDate(std::string &out, const Date &date);
+
+  // 批量写出（缓冲写入，分区并行格式化）
+  bool writeStationsCSV(const std::vector<std::shared_ptr<Station>> &stations,
+                        const std::string &fullPath);
+  bool writeRoutesCSV(const std::vector<std::shared_ptr<Route>> &routes,
+                      const std::string &fullPath);
+  bool writeFlowRecordsCSV(const PassengerFlow &passengerFlow,
+                           const std::string &fullPath);
+  bool appendCSVLine(const std::string &fullPath, std::string &line);
+  bool writeTextFile(const std::string &fullPath, const std::string &text);
+
+  bool checkValidation(const ValidationReport &report,
+                       DataFileKind kind) const;
 };
 
 #endif // FILEMANAGER_H
\ No newline at end of file
@@ -0,0 +1,197 @@
+#include "FlowScheduleJoin.h"
+#include "ParallelUtils.h"
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
+namespace {
+
+const int MINUTES_PER_DAY = 24 * 60;
+const int HOUR_BITS = 5; // 排序键低位存放小时（0-23）
+
+// 停站时段[arrival, departure]与记录小时[start, start + 59]的间隔（按日循环）
+int hourGap(int arrival, int departure, int hour) {
+  int start = hour * 60;
+  int best = MINUTES_PER_DAY;
+  for (int shift = -MINUTES_PER_DAY; shift <= MINUTES_PER_DAY;
+       shift += MINUTES_PER_DAY) {
+    int from = arrival + shift;
+    int to = departure + shift;
+    int gap = 0;
+    if (to < start) {
+      gap = start - to;
+    } else if (from > start + 59) {
+      gap = from - (start + 59);
+    }
+    best = std::min(best, gap);
+  }
+  return best;
+}
+
+} // namespace
+
+// 构造函数：各列车停站按(站点, 到站时刻)排序，供归并使用
+FlowScheduleJoin::FlowScheduleJoin(
+    std::shared_ptr<const EntityCatalog> entityCatalog, int tolerance)
+    : catalog(entityCatalog ? entityCatalog : EntityCatalog::empty()),
+      toleranceMinutes(tolerance) {
+  trainStops.resize(catalog->getTrainCount());
+  for (EntityHandle train = 0; train < catalog->getTrainCount(); ++train) {
+    const auto &trainPtr = catalog->getTrain(train);
+    const auto &schedule = trainPtr->getSchedule();
+    auto &stops = trainStops[train];
+    for (size_t i = 0; i < schedule.size(); ++i) {
+      EntityHandle station = catalog->getStationHandle(schedule[i].stationId);
+      if (station != INVALID_HANDLE) {
+        stops.push_back({station,
+                         trainPtr->getArrivalMinute(i) % MINUTES_PER_DAY,
+                         static_cast<int>(i)});
+      }
+    }
+    std::sort(stops.begin(), stops.end(), [](const Stop &a, const Stop &b) {
+      if (a.station != b.station) {
+        return a.station < b.station;
+      }
+      return a.arrival != b.arrival ? a.arrival < b.arrival : a.stop < b.stop;
+    });
+  }
+}
+
+void FlowScheduleJoin::fillMatch(EntityHandle train, int stop, int hour,
+                                 ScheduleMatch &match) const {
+  const auto &trainPtr = catalog->getTrain(train);
+  match.stop = stop;
+  match.arrivalMinute = trainPtr->getArrivalMinute(stop) % MINUTES_PER_DAY;
+  match.dwellMinutes =
+      trainPtr->getDepartureMinute(stop) - trainPtr->getArrivalMinute(stop);
+  match.departureMinute = match.arrivalMinute + match.dwellMinutes;
+  match.travelMinutes =
+      stop > 0 ? trainPtr->getTravelTimeByIndex(stop - 1, stop) : 0;
+  match.offsetMinutes =
+      hourGap(match.arrivalMinute, match.departureMinute, hour);
+  match.status = match.offsetMinutes <= toleranceMinutes
+                     ? JoinStatus::Matched
+                     : JoinStatus::TimeMismatch;
+}
+
+std::vector<ScheduleMatch>
+FlowScheduleJoin::join(const std::vector<FlowRecord> &records) const {
+  size_t recordCount = records.size();
+  std::vector<ScheduleMatch> matches(recordCount);
+  std::vector<unsigned char> hours(recordCount);
+
+  // 解析句柄；待归并的记录暂记为NotOnSchedule
+  parallelFor(
+      recordCount,
+      [&](size_t begin, size_t end, unsigned) {
+        for (size_t i = begin; i < end; ++i) {
+          ScheduleMatch &match = matches[i];
+          hours[i] = static_cast<unsigned char>(
+              std::min(23, std::max(0, records[i].getHour())));
+          match.train = catalog->getTrainHandle(records[i].getTrainId());
+          if (match.train == INVALID_HANDLE) {
+            match.status = JoinStatus::UnknownTrain;
+            continue;
+          }
+          match.station = catalog->getStationHandle(records[i].getStationId());
+          if (match.station == INVALID_HANDLE) {
+            match.status = JoinStatus::UnknownStation;
+          } else if (trainStops[match.train].empty()) {
+            match.status = JoinStatus::NoSchedule;
+          } else {
+            match.status = JoinStatus::NotOnSchedule;
+          }
+        }
+      },
+      4096);
+
+  // 按列车计数排序分桶，同时生成(站点, 小时)排序键，避免归并阶段随机访问记录
+  size_t trainCount = trainStops.size();
+  std::vector<size_t> offsets(trainCount + 1, 0);
+  for (const auto &match : matches) {
+    if (match.status == JoinStatus::NotOnSchedule) {
+      offsets[match.train + 1]++;
+    }
+  }
+  for (size_t t = 0; t < trainCount; ++t) {
+    offsets[t + 1] += offsets[t];
+  }
+  std::vector<std::pair<long long, size_t>> keys(offsets.back());
+  std::vector<size_t> cursor(offsets.begin(), offsets.end() - 1);
+  for (size_t i = 0; i < recordCount; ++i) {
+    const ScheduleMatch &match = matches[i];
+    if (match.status == JoinStatus::NotOnSchedule) {
+      keys[cursor[match.train]++] = {
+          (static_cast<long long>(match.station) << HOUR_BITS) | hours[i], i};
+    }
+  }
+
+  // 桶内按(站点, 小时)排序后与停站归并，列车由各工作线程动态领取
+  std::atomic<size_t> next(0);
+  parallelFor(parallelWorkerCount(trainCount), [&](size_t, size_t, unsigned) {
+    for (size_t t = next++; t < trainCount; t = next++) {
+      auto first = keys.begin() + offsets[t];
+      auto last = keys.begin() + offsets[t + 1];
+      std::sort(first, last);
+
+      const auto &stops = trainStops[t];
+      size_t groupBegin = 0;
+      size_t current = 0;
+      EntityHandle currentStation = INVALID_HANDLE;
+      for (auto it = first; it != last; ++it) {
+        const auto &key = *it;
+        EntityHandle station = static_cast<EntityHandle>(key.first >> HOUR_BITS);
+        int hour = static_cast<int>(key.first & ((1 << HOUR_BITS) - 1));
+        if (station != currentStation) {
+          while (groupBegin < stops.size() &&
+                 stops[groupBegin].station < station) {
+            ++groupBegin;
+          }
+          currentStation = station;
+          current = groupBegin;
+        }
+        if (groupBegin == stops.size() || stops[groupBegin].station != station) {
+          continue;
+        }
+        // as-of：不晚于本小时结束的最后一次到站
+        while (current + 1 < stops.size() &&
+               stops[current + 1].station == station &&
+               stops[current + 1].arrival <= hour * 60 + 59) {
+          ++current;
+        }
+        fillMatch(static_cast<EntityHandle>(t), stops[current].stop, hour,
+                  matches[key.second]);
+      }
+    }
+  });
+
+  return matches;
+}
+
+JoinSummary
+FlowScheduleJoin::summarize(const std::vector<ScheduleMatch> &matches) {
+  JoinSummary summary;
+  for (const auto &match : matches) {
+    switch (match.status) {
+    case JoinStatus::Matched:
+      summary.matched++;
+      break;
+    case JoinStatus::UnknownTrain:
+      summary.unknownTrain++;
+      break;
+    case JoinStatus::UnknownStation:
+      summary.unknownStation++;
+      break;
+    case JoinStatus::NoSchedule:
+      summary.noSchedule++;
+      break;
+    case JoinStatus::NotOnSchedule:
+      summary.notOnSchedule++;
+      break;
+    case JoinStatus::TimeMismatch:
+      summary.timeMismatch++;
+      break;
+    }
+  }
+  return summary;
+}
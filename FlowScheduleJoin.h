@@ -0,0 +1,88 @@
+#ifndef FLOWSCHEDULEJOIN_H
+#define FLOWSCHEDULEJOIN_H
+
+#include "EntityCatalog.h"
+#include "PassengerFlow.h"
+#include <memory>
+#include <vector>
+
+// 客流记录与时刻表的匹配状态
+enum class JoinStatus {
+  Matched,
+  UnknownTrain,   // 列车号不在目录中
+  UnknownStation, // 站点不在目录中
+  NoSchedule,     // 列车没有时刻表
+  NotOnSchedule,  // 站点不在该列车的时刻表上
+  TimeMismatch    // 最近停站与记录小时相差超过容差
+};
+
+// 单条客流记录的匹配结果（分钟均为当日零点起的分钟数）
+struct ScheduleMatch {
+  JoinStatus status;
+  EntityHandle train;
+  EntityHandle station;
+  int stop;            // 停站序号，未匹配到停站为-1
+  int arrivalMinute;   // 到站时刻
+  int departureMinute; // 发车时刻（跨午夜时可能不小于1440）
+  int dwellMinutes;    // 停站时长
+  int travelMinutes;   // 自上一停站发车至本站到达，始发站为0
+  int offsetMinutes;   // 停站时段与记录所在小时的间隔，重叠为0
+
+  ScheduleMatch()
+      : status(JoinStatus::UnknownTrain), train(INVALID_HANDLE),
+        station(INVALID_HANDLE), stop(-1), arrivalMinute(0),
+        departureMinute(0), dwellMinutes(0), travelMinutes(0),
+        offsetMinutes(0) {}
+};
+
+// 各状态的记录数
+struct JoinSummary {
+  size_t matched;
+  size_t unknownTrain;
+  size_t unknownStation;
+  size_t noSchedule;
+  size_t notOnSchedule;
+  size_t timeMismatch;
+
+  JoinSummary()
+      : matched(0), unknownTrain(0), unknownStation(0), noSchedule(0),
+        notOnSchedule(0), timeMismatch(0) {}
+  size_t getTotal() const {
+    return matched + unknownTrain + unknownStation + noSchedule +
+           notOnSchedule + timeMismatch;
+  }
+};
+
+// 客流记录与列车时刻表的as-of连接。记录按列车分桶后，桶内按
+// (站点, 小时)排序，与该列车按(站点, 到站时刻)排序的停站归并：
+// 同一站点多次停靠时取不晚于记录小时结束时刻的最后一次到站，
+// 没有则取之后的第一次。解析句柄按记录分块并行，归并按列车并行
+class FlowScheduleJoin {
+private:
+  struct Stop {
+    EntityHandle station;
+    int arrival; // 当日分钟（已对1440取模）
+    int stop;    // 停站序号
+  };
+
+  std::shared_ptr<const EntityCatalog> catalog;
+  std::vector<std::vector<Stop>> trainStops; // 按列车句柄，按(站点, 到站)排序
+  int toleranceMinutes;
+
+public:
+  static constexpr int DEFAULT_TOLERANCE_MINUTES = 60;
+
+  // 构造函数（整理各列车停站）
+  explicit FlowScheduleJoin(std::shared_ptr<const EntityCatalog> entityCatalog,
+                            int tolerance = DEFAULT_TOLERANCE_MINUTES);
+
+  // 结果与records一一对应
+  std::vector<ScheduleMatch> join(const std::vector<FlowRecord> &records) const;
+  static JoinSummary summarize(const std::vector<ScheduleMatch> &matches);
+
+private:
+  void fillMatch(EntityHandle train, int stop, int hour,
+                 ScheduleMatch &match) const;
+};
+
+#endif // FLOWSCHEDULEJOIN_H
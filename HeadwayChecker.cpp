@@ -0,0 +1,297 @@
+#include "HeadwayChecker.h"
+#include "ParallelUtils.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <iomanip>
+#include <set>
+#include <sstream>
+#include <unordered_map>
+#include <utility>
+
+namespace {
+
+const int MINUTES_PER_DAY = 24 * 60;
+
+std::string formatMinute(int minute) {
+  std::ostringstream oss;
+  oss << std::setfill('0') << std::setw(2) << minute / 60 << ":"
+      << std::setw(2) << minute % 60;
+  return oss.str();
+}
+
+} // namespace
+
+const char *conflictTypeName(ConflictType type) {
+  switch (type) {
+  case ConflictType::Headway:
+    return "追踪间隔不足";
+  case ConflictType::Overtake:
+    return "区间越行";
+  case ConflictType::RunningTime:
+    return "运行时间不足";
+  }
+  return "未知";
+}
+
+size_t HeadwayReport::countOf(ConflictType type) const {
+  return static_cast<size_t>(
+      std::count_if(conflicts.begin(), conflicts.end(),
+                    [type](const ScheduleConflict &conflict) {
+                      return conflict.type == type;
+                    }));
+}
+
+std::string HeadwayReport::toString(const EntityCatalog &catalog,
+                                    size_t maxConflictLines) const {
+  std::ostringstream oss;
+  oss << "=== 时刻表冲突检查 ===\n";
+  oss << "区间" << segmentCount << "个，占用" << intervalCount << "次，冲突"
+      << conflicts.size() << "个\n";
+  for (ConflictType type : {ConflictType::Headway, ConflictType::Overtake,
+                            ConflictType::RunningTime}) {
+    size_t count = countOf(type);
+    if (count > 0) {
+      oss << "  " << conflictTypeName(type) << ": " << count << "\n";
+    }
+  }
+
+  size_t shown = std::min(maxConflictLines, conflicts.size());
+  if (shown > 0) {
+    oss << "冲突明细（前" << shown << "条）:\n";
+  }
+  for (size_t i = 0; i < shown; ++i) {
+    const auto &conflict = conflicts[i];
+    oss << "  " << formatMinute(conflict.minute) << " "
+        << catalog.getStation(conflict.fromStation)->getStationName() << "-"
+        << catalog.getStation(conflict.toStation)->getStationName() << " "
+        << conflictTypeName(conflict.type) << ": "
+        << catalog.getTrain(conflict.train)->getTrainId();
+    if (conflict.otherTrain != INVALID_HANDLE) {
+      oss << "/" << catalog.getTrain(conflict.otherTrain)->getTrainId();
+    }
+    oss << " " << conflict.value << "分钟";
+    if (conflict.type != ConflictType::Overtake) {
+      oss << "（下限" << conflict.limit << "）";
+    }
+    oss << "\n";
+  }
+  oss << "耗时: " << elapsedMs << " ms\n";
+  return oss.str();
+}
+
+// 构造函数
+HeadwayChecker::HeadwayChecker(
+    std::shared_ptr<const EntityCatalog> entityCatalog, int minHeadway)
+    : catalog(entityCatalog ? entityCatalog : EntityCatalog::empty()),
+      minHeadwayMinutes(minHeadway) {}
+
+HeadwayReport HeadwayChecker::check() const {
+  auto startTime = std::chrono::steady_clock::now();
+  HeadwayReport report;
+
+  // 生成各有向区间的占用时段，同时检查区间运行时间
+  std::unordered_map<long long, int> segmentIds;
+  std::vector<std::pair<EntityHandle, EntityHandle>> segmentStations;
+  std::vector<Occupancy> occupancies;
+  for (EntityHandle train = 0; train < catalog->getTrainCount(); ++train) {
+    const auto &trainPtr = catalog->getTrain(train);
+    const auto &schedule = trainPtr->getSchedule();
+    const auto &route = trainPtr->getRoute();
+    double speedLimit =
+        route ? route->getMaxSpeed() * SPEED_TOLERANCE : 0.0;
+
+    size_t previous = schedule.size();
+    EntityHandle previousStation = INVALID_HANDLE;
+    for (size_t i = 0; i < schedule.size(); ++i) {
+      EntityHandle station = catalog->getStationHandle(schedule[i].stationId);
+      if (station == INVALID_HANDLE) {
+        continue;
+      }
+      if (previousStation != INVALID_HANDLE && previousStation != station) {
+        int enter = trainPtr->getDepartureMinute(previous);
+        int run = trainPtr->getArrivalMinute(i) - enter;
+        enter %= MINUTES_PER_DAY;
+
+        long long key =
+            (static_cast<long long>(previousStation) << 32) |
+            static_cast<unsigned int>(station);
+        auto inserted = segmentIds.emplace(
+            key, static_cast<int>(segmentStations.size()));
+        if (inserted.second) {
+          segmentStations.emplace_back(previousStation, station);
+        }
+        occupancies.push_back(
+            {inserted.first->second, train, enter, enter + run, false});
+
+        // 相邻停站均在线路上时取沿线里程，否则取球面距离
+        if (speedLimit > 0) {
+          int fromIndex =
+              route->getStationIndex(schedule[previous].stationId);
+          int toIndex = route->getStationIndex(schedule[i].stationId);
+          double distance =
+              (fromIndex >= 0 && toIndex >= 0)
+                  ? std::abs(route->getCumulativeDistance(toIndex) -
+                             route->getCumulativeDistance(fromIndex))
+                  : catalog->getStation(previousStation)
+                        ->distanceTo(*catalog->getStation(station));
+          double minMinutes = distance / speedLimit * 60.0;
+          if (run < minMinutes) {
+            report.conflicts.push_back({ConflictType::RunningTime,
+                                        previousStation, station, train,
+                                        INVALID_HANDLE, enter,
+                                        static_cast<double>(run), minMinutes});
+          }
+        }
+      }
+      previous = i;
+      previousStation = station;
+    }
+  }
+  report.segmentCount = segmentStations.size();
+  report.intervalCount = occupancies.size();
+
+  // 按区间计数排序分组
+  size_t segmentCount = segmentStations.size();
+  std::vector<size_t> offsets(segmentCount + 1, 0);
+  for (const auto &occupancy : occupancies) {
+    offsets[occupancy.segment + 1]++;
+  }
+  for (size_t s = 0; s < segmentCount; ++s) {
+    offsets[s + 1] += offsets[s];
+  }
+  std::vector<Occupancy> grouped(occupancies.size());
+  std::vector<size_t> cursor(offsets.begin(), offsets.end() - 1);
+  for (const auto &occupancy : occupancies) {
+    grouped[cursor[occupancy.segment]++] = occupancy;
+  }
+
+  // 区间由各工作线程动态领取
+  unsigned workers = parallelWorkerCount(segmentCount, 16);
+  std::vector<std::vector<ScheduleConflict>> partial(workers);
+  std::atomic<size_t> next(0);
+  parallelFor(workers, [&](size_t, size_t, unsigned worker) {
+    std::vector<Occupancy> intervals;
+    for (size_t s = next++; s < segmentCount; s = next++) {
+      intervals.assign(grouped.begin() + offsets[s],
+                       grouped.begin() + offsets[s + 1]);
+      checkSegment(intervals, segmentStations[s].first,
+                   segmentStations[s].second, partial[worker]);
+    }
+  });
+
+  for (const auto &local : partial) {
+    report.conflicts.insert(report.conflicts.end(), local.begin(),
+                            local.end());
+  }
+  std::sort(report.conflicts.begin(), report.conflicts.end(),
+            [](const ScheduleConflict &a, const ScheduleConflict &b) {
+              if (a.fromStation != b.fromStation) {
+                return a.fromStation < b.fromStation;
+              }
+              if (a.toStation != b.toStation) {
+                return a.toStation < b.toStation;
+              }
+              if (a.minute != b.minute) {
+                return a.minute < b.minute;
+              }
+              if (a.type != b.type) {
+                return a.type < b.type;
+              }
+              return a.train != b.train ? a.train < b.train
+                                        : a.otherTrain < b.otherTrain;
+            });
+
+  report.elapsedMs = std::chrono::duration<double, std::milli>(
+                         std::chrono::steady_clock::now() - startTime)
+                         .count();
+  return report;
+}
+
+// 只报告先进入区间的一方为原始占用的列车对，跨日副本之间的比较不重复报告
+void HeadwayChecker::checkSegment(
+    std::vector<Occupancy> &intervals, EntityHandle from, EntityHandle to,
+    std::vector<ScheduleConflict> &conflicts) const {
+  // 次日凌晨进入、可能与当日深夜列车冲突的占用平移一天作为副本
+  int window = minHeadwayMinutes;
+  for (const auto &interval : intervals) {
+    window = std::max(window, interval.exit - interval.enter + minHeadwayMinutes);
+  }
+  size_t originalCount = intervals.size();
+  for (size_t i = 0; i < originalCount; ++i) {
+    if (intervals[i].enter < window) {
+      Occupancy shifted = intervals[i];
+      shifted.enter += MINUTES_PER_DAY;
+      shifted.exit += MINUTES_PER_DAY;
+      shifted.copy = true;
+      intervals.push_back(shifted);
+    }
+  }
+  std::sort(intervals.begin(), intervals.end(),
+            [](const Occupancy &a, const Occupancy &b) {
+              if (a.enter != b.enter) {
+                return a.enter < b.enter;
+              }
+              return a.exit != b.exit ? a.exit < b.exit : a.train < b.train;
+            });
+
+  auto report = [&](ConflictType type, const Occupancy &first,
+                    const Occupancy &second, double value, double limit) {
+    conflicts.push_back({type, from, to, first.train, second.train,
+                         first.enter, value, limit});
+  };
+
+  // 相邻进入
+  std::vector<char> entryFlagged(intervals.size(), 0);
+  for (size_t i = 0; i + 1 < intervals.size(); ++i) {
+    int gap = intervals[i + 1].enter - intervals[i].enter;
+    if (gap < minHeadwayMinutes && !intervals[i].copy) {
+      report(ConflictType::Headway, intervals[i], intervals[i + 1], gap,
+             minHeadwayMinutes);
+      entryFlagged[i] = 1;
+    }
+  }
+
+  // 相邻离开：进入顺序颠倒的列车对属于越行，已在进入端报告的不再重复
+  std::vector<size_t> byExit(intervals.size());
+  for (size_t i = 0; i < byExit.size(); ++i) {
+    byExit[i] = i;
+  }
+  std::sort(byExit.begin(), byExit.end(), [&intervals](size_t a, size_t b) {
+    return intervals[a].exit != intervals[b].exit
+               ? intervals[a].exit < intervals[b].exit
+               : a < b;
+  });
+  for (size_t k = 0; k + 1 < byExit.size(); ++k) {
+    size_t first = byExit[k];
+    size_t second = byExit[k + 1];
+    int gap = intervals[second].exit - intervals[first].exit;
+    if (gap >= minHeadwayMinutes || first > second ||
+        intervals[first].copy ||
+        (second == first + 1 && entryFlagged[first])) {
+      continue;
+    }
+    report(ConflictType::Headway, intervals[first], intervals[second], gap,
+           minHeadwayMinutes);
+  }
+
+  // 扫描线：在途列车按离开时刻排序，新进入的列车先于其离开则构成越行
+  std::multiset<std::pair<int, size_t>> active;
+  for (size_t i = 0; i < intervals.size(); ++i) {
+    const Occupancy &current = intervals[i];
+    while (!active.empty() && active.begin()->first <= current.enter) {
+      active.erase(active.begin());
+    }
+    for (auto it = active.upper_bound({current.exit, SIZE_MAX});
+         it != active.end(); ++it) {
+      const Occupancy &overtaken = intervals[it->second];
+      if (!overtaken.copy) {
+        report(ConflictType::Overtake, overtaken, current,
+               overtaken.exit - current.exit, 0.0);
+      }
+    }
+    active.emplace(current.exit, i);
+  }
+}
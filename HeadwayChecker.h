@@ -0,0 +1,79 @@
+#ifndef HEADWAYCHECKER_H
+#define HEADWAYCHECKER_H
+
+#include "EntityCatalog.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+// 时刻表冲突类型
+enum class ConflictType {
+  Headway,    // 同向相邻两列车进入或离开区间的间隔小于最小追踪间隔
+  Overtake,   // 后进入区间的列车先离开（区间内越行）
+  RunningTime // 区间运行时间短于按线路最高速度所需的时间
+};
+
+const char *conflictTypeName(ConflictType type);
+
+// 单个冲突（分钟为当日零点起的分钟数）
+struct ScheduleConflict {
+  ConflictType type;
+  EntityHandle fromStation; // 区间按运行方向
+  EntityHandle toStation;
+  EntityHandle train;      // 先进入区间的列车
+  EntityHandle otherTrain; // 另一列车，RunningTime为INVALID_HANDLE
+  int minute;              // train进入区间的时刻
+  double value; // Headway：间隔分钟；Overtake：被越行列车多占用的分钟；
+                // RunningTime：实际运行分钟
+  double limit; // 对应的下限（最小间隔或最短运行分钟），Overtake为0
+};
+
+// 检查报告
+struct HeadwayReport {
+  std::vector<ScheduleConflict> conflicts; // 按区间、时刻排序
+  size_t segmentCount;  // 有列车占用的有向区间数
+  size_t intervalCount; // 区间占用次数
+  double elapsedMs;
+
+  HeadwayReport() : segmentCount(0), intervalCount(0), elapsedMs(0.0) {}
+  size_t countOf(ConflictType type) const;
+  std::string toString(const EntityCatalog &catalog,
+                       size_t maxConflictLines = 50) const;
+};
+
+// 时刻表追踪间隔与越行检查：由全部列车时刻表生成各有向区间的占用
+// 时段（自发车至下一站到达），按区间分组后并行扫描。每个区间按进入
+// 时刻排序，相邻进入、相邻离开之间检查追踪间隔；扫描线维护按离开
+// 时刻排序的在途列车，新列车进入时离开更晚的在途列车即被越行。
+// 时刻表按日循环，跨午夜的占用与次日凌晨的列车同样比较
+class HeadwayChecker {
+private:
+  std::shared_ptr<const EntityCatalog> catalog;
+  int minHeadwayMinutes;
+
+public:
+  static constexpr int DEFAULT_MIN_HEADWAY_MINUTES = 3;
+  static constexpr double SPEED_TOLERANCE = 1.1; // 允许超出最高速度的比例
+
+  // 构造函数
+  explicit HeadwayChecker(std::shared_ptr<const EntityCatalog> entityCatalog,
+                          int minHeadway = DEFAULT_MIN_HEADWAY_MINUTES);
+
+  HeadwayReport check() const;
+
+private:
+  struct Occupancy {
+    int segment;
+    EntityHandle train;
+    int enter; // 当日分钟，[0, 1440)
+    int exit;  // enter加运行分钟
+    bool copy; // 为比较跨日而平移一天的副本
+  };
+
+  // intervals为同一区间的占用（不含副本），冲突追加到conflicts
+  void checkSegment(std::vector<Occupancy> &intervals, EntityHandle from,
+                    EntityHandle to,
+                    std::vector<ScheduleConflict> &conflicts) const;
+};
+
+#endif // HEADWAYCHECKER_H
@@ -0,0 +1,149 @@
+#include "IsochroneIndex.h"
+#include "ParallelUtils.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <limits>
+
+// 构造函数
+IsochroneIndex::IsochroneIndex(
+    std::shared_ptr<const EntityCatalog> entityCatalog,
+    std::vector<int> bandMinutes)
+    : catalog(entityCatalog ? entityCatalog : EntityCatalog::empty()),
+      bands(std::move(bandMinutes)), wordsPerRow(0), mode(Mode::None),
+      departureMinute(0), elapsedMs(0.0) {
+  if (bands.empty()) {
+    bands = {60, 120, 180};
+  }
+  std::sort(bands.begin(), bands.end());
+  bands.erase(std::unique(bands.begin(), bands.end()), bands.end());
+}
+
+void IsochroneIndex::computeStatic(const RailNetwork &network) {
+  double horizon = bands.back();
+  computeAll(Mode::Static, [&](EntityHandle source,
+                               std::vector<double> &minutes) {
+    thread_local DijkstraWorkspace workspace;
+    network.shortestPathTree(source, PathMetric::Time, workspace, horizon);
+    for (size_t s = 0; s < minutes.size(); ++s) {
+      minutes[s] = workspace.distanceTo(static_cast<int>(s));
+    }
+  });
+}
+
+void IsochroneIndex::computeTimetable(const JourneyPlanner &planner,
+                                      int departure) {
+  departureMinute = departure;
+  int horizon = bands.back();
+  computeAll(Mode::Timetable, [&](EntityHandle source,
+                                  std::vector<double> &minutes) {
+    thread_local std::vector<int> arrival;
+    planner.earliestArrivals(source, departure, arrival, horizon);
+    for (size_t s = 0; s < minutes.size(); ++s) {
+      minutes[s] = (s < arrival.size() &&
+                    arrival[s] != JourneyPlanner::UNREACHABLE)
+                       ? arrival[s] - departure
+                       : std::numeric_limits<double>::infinity();
+    }
+  });
+}
+
+void IsochroneIndex::computeAll(
+    Mode computedMode,
+    const std::function<void(EntityHandle, std::vector<double> &)> &search) {
+  auto startTime = std::chrono::steady_clock::now();
+  size_t stationCount = catalog->getStationCount();
+  wordsPerRow = (stationCount + 63) / 64;
+  bits.assign(stationCount * bands.size() * wordsPerRow, 0);
+  counts.assign(stationCount * bands.size(), 0);
+
+  // 起点的搜索范围差异很大，由工作线程动态领取；各起点只写自己的行
+  std::atomic<size_t> next(0);
+  parallelFor(parallelWorkerCount(stationCount, 16),
+              [&](size_t, size_t, unsigned) {
+                std::vector<double> minutes(stationCount);
+                for (size_t s = next++; s < stationCount; s = next++) {
+                  search(static_cast<EntityHandle>(s), minutes);
+                  fillRows(static_cast<EntityHandle>(s), minutes);
+                }
+              });
+
+  mode = computedMode;
+  elapsedMs = std::chrono::duration<double, std::milli>(
+                  std::chrono::steady_clock::now() - startTime)
+                  .count();
+}
+
+void IsochroneIndex::fillRows(EntityHandle source,
+                              const std::vector<double> &minutes) {
+  size_t bandCount = bands.size();
+  size_t firstRow = static_cast<size_t>(source) * bandCount;
+  double horizon = bands.back();
+  for (size_t s = 0; s < minutes.size(); ++s) {
+    if (!(minutes[s] <= horizon)) {
+      continue;
+    }
+    // 所在的最小档位及更大的档位均置位
+    auto band = std::lower_bound(bands.begin(), bands.end(), minutes[s]) -
+                bands.begin();
+    for (size_t b = static_cast<size_t>(band); b < bandCount; ++b) {
+      bits[(firstRow + b) * wordsPerRow + s / 64] |= uint64_t(1) << (s % 64);
+      counts[firstRow + b]++;
+    }
+  }
+}
+
+const uint64_t *IsochroneIndex::getBits(EntityHandle source, int band) const {
+  if (mode == Mode::None || source < 0 ||
+      source >= catalog->getStationCount() || band < 0 ||
+      band >= getBandCount()) {
+    return nullptr;
+  }
+  return bits.data() +
+         (static_cast<size_t>(source) * bands.size() + band) * wordsPerRow;
+}
+
+bool IsochroneIndex::isReachable(EntityHandle source, EntityHandle target,
+                                 int band) const {
+  const uint64_t *row = getBits(source, band);
+  if (!row || target < 0 || target >= catalog->getStationCount()) {
+    return false;
+  }
+  return (row[target / 64] >> (target % 64)) & 1;
+}
+
+int IsochroneIndex::bandOf(EntityHandle source, EntityHandle target) const {
+  for (int band = 0; band < getBandCount(); ++band) {
+    if (isReachable(source, target, band)) {
+      return band;
+    }
+  }
+  return -1;
+}
+
+int IsochroneIndex::countReachable(EntityHandle source, int band) const {
+  if (!getBits(source, band)) {
+    return 0;
+  }
+  return counts[static_cast<size_t>(source) * bands.size() + band];
+}
+
+std::vector<EntityHandle> IsochroneIndex::getReachable(EntityHandle source,
+                                                       int band) const {
+  std::vector<EntityHandle> result;
+  const uint64_t *row = getBits(source, band);
+  if (!row) {
+    return result;
+  }
+  result.reserve(countReachable(source, band));
+  for (size_t w = 0; w < wordsPerRow; ++w) {
+    for (uint64_t word = row[w]; word != 0; word &= word - 1) {
+      int bit = 0;
+      while (!((word >> bit) & 1)) {
+        ++bit;
+      }
+      result.push_back(static_cast<EntityHandle>(w * 64 + bit));
+    }
+  }
+  return result;
+}
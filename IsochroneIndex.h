@@ -0,0 +1,66 @@
+#ifndef ISOCHRONEINDEX_H
+#define ISOCHRONEINDEX_H
+
+#include "EntityCatalog.h"
+#include "JourneyPlanner.h"
+#include "RailNetwork.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// 全部站点的等时圈：对每个起点记录各时长档内可达的站点集合。
+// 静态模式按路网典型运行时间做截断Dijkstra，时刻表模式按给定出发
+// 时刻做截断的最早到达扫描；起点之间相互独立，整批并行计算。
+// 结果按(起点, 档位)存为站点位图，档位内含更短档位的站点，
+// 查询某站是否可达只需一次位运算
+class IsochroneIndex {
+public:
+  enum class Mode { None, Static, Timetable };
+
+private:
+  std::shared_ptr<const EntityCatalog> catalog;
+  std::vector<int> bands;     // 各档时长（分钟），升序
+  size_t wordsPerRow;         // 每个位图的64位字数
+  std::vector<uint64_t> bits; // 第(source * 档数 + band)行
+  std::vector<int> counts;    // 各行的站点数
+  Mode mode;
+  int departureMinute; // 时刻表模式的出发时刻
+  double elapsedMs;
+
+public:
+  // 构造函数；bandMinutes为空时使用60/120/180分钟
+  explicit IsochroneIndex(std::shared_ptr<const EntityCatalog> entityCatalog,
+                          std::vector<int> bandMinutes = {});
+
+  // 按路网区间的典型运行时间（network须由同一目录构建）
+  void computeStatic(const RailNetwork &network);
+  // 按时刻表自departure出发的最早到达（planner须由同一目录构建）
+  void computeTimetable(const JourneyPlanner &planner, int departure);
+
+  Mode getMode() const { return mode; }
+  int getDepartureMinute() const { return departureMinute; }
+  double getElapsedMs() const { return elapsedMs; }
+  const std::vector<int> &getBands() const { return bands; }
+  int getBandCount() const { return static_cast<int>(bands.size()); }
+  size_t getMemoryBytes() const { return bits.size() * sizeof(uint64_t); }
+
+  // 未计算或参数越界时均视为不可达
+  bool isReachable(EntityHandle source, EntityHandle target, int band) const;
+  // target所在的最小档位，不在任何档位内返回-1
+  int bandOf(EntityHandle source, EntityHandle target) const;
+  int countReachable(EntityHandle source, int band) const;
+  std::vector<EntityHandle> getReachable(EntityHandle source, int band) const;
+  // 位图（wordsPerRow个字），未计算时返回nullptr
+  const uint64_t *getBits(EntityHandle source, int band) const;
+  size_t getWordsPerRow() const { return wordsPerRow; }
+
+private:
+  // search(source, minutes)填写各站自起点的用时，不可达为无穷大
+  void computeAll(
+      Mode computedMode,
+      const std::function<void(EntityHandle, std::vector<double> &)> &search);
+  void fillRows(EntityHandle source, const std::vector<double> &minutes);
+};
+
+#endif // ISOCHRONEINDEX_H
@@ -0,0 +1,201 @@
+#include "JourneyPlanner.h"
+#include "ParallelUtils.h"
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+const int NOT_REACHED = std::numeric_limits<int>::max();
+
+} // namespace
+
+// 构造函数：展开各列车时刻表为区间连接并按发车时刻排序
+JourneyPlanner::JourneyPlanner(
+    std::shared_ptr<const EntityCatalog> entityCatalog,
+    int transferStationMinutes, int ordinaryStationMinutes)
+    : catalog(entityCatalog ? entityCatalog : EntityCatalog::empty()) {
+  transferMinutes.reserve(catalog->getStationCount());
+  for (EntityHandle station = 0; station < catalog->getStationCount();
+       ++station) {
+    transferMinutes.push_back(catalog->isTransferStation(station)
+                                  ? transferStationMinutes
+                                  : ordinaryStationMinutes);
+  }
+  cancelled.assign(catalog->getTrainCount(), 0);
+
+  for (EntityHandle train = 0; train < catalog->getTrainCount(); ++train) {
+    const auto &trainPtr = catalog->getTrain(train);
+    const auto &schedule = trainPtr->getSchedule();
+    EntityHandle previous = INVALID_HANDLE;
+    size_t previousIndex = 0;
+    for (size_t i = 0; i < schedule.size(); ++i) {
+      EntityHandle station = catalog->getStationHandle(schedule[i].stationId);
+      if (station == INVALID_HANDLE) {
+        continue;
+      }
+      if (previous != INVALID_HANDLE && previous != station) {
+        connections.push_back({previous, station,
+                               trainPtr->getDepartureMinute(previousIndex),
+                               trainPtr->getArrivalMinute(i), train});
+      }
+      previous = station;
+      previousIndex = i;
+    }
+  }
+
+  std::sort(connections.begin(), connections.end(),
+            [](const Connection &a, const Connection &b) {
+              if (a.departureMinute != b.departureMinute) {
+                return a.departureMinute < b.departureMinute;
+              }
+              return a.arrivalMinute < b.arrivalMinute;
+            });
+}
+
+// 停运设置
+bool JourneyPlanner::setTrainCancelled(const std::string &trainId,
+                                       bool isCancelled) {
+  EntityHandle train = catalog->getTrainHandle(trainId);
+  if (train == INVALID_HANDLE) {
+    return false;
+  }
+  cancelled[train] = isCancelled ? 1 : 0;
+  return true;
+}
+
+void JourneyPlanner::clearCancellations() {
+  std::fill(cancelled.begin(), cancelled.end(), 0);
+}
+
+// Connection Scan主循环
+void JourneyPlanner::scan(EntityHandle source, EntityHandle target,
+                          int departureMinute, std::vector<int> &arrival,
+                          std::vector<int> &boardable,
+                          std::vector<JourneyPointer> *journeyPointers,
+                          std::vector<int> &tripEntry,
+                          int latestDeparture) const {
+  arrival.assign(transferMinutes.size(), NOT_REACHED);
+  boardable.assign(transferMinutes.size(), NOT_REACHED);
+  tripEntry.assign(cancelled.size(), -1);
+  if (journeyPointers) {
+    journeyPointers->assign(transferMinutes.size(), {-1, -1});
+  }
+  arrival[source] = departureMinute;
+  boardable[source] = departureMinute;
+
+  auto first = std::lower_bound(
+      connections.begin(), connections.end(), departureMinute,
+      [](const Connection &c, int minute) {
+        return c.departureMinute < minute;
+      });
+  for (auto it = first; it != connections.end(); ++it) {
+    const Connection &c = *it;
+    // 之后的连接不可能更早到达目标
+    if (target != INVALID_HANDLE && c.departureMinute >= arrival[target]) {
+      break;
+    }
+    if (c.departureMinute > latestDeparture) {
+      break;
+    }
+    if (cancelled[c.train]) {
+      continue;
+    }
+    // 未在车上时须能在发车前到达并完成换乘
+    if (tripEntry[c.train] < 0) {
+      if (boardable[c.departureStation] > c.departureMinute) {
+        continue;
+      }
+      tripEntry[c.train] = static_cast<int>(it - connections.begin());
+    }
+    if (c.arrivalMinute < arrival[c.arrivalStation]) {
+      arrival[c.arrivalStation] = c.arrivalMinute;
+      if (journeyPointers) {
+        (*journeyPointers)[c.arrivalStation] = {
+            tripEntry[c.train], static_cast<int>(it - connections.begin())};
+      }
+    }
+    int change = transferMinutes[c.arrivalStation];
+    if (change >= 0 && c.arrivalMinute + change < boardable[c.arrivalStation]) {
+      boardable[c.arrivalStation] = c.arrivalMinute + change;
+    }
+  }
+}
+
+void JourneyPlanner::earliestArrivals(EntityHandle source, int departureMinute,
+                                      std::vector<int> &arrival,
+                                      int maxTravelMinutes) const {
+  if (source < 0 || source >= static_cast<int>(transferMinutes.size())) {
+    arrival.assign(transferMinutes.size(), UNREACHABLE);
+    return;
+  }
+  std::vector<int> boardable, tripEntry;
+  scan(source, INVALID_HANDLE, departureMinute, arrival, boardable, nullptr,
+       tripEntry,
+       maxTravelMinutes >= 0 ? departureMinute + maxTravelMinutes : INT_MAX);
+  for (auto &minute : arrival) {
+    if (minute == NOT_REACHED) {
+      minute = UNREACHABLE;
+    }
+  }
+}
+
+Journey JourneyPlanner::planJourney(EntityHandle source, EntityHandle target,
+                                    int departureMinute) const {
+  Journey journey;
+  journey.departureMinute = departureMinute;
+  int stationCount = static_cast<int>(transferMinutes.size());
+  if (source < 0 || source >= stationCount || target < 0 ||
+      target >= stationCount) {
+    return journey;
+  }
+
+  std::vector<int> arrival, boardable, tripEntry;
+  std::vector<JourneyPointer> pointers;
+  scan(source, target, departureMinute, arrival, boardable, &pointers,
+       tripEntry);
+  if (arrival[target] == NOT_REACHED) {
+    return journey;
+  }
+
+  // 自目标回溯：每站记录的上车、下车连接给出一段乘车
+  EntityHandle station = target;
+  while (station != source && journey.legs.size() <= cancelled.size()) {
+    const Connection &exit = connections[pointers[station].exit];
+    const Connection &entry = connections[pointers[station].entry];
+    journey.legs.push_back({exit.train, entry.departureStation,
+                            exit.arrivalStation, entry.departureMinute,
+                            exit.arrivalMinute});
+    station = entry.departureStation;
+  }
+  std::reverse(journey.legs.begin(), journey.legs.end());
+  journey.found = true;
+  journey.arrivalMinute = arrival[target];
+  return journey;
+}
+
+Journey JourneyPlanner::planJourney(const std::string &fromStationId,
+                                    const std::string &toStationId,
+                                    const TimePoint &departureTime) const {
+  return planJourney(catalog->getStationHandle(fromStationId),
+                     catalog->getStationHandle(toStationId),
+                     departureTime.toMinutes());
+}
+
+std::vector<std::vector<int>>
+JourneyPlanner::travelTimeMatrix(const std::vector<EntityHandle> &sources,
+                                 int departureMinute) const {
+  std::vector<std::vector<int>> matrix(sources.size());
+  parallelFor(sources.size(), [&](size_t begin, size_t end, unsigned) {
+    std::vector<int> arrival;
+    for (size_t i = begin; i < end; ++i) {
+      earliestArrivals(sources[i], departureMinute, arrival);
+      std::vector<int> &row = matrix[i];
+      row.resize(arrival.size());
+      for (size_t j = 0; j < arrival.size(); ++j) {
+        row[j] = (arrival[j] == UNREACHABLE) ? UNREACHABLE
+                                             : arrival[j] - departureMinute;
+      }
+    }
+  });
+  return matrix;
+}
@@ -0,0 +1,108 @@
+#ifndef JOURNEYPLANNER_H
+#define JOURNEYPLANNER_H
+
+#include "EntityCatalog.h"
+#include <climits>
+#include <memory>
+#include <string>
+#include <vector>
+
+// 列车区间连接（相邻两个停站之间的一段运行）
+struct Connection {
+  EntityHandle departureStation;
+  EntityHandle arrivalStation;
+  int departureMinute; // 自运营日零点起的累计分钟（跨日可超过1440）
+  int arrivalMinute;
+  EntityHandle train;
+};
+
+// 行程中乘坐同一列车的一段
+struct JourneyLeg {
+  EntityHandle train;
+  EntityHandle fromStation;
+  EntityHandle toStation;
+  int departureMinute;
+  int arrivalMinute;
+};
+
+// 最早到达行程
+struct Journey {
+  bool found;
+  int departureMinute; // 查询的出发时刻
+  int arrivalMinute;
+  std::vector<JourneyLeg> legs;
+
+  Journey() : found(false), departureMinute(0), arrivalMinute(0) {}
+  int getTravelMinutes() const { return arrivalMinute - departureMinute; }
+  int getTransferCount() const {
+    return legs.empty() ? 0 : static_cast<int>(legs.size()) - 1;
+  }
+};
+
+// 基于全部列车时刻表的最早到达规划（Connection Scan算法）。
+// 时刻为单一运营日内的累计分钟；换乘须满足车站的最短换乘时间
+class JourneyPlanner {
+private:
+  // 到达某站最早时刻对应的一段乘车：上车连接与下车连接的序号，
+  // 在最早到达时刻改进的同时记录
+  struct JourneyPointer {
+    int entry;
+    int exit;
+  };
+
+  std::shared_ptr<const EntityCatalog> catalog;
+  std::vector<Connection> connections; // 按发车时刻排序
+  std::vector<int> transferMinutes;    // 各站最短换乘时间，负数表示不可换乘
+  std::vector<char> cancelled;         // 按列车句柄标记停运
+
+public:
+  static constexpr int UNREACHABLE = -1;
+  static constexpr int DEFAULT_TRANSFER_MINUTES = 10; // 换乘站
+  static constexpr int DEFAULT_ORDINARY_MINUTES = 20; // 非换乘站
+
+  // 由目录中所有列车的时刻表构建；时刻表中不在目录内的站点被跳过
+  explicit JourneyPlanner(
+      std::shared_ptr<const EntityCatalog> entityCatalog,
+      int transferStationMinutes = DEFAULT_TRANSFER_MINUTES,
+      int ordinaryStationMinutes = DEFAULT_ORDINARY_MINUTES);
+
+  const std::vector<Connection> &getConnections() const { return connections; }
+  int getTransferMinutes(EntityHandle station) const {
+    return transferMinutes[station];
+  }
+
+  // 停运设置（用于“取消某车次”的假设分析）
+  bool setTrainCancelled(const std::string &trainId, bool isCancelled = true);
+  void clearCancellations();
+  bool isTrainCancelled(EntityHandle train) const { return cancelled[train]; }
+
+  // 单源最早到达：arrival[i]为到达站点i的最早时刻，不可达为UNREACHABLE。
+  // maxTravelMinutes非负时只扫描出发后该时长内发车的连接，更晚到达的站点
+  // 可能记为UNREACHABLE
+  void earliestArrivals(EntityHandle source, int departureMinute,
+                        std::vector<int> &arrival,
+                        int maxTravelMinutes = -1) const;
+
+  // 点对点行程（含各段乘车信息）
+  Journey planJourney(EntityHandle source, EntityHandle target,
+                      int departureMinute) const;
+  Journey planJourney(const std::string &fromStationId,
+                      const std::string &toStationId,
+                      const TimePoint &departureTime) const;
+
+  // 批量单源：对每个起点并行计算到所有站点的旅行时间（分钟），
+  // 不可达为UNREACHABLE，用于可达性矩阵
+  std::vector<std::vector<int>>
+  travelTimeMatrix(const std::vector<EntityHandle> &sources,
+                   int departureMinute) const;
+
+private:
+  // 扫描连接；tripEntry记录各列车的上车连接，journeyPointers非空时记录
+  // 到达各站的最后一段乘车。latestDeparture之后发车的连接不再扫描
+  void scan(EntityHandle source, EntityHandle target, int departureMinute,
+            std::vector<int> &arrival, std::vector<int> &boardable,
+            std::vector<JourneyPointer> *journeyPointers,
+            std::vector<int> &tripEntry, int latestDeparture = INT_MAX) const;
+};
+
+#endif // JOURNEYPLANNER_H
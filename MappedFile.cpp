@@ -0,0 +1,159 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// 构造函数
+MappedFile::MappedFile()
+    : mappedData(nullptr), mappedSize(0),
+#ifdef _WIN32
+      fileHandle(INVALID_HANDLE_VALUE), mappingHandle(nullptr)
+#else
+      fileDescriptor(-1)
+#endif
+{
+}
+
+MappedFile::MappedFile(const std::string &path, Access access)
+    : MappedFile() {
+  open(path, access);
+}
+
+// 析构函数
+MappedFile::~MappedFile() { close(); }
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string &path, Access access) {
+  close();
+
+  // 路径按UTF-8处理，转换为宽字符以支持中文文件名
+  int wideLength =
+      MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+  std::wstring widePath(wideLength > 0 ? wideLength : 0, L'\0');
+  if (wideLength > 0) {
+    MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, &widePath[0],
+                        wideLength);
+  }
+
+  DWORD flags = FILE_ATTRIBUTE_NORMAL;
+  if (access == Access::Sequential) {
+    flags |= FILE_FLAG_SEQUENTIAL_SCAN;
+  } else if (access == Access::Random) {
+    flags |= FILE_FLAG_RANDOM_ACCESS;
+  }
+  HANDLE file = CreateFileW(widePath.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                            nullptr, OPEN_EXISTING, flags, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    lastError = "无法打开文件: " + path;
+    return false;
+  }
+  fileHandle = file;
+
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(file, &fileSize)) {
+    lastError = "无法获取文件大小: " + path;
+    close();
+    return false;
+  }
+  mappedSize = static_cast<size_t>(fileSize.QuadPart);
+  if (mappedSize == 0) {
+    return true;
+  }
+
+  HANDLE mapping =
+      CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (mapping == nullptr) {
+    lastError = "无法创建文件映射: " + path;
+    close();
+    return false;
+  }
+  mappingHandle = mapping;
+
+  mappedData = static_cast<const char *>(
+      MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+  if (mappedData == nullptr) {
+    lastError = "无法映射文件: " + path;
+    close();
+    return false;
+  }
+  return true;
+}
+
+void MappedFile::close() {
+  if (mappedData != nullptr) {
+    UnmapViewOfFile(mappedData);
+    mappedData = nullptr;
+  }
+  if (mappingHandle != nullptr) {
+    CloseHandle(static_cast<HANDLE>(mappingHandle));
+    mappingHandle = nullptr;
+  }
+  if (fileHandle != INVALID_HANDLE_VALUE) {
+    CloseHandle(static_cast<HANDLE>(fileHandle));
+    fileHandle = INVALID_HANDLE_VALUE;
+  }
+  mappedSize = 0;
+}
+
+bool MappedFile::isOpen() const { return fileHandle != INVALID_HANDLE_VALUE; }
+
+#else
+
+bool MappedFile::open(const std::string &path, Access access) {
+  close();
+
+  fileDescriptor = ::open(path.c_str(), O_RDONLY);
+  if (fileDescriptor < 0) {
+    lastError = "无法打开文件: " + path;
+    return false;
+  }
+
+  struct stat info;
+  if (fstat(fileDescriptor, &info) != 0) {
+    lastError = "无法获取文件大小: " + path;
+    close();
+    return false;
+  }
+  mappedSize = static_cast<size_t>(info.st_size);
+  if (mappedSize == 0) {
+    return true;
+  }
+
+  void *address =
+      mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+  if (address == MAP_FAILED) {
+    lastError = "无法映射文件: " + path;
+    close();
+    return false;
+  }
+  if (access == Access::Sequential) {
+    madvise(address, mappedSize, MADV_SEQUENTIAL);
+  } else if (access == Access::Random) {
+    madvise(address, mappedSize, MADV_RANDOM);
+  }
+  mappedData = static_cast<const char *>(address);
+  return true;
+}
+
+void MappedFile::close() {
+  if (mappedData != nullptr) {
+    munmap(const_cast<char *>(mappedData), mappedSize);
+    mappedData = nullptr;
+  }
+  if (fileDescriptor >= 0) {
+    ::close(fileDescriptor);
+    fileDescriptor = -1;
+  }
+  mappedSize = 0;
+}
+
+bool MappedFile::isOpen() const { return fileDescriptor >= 0; }
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+// 只读内存映射文件（POSIX使用mmap，Windows使用CreateFileMapping）
+class MappedFile {
+public:
+  // 访问模式提示：整体顺序扫描用Sequential（内核加大预读），按偏移随机
+  // 查找用Random（关闭预读，避免读入用不到的页）
+  enum class Access { Normal, Sequential, Random };
+
+private:
+  const char *mappedData;
+  size_t mappedSize;
+#ifdef _WIN32
+  void *fileHandle;
+  void *mappingHandle;
+#else
+  int fileDescriptor;
+#endif
+  std::string lastError;
+
+public:
+  // 构造函数
+  MappedFile();
+  explicit MappedFile(const std::string &path,
+                      Access access = Access::Normal);
+
+  // 析构函数（自动解除映射）
+  ~MappedFile();
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  bool open(const std::string &path, Access access = Access::Normal);
+  void close();
+
+  // 空文件也视为打开成功，此时data()为nullptr
+  bool isOpen() const;
+  const char *data() const { return mappedData; }
+  size_t size() const { return mappedSize; }
+  std::string getLastError() const { return lastError; }
+};
+
+#endif // MAPPEDFILE_H
@@ -0,0 +1,259 @@
+#include "NetworkCentrality.h"
+#include "ParallelUtils.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <random>
+
+namespace {
+
+const double INF = std::numeric_limits<double>::infinity();
+const double TIE_TOLERANCE = 1e-9; // 带权最短路长度相等的相对容差
+
+// 单源最短路计数与依赖回传的工作区（每个工作线程一份）
+struct BrandesWorkspace {
+  std::vector<double> dist;
+  std::vector<double> sigma; // 最短路条数
+  std::vector<double> delta; // 依赖值
+  std::vector<int> order;    // 按距离非降序的出栈顺序
+  std::vector<int> rank;     // 节点在order中的位置，未确定为-1
+  std::vector<std::pair<double, int>> heap;
+
+  explicit BrandesWorkspace(size_t nodeCount)
+      : dist(nodeCount, INF), sigma(nodeCount, 0.0), delta(nodeCount, 0.0),
+        rank(nodeCount, -1) {
+    order.reserve(nodeCount);
+  }
+
+  bool sameLength(double a, double b) const {
+    return std::abs(a - b) <= TIE_TOLERANCE * std::max(1.0, std::abs(b));
+  }
+};
+
+// 平均每个源点的相对误差范围：单个源点对normalized的贡献位于[0, n/(n-1)]
+double hoeffdingBound(int activeCount, size_t samples, double confidence) {
+  if (activeCount < 3 || samples == 0) {
+    return 0.0;
+  }
+  double n = activeCount;
+  double failure = std::max(1e-12, 1.0 - confidence);
+  return n / (n - 1) *
+         std::sqrt(std::log(2.0 * n / failure) / (2.0 * samples));
+}
+
+} // namespace
+
+std::vector<std::pair<EntityHandle, double>>
+BetweennessResult::top(size_t k) const {
+  std::vector<std::pair<EntityHandle, double>> ranking;
+  for (EntityHandle station = 0; station < static_cast<int>(normalized.size());
+       ++station) {
+    ranking.emplace_back(station, normalized[station]);
+  }
+  k = std::min(k, ranking.size());
+  std::partial_sort(ranking.begin(), ranking.begin() + k, ranking.end(),
+                    [](const std::pair<EntityHandle, double> &a,
+                       const std::pair<EntityHandle, double> &b) {
+                      return a.second != b.second ? a.second > b.second
+                                                  : a.first < b.first;
+                    });
+  ranking.resize(k);
+  return ranking;
+}
+
+// 构造函数
+NetworkCentrality::NetworkCentrality(const RailNetwork &railNetwork)
+    : network(railNetwork) {}
+
+std::vector<EntityHandle> NetworkCentrality::activeStations() const {
+  std::vector<EntityHandle> active;
+  for (int node = 0; node < network.getNodeCount(); ++node) {
+    if (network.getDegree(node) > 0) {
+      active.push_back(node);
+    }
+  }
+  return active;
+}
+
+// Brandes：单源计数最短路条数，再按距离逆序回传依赖。
+// 网络为无向图，前驱即先于u确定且满足dist[v] + w == dist[u]的邻居；
+// 以确定顺序而非距离区分前驱，零里程区间两端不会互为前驱
+void NetworkCentrality::accumulate(const std::vector<EntityHandle> &sources,
+                                   bool weighted, PathMetric metric,
+                                   std::vector<double> &scores) const {
+  size_t nodeCount = network.getNodeCount();
+  const auto &offsets = network.getOffsets();
+  const auto &edges = network.getEdges();
+  scores.assign(nodeCount, 0.0);
+
+  unsigned workers = parallelWorkerCount(sources.size(), 8);
+  std::vector<std::vector<double>> partial(workers);
+
+  parallelFor(
+      sources.size(),
+      [&](size_t begin, size_t end, unsigned worker) {
+        BrandesWorkspace ws(nodeCount);
+        std::vector<double> &local = partial[worker];
+        local.assign(nodeCount, 0.0);
+        auto weightOf = [&](const NetworkEdge &edge) {
+          return weighted ? edge.weight(metric) : 1.0;
+        };
+
+        for (size_t s = begin; s < end; ++s) {
+          EntityHandle source = sources[s];
+          ws.order.clear();
+          ws.dist[source] = 0.0;
+          ws.sigma[source] = 1.0;
+
+          if (weighted) {
+            ws.heap.clear();
+            ws.heap.emplace_back(0.0, source);
+            while (!ws.heap.empty()) {
+              std::pop_heap(ws.heap.begin(), ws.heap.end(),
+                            std::greater<std::pair<double, int>>());
+              std::pair<double, int> top = ws.heap.back();
+              ws.heap.pop_back();
+              int u = top.second;
+              if (ws.rank[u] >= 0 || top.first > ws.dist[u]) {
+                continue;
+              }
+              ws.rank[u] = static_cast<int>(ws.order.size());
+              ws.order.push_back(u);
+              for (int e = offsets[u]; e < offsets[u + 1]; ++e) {
+                int v = edges[e].target;
+                if (ws.rank[v] >= 0) {
+                  continue;
+                }
+                double candidate = ws.dist[u] + weightOf(edges[e]);
+                if (ws.dist[v] < INF && ws.sameLength(candidate, ws.dist[v])) {
+                  ws.sigma[v] += ws.sigma[u];
+                } else if (candidate < ws.dist[v]) {
+                  ws.dist[v] = candidate;
+                  ws.sigma[v] = ws.sigma[u];
+                  ws.heap.emplace_back(candidate, v);
+                  std::push_heap(ws.heap.begin(), ws.heap.end(),
+                                 std::greater<std::pair<double, int>>());
+                }
+              }
+            }
+          } else {
+            // 广度优先：order本身即为队列
+            ws.rank[source] = 0;
+            ws.order.push_back(source);
+            for (size_t head = 0; head < ws.order.size(); ++head) {
+              int u = ws.order[head];
+              for (int e = offsets[u]; e < offsets[u + 1]; ++e) {
+                int v = edges[e].target;
+                if (ws.dist[v] == INF) {
+                  ws.dist[v] = ws.dist[u] + 1.0;
+                  ws.rank[v] = static_cast<int>(ws.order.size());
+                  ws.order.push_back(v);
+                }
+                if (ws.dist[v] == ws.dist[u] + 1.0) {
+                  ws.sigma[v] += ws.sigma[u];
+                }
+              }
+            }
+          }
+
+          for (size_t i = ws.order.size(); i-- > 0;) {
+            int u = ws.order[i];
+            double coefficient = (1.0 + ws.delta[u]) / ws.sigma[u];
+            for (int e = offsets[u]; e < offsets[u + 1]; ++e) {
+              int v = edges[e].target;
+              double through = ws.dist[v] + weightOf(edges[e]);
+              if (ws.rank[v] >= 0 && ws.rank[v] < ws.rank[u] &&
+                  (weighted ? ws.sameLength(through, ws.dist[u])
+                            : through == ws.dist[u])) {
+                ws.delta[v] += ws.sigma[v] * coefficient;
+              }
+            }
+            if (u != source) {
+              local[u] += ws.delta[u];
+            }
+          }
+
+          // 只重置本次访问过的节点
+          for (int u : ws.order) {
+            ws.dist[u] = INF;
+            ws.sigma[u] = 0.0;
+            ws.delta[u] = 0.0;
+            ws.rank[u] = -1;
+          }
+        }
+      },
+      8);
+
+  for (const auto &local : partial) {
+    for (size_t node = 0; node < local.size(); ++node) {
+      scores[node] += local[node];
+    }
+  }
+}
+
+BetweennessResult NetworkCentrality::betweenness(bool weighted,
+                                                 PathMetric metric) const {
+  BetweennessResult result;
+  std::vector<EntityHandle> sources = activeStations();
+  accumulate(sources, weighted, metric, result.scores);
+
+  result.activeStationCount = static_cast<int>(sources.size());
+  result.sourceCount = result.activeStationCount;
+  double n = result.activeStationCount;
+  double scale = (n > 2) ? 1.0 / ((n - 1) * (n - 2)) : 0.0;
+  result.normalized.resize(result.scores.size());
+  for (size_t node = 0; node < result.scores.size(); ++node) {
+    result.normalized[node] = result.scores[node] * scale;
+  }
+  return result;
+}
+
+BetweennessResult
+NetworkCentrality::sampledBetweenness(size_t sampleCount, bool weighted,
+                                      PathMetric metric, double confidence,
+                                      unsigned seed) const {
+  std::vector<EntityHandle> active = activeStations();
+  if (sampleCount >= active.size()) {
+    return betweenness(weighted, metric);
+  }
+
+  // 不放回抽样
+  std::mt19937 generator(seed);
+  std::shuffle(active.begin(), active.end(), generator);
+  std::vector<EntityHandle> sources(active.begin(),
+                                    active.begin() + sampleCount);
+
+  BetweennessResult result;
+  accumulate(sources, weighted, metric, result.scores);
+  result.activeStationCount = static_cast<int>(active.size());
+  result.sourceCount = static_cast<int>(sampleCount);
+  result.exact = false;
+  result.confidence = confidence;
+  result.errorBound =
+      hoeffdingBound(result.activeStationCount, sampleCount, confidence);
+
+  double n = result.activeStationCount;
+  double extrapolate = sampleCount > 0 ? n / sampleCount : 0.0;
+  double scale = (n > 2) ? 1.0 / ((n - 1) * (n - 2)) : 0.0;
+  result.normalized.resize(result.scores.size());
+  for (size_t node = 0; node < result.scores.size(); ++node) {
+    result.scores[node] *= extrapolate;
+    result.normalized[node] = result.scores[node] * scale;
+  }
+  return result;
+}
+
+size_t NetworkCentrality::samplesForError(double epsilon,
+                                          double confidence) const {
+  double n = static_cast<double>(activeStations().size());
+  if (n < 3 || epsilon <= 0.0) {
+    return static_cast<size_t>(n);
+  }
+  double failure = std::max(1e-12, 1.0 - confidence);
+  double range = n / (n - 1);
+  double samples =
+      std::ceil(range * range * std::log(2.0 * n / failure) /
+                (2.0 * epsilon * epsilon));
+  return static_cast<size_t>(std::min(samples, n));
+}
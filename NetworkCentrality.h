@@ -0,0 +1,61 @@
+#ifndef NETWORKCENTRALITY_H
+#define NETWORKCENTRALITY_H
+
+#include "RailNetwork.h"
+#include <utility>
+#include <vector>
+
+// 介数中心性结果
+struct BetweennessResult {
+  std::vector<double> scores;     // 按站点句柄：经过该站的有序站点对最短路比例之和
+  std::vector<double> normalized; // scores / ((n-1)(n-2))，n为连通站点数
+  int activeStationCount;         // 至少有一条区间的站点数
+  int sourceCount;                // 实际计算的源点数
+  bool exact;
+  double errorBound; // 抽样模式：以confidence概率所有站点的normalized误差均不超过此值
+  double confidence;
+
+  BetweennessResult()
+      : activeStationCount(0), sourceCount(0), exact(true), errorBound(0.0),
+        confidence(1.0) {}
+
+  // normalized最大的k个站点，按降序
+  std::vector<std::pair<EntityHandle, double>> top(size_t k) const;
+};
+
+// 铁路网络的Brandes介数中心性。按源点并行，每个工作线程独立累加后合并。
+// 带权模式按里程或运行时间求最短路，不带权模式按区间数
+class NetworkCentrality {
+private:
+  const RailNetwork &network;
+
+public:
+  static constexpr double DEFAULT_CONFIDENCE = 0.95;
+  static constexpr unsigned DEFAULT_SEED = 20240101u;
+
+  // 构造函数（network须在本对象使用期间保持有效）
+  explicit NetworkCentrality(const RailNetwork &railNetwork);
+
+  // 精确介数（所有连通站点为源点）
+  BetweennessResult betweenness(bool weighted,
+                                PathMetric metric = PathMetric::Distance) const;
+
+  // 抽样近似：随机选取sampleCount个源点并按比例放大。误差界由Hoeffding
+  // 不等式与对所有站点的联合界给出；样本数不少于连通站点数时退化为精确计算
+  BetweennessResult
+  sampledBetweenness(size_t sampleCount, bool weighted,
+                     PathMetric metric = PathMetric::Distance,
+                     double confidence = DEFAULT_CONFIDENCE,
+                     unsigned seed = DEFAULT_SEED) const;
+
+  // 使误差界不超过epsilon所需的样本数
+  size_t samplesForError(double epsilon,
+                         double confidence = DEFAULT_CONFIDENCE) const;
+
+private:
+  std::vector<EntityHandle> activeStations() const;
+  void accumulate(const std::vector<EntityHandle> &sources, bool weighted,
+                  PathMetric metric, std::vector<double> &scores) const;
+};
+
+#endif // NETWORKCENTRALITY_H
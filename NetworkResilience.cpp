@@ -0,0 +1,430 @@
+#include "NetworkResilience.h"
+#include "ParallelUtils.h"
+#include <algorithm>
+#include <numeric>
+
+namespace {
+
+long long pairCount(long long size) { return size * (size - 1) / 2; }
+
+// 各基准连通分量中的最大剩余块（同样大小取客流较大者，使滞留客流最小）
+struct LargestPiece {
+  int size;
+  double flow;
+
+  LargestPiece() : size(0), flow(0.0) {}
+  bool offer(int pieceSize, double pieceFlow) {
+    if (pieceSize > size || (pieceSize == size && pieceFlow > flow)) {
+      size = pieceSize;
+      flow = pieceFlow;
+      return true;
+    }
+    return false;
+  }
+};
+
+} // namespace
+
+void NetworkResilience::DisjointSet::reset(
+    const std::vector<double> &stationFlow) {
+  parent.resize(stationFlow.size());
+  std::iota(parent.begin(), parent.end(), 0);
+  size.assign(stationFlow.size(), 1);
+  flow = stationFlow;
+}
+
+int NetworkResilience::DisjointSet::find(int x) {
+  while (parent[x] != x) {
+    parent[x] = parent[parent[x]];
+    x = parent[x];
+  }
+  return x;
+}
+
+int NetworkResilience::DisjointSet::unite(int a, int b) {
+  a = find(a);
+  b = find(b);
+  if (a == b) {
+    return -1;
+  }
+  if (size[a] < size[b]) {
+    std::swap(a, b);
+  }
+  parent[b] = a;
+  size[a] += size[b];
+  flow[a] += flow[b];
+  return a;
+}
+
+// 构造函数
+NetworkResilience::NetworkResilience(const RailNetwork &railNetwork,
+                                     const std::vector<double> &flows)
+    : network(railNetwork), baselinePairs(0) {
+  stationFlow.assign(network.getNodeCount(), 0.0);
+  for (size_t i = 0; i < flows.size() && i < stationFlow.size(); ++i) {
+    stationFlow[i] = flows[i];
+  }
+  findComponents();
+  analyzeCutVertices();
+}
+
+void NetworkResilience::findComponents() {
+  int nodeCount = network.getNodeCount();
+  const auto &offsets = network.getOffsets();
+  const auto &edges = network.getEdges();
+  component.assign(nodeCount, -1);
+
+  std::vector<int> queue;
+  for (int start = 0; start < nodeCount; ++start) {
+    if (component[start] >= 0 || network.getDegree(start) == 0) {
+      continue;
+    }
+    int id = static_cast<int>(componentSize.size());
+    componentSize.push_back(0);
+    componentFlow.push_back(0.0);
+    queue.assign(1, start);
+    component[start] = id;
+    for (size_t head = 0; head < queue.size(); ++head) {
+      int u = queue[head];
+      componentSize[id]++;
+      componentFlow[id] += stationFlow[u];
+      for (int e = offsets[u]; e < offsets[u + 1]; ++e) {
+        int v = edges[e].target;
+        if (component[v] < 0) {
+          component[v] = id;
+          queue.push_back(v);
+        }
+      }
+    }
+    baselinePairs += pairCount(componentSize[id]);
+  }
+}
+
+// 迭代式Tarjan：子树c满足low[c] >= disc[u]时，关闭u会使c的子树成为
+// 独立的块；low[c] > disc[u]时(u, c)为桥
+void NetworkResilience::analyzeCutVertices() {
+  int nodeCount = network.getNodeCount();
+  const auto &offsets = network.getOffsets();
+  const auto &edges = network.getEdges();
+
+  std::vector<int> disc(nodeCount, -1), low(nodeCount, 0);
+  std::vector<int> parent(nodeCount, -1), nextEdge(nodeCount, 0);
+  std::vector<char> parentSkipped(nodeCount, 0);
+  std::vector<int> subtreeSize(nodeCount, 0);
+  std::vector<double> subtreeFlow(nodeCount, 0.0);
+  // 关闭该站后与其余部分分离的子树
+  std::vector<int> separatedSize(nodeCount, 0), separatedCount(nodeCount, 0);
+  std::vector<double> separatedFlow(nodeCount, 0.0);
+  std::vector<long long> separatedPairs(nodeCount, 0);
+  std::vector<LargestPiece> largestSeparated(nodeCount);
+
+  int timer = 0;
+  std::vector<int> stack;
+  for (int root = 0; root < nodeCount; ++root) {
+    if (disc[root] >= 0 || component[root] < 0) {
+      continue;
+    }
+    auto visit = [&](int node, int from) {
+      parent[node] = from;
+      disc[node] = low[node] = timer++;
+      nextEdge[node] = offsets[node];
+      subtreeSize[node] = 1;
+      subtreeFlow[node] = stationFlow[node];
+      stack.push_back(node);
+    };
+    visit(root, -1);
+
+    while (!stack.empty()) {
+      int u = stack.back();
+      if (nextEdge[u] < offsets[u + 1]) {
+        int v = edges[nextEdge[u]++].target;
+        if (v == parent[u] && !parentSkipped[u]) {
+          parentSkipped[u] = 1;
+        } else if (disc[v] < 0) {
+          visit(v, u);
+        } else {
+          low[u] = std::min(low[u], disc[v]);
+        }
+        continue;
+      }
+
+      stack.pop_back();
+      int p = parent[u];
+      if (p < 0) {
+        continue;
+      }
+      low[p] = std::min(low[p], low[u]);
+      subtreeSize[p] += subtreeSize[u];
+      subtreeFlow[p] += subtreeFlow[u];
+      if (low[u] >= disc[p]) {
+        separatedSize[p] += subtreeSize[u];
+        separatedFlow[p] += subtreeFlow[u];
+        separatedPairs[p] += pairCount(subtreeSize[u]);
+        separatedCount[p]++;
+        largestSeparated[p].offer(subtreeSize[u], subtreeFlow[u]);
+      }
+      if (low[u] > disc[p]) {
+        int total = componentSize[component[u]];
+        double totalFlow = componentFlow[component[u]];
+        int side = subtreeSize[u];
+        double sideFlow = subtreeFlow[u];
+        // 较小一侧滞留；大小相同则客流较小一侧滞留
+        bool childStranded =
+            side < total - side ||
+            (side == total - side && sideFlow <= totalFlow - sideFlow);
+        SectionImpact bridge;
+        bridge.fromStation = p;
+        bridge.toStation = u;
+        bridge.lostPairs = static_cast<long long>(side) * (total - side);
+        bridge.strandedStations = childStranded ? side : total - side;
+        bridge.strandedFlow = childStranded ? sideFlow : totalFlow - sideFlow;
+        bridges.push_back(bridge);
+      }
+    }
+  }
+
+  stationImpacts.resize(nodeCount);
+  for (int u = 0; u < nodeCount; ++u) {
+    StationImpact &impact = stationImpacts[u];
+    impact.station = u;
+    impact.articulation = false;
+    impact.pieces = 0;
+    impact.lostPairs = 0;
+    impact.strandedStations = 0;
+    impact.strandedFlow = 0.0;
+    if (component[u] < 0) {
+      continue;
+    }
+
+    int total = componentSize[component[u]];
+    double otherFlow = componentFlow[component[u]] - stationFlow[u];
+    int remainder = total - 1 - separatedSize[u];
+    double remainderFlow = otherFlow - separatedFlow[u];
+    LargestPiece largest = largestSeparated[u];
+    if (remainder > 0) {
+      largest.offer(remainder, remainderFlow);
+    }
+
+    impact.pieces = separatedCount[u] + (remainder > 0 ? 1 : 0);
+    impact.articulation = impact.pieces >= 2;
+    impact.lostPairs =
+        pairCount(total) - separatedPairs[u] - pairCount(remainder);
+    impact.strandedStations = total - 1 - largest.size;
+    impact.strandedFlow = std::max(0.0, otherFlow - largest.flow);
+  }
+
+  std::sort(bridges.begin(), bridges.end(),
+            [](const SectionImpact &a, const SectionImpact &b) {
+              if (a.strandedFlow != b.strandedFlow) {
+                return a.strandedFlow > b.strandedFlow;
+              }
+              return a.lostPairs > b.lostPairs;
+            });
+}
+
+std::vector<EntityHandle> NetworkResilience::getArticulationPoints() const {
+  std::vector<EntityHandle> points;
+  for (const auto &impact : stationImpacts) {
+    if (impact.articulation) {
+      points.push_back(impact.station);
+    }
+  }
+  return points;
+}
+
+std::vector<StationImpact> NetworkResilience::rankStations() const {
+  std::vector<StationImpact> ranking;
+  for (const auto &impact : stationImpacts) {
+    if (component[impact.station] >= 0) {
+      ranking.push_back(impact);
+    }
+  }
+  std::sort(ranking.begin(), ranking.end(),
+            [](const StationImpact &a, const StationImpact &b) {
+              if (a.strandedFlow != b.strandedFlow) {
+                return a.strandedFlow > b.strandedFlow;
+              }
+              if (a.lostPairs != b.lostPairs) {
+                return a.lostPairs > b.lostPairs;
+              }
+              return a.station < b.station;
+            });
+  return ranking;
+}
+
+ScenarioOutcome NetworkResilience::evaluate(
+    const ClosureScenario &scenario) const {
+  DisjointSet sets;
+  std::vector<char> closed;
+  return evaluateWith(scenario, sets, closed);
+}
+
+ScenarioOutcome
+NetworkResilience::evaluateWith(const ClosureScenario &scenario,
+                                DisjointSet &sets,
+                                std::vector<char> &closed) const {
+  int nodeCount = network.getNodeCount();
+  const auto &offsets = network.getOffsets();
+  const auto &edges = network.getEdges();
+
+  sets.reset(stationFlow);
+  closed.assign(nodeCount, 0);
+  for (EntityHandle station : scenario.stations) {
+    if (station >= 0 && station < nodeCount) {
+      closed[station] = 1;
+    }
+  }
+  std::vector<std::pair<EntityHandle, EntityHandle>> closedSections;
+  for (const auto &section : scenario.sections) {
+    closedSections.emplace_back(std::min(section.first, section.second),
+                                std::max(section.first, section.second));
+  }
+  std::sort(closedSections.begin(), closedSections.end());
+
+  for (int u = 0; u < nodeCount; ++u) {
+    if (closed[u] || component[u] < 0) {
+      continue;
+    }
+    for (int e = offsets[u]; e < offsets[u + 1]; ++e) {
+      int v = edges[e].target;
+      if (v <= u || closed[v] ||
+          std::binary_search(closedSections.begin(), closedSections.end(),
+                             std::make_pair(u, v))) {
+        continue;
+      }
+      sets.unite(u, v);
+    }
+  }
+
+  ScenarioOutcome outcome;
+  std::vector<LargestPiece> largest(componentSize.size());
+  for (int u = 0; u < nodeCount; ++u) {
+    if (closed[u] || component[u] < 0) {
+      continue;
+    }
+    outcome.strandedStations++;
+    outcome.strandedFlow += stationFlow[u];
+    if (sets.find(u) != u) {
+      continue;
+    }
+    outcome.componentCount++;
+    outcome.largestComponent = std::max(outcome.largestComponent, sets.size[u]);
+    outcome.connectedPairs += pairCount(sets.size[u]);
+    largest[component[u]].offer(sets.size[u], sets.flow[u]);
+  }
+  // 未关闭站点中不在最大剩余块内的即为滞留
+  for (const auto &piece : largest) {
+    outcome.strandedStations -= piece.size;
+    outcome.strandedFlow -= piece.flow;
+  }
+  outcome.strandedFlow = std::max(0.0, outcome.strandedFlow);
+  outcome.lostPairs = baselinePairs - outcome.connectedPairs;
+  return outcome;
+}
+
+std::vector<ScenarioOutcome> NetworkResilience::evaluateBatch(
+    const std::vector<ClosureScenario> &scenarios) const {
+  std::vector<ScenarioOutcome> outcomes(scenarios.size());
+  parallelFor(
+      scenarios.size(),
+      [&](size_t begin, size_t end, unsigned) {
+        DisjointSet sets;
+        std::vector<char> closed;
+        for (size_t i = begin; i < end; ++i) {
+          outcomes[i] = evaluateWith(scenarios[i], sets, closed);
+        }
+      },
+      16);
+  return outcomes;
+}
+
+// 离线逆序：先关闭序列中的全部站点求连通块，再按逆序逐个恢复并合并，
+// 合并只会使块变大，因此各分量的最大剩余块可增量维护
+std::vector<ScenarioOutcome> NetworkResilience::progressiveClosure(
+    const std::vector<EntityHandle> &order) const {
+  int nodeCount = network.getNodeCount();
+  const auto &offsets = network.getOffsets();
+  const auto &edges = network.getEdges();
+
+  std::vector<char> closed(nodeCount, 0);
+  std::vector<char> reopenAt(order.size(), 0); // 每个站点只在首次出现处恢复
+  for (size_t i = 0; i < order.size(); ++i) {
+    EntityHandle station = order[i];
+    if (station >= 0 && station < nodeCount && component[station] >= 0 &&
+        !closed[station]) {
+      closed[station] = 1;
+      reopenAt[i] = 1;
+    }
+  }
+
+  ClosureScenario all;
+  all.stations.assign(order.begin(), order.end());
+  DisjointSet sets;
+  std::vector<char> unused;
+  std::vector<ScenarioOutcome> outcomes(order.size() + 1);
+  ScenarioOutcome current = evaluateWith(all, sets, unused);
+  outcomes[order.size()] = current;
+
+  // 恢复当前状态下各分量的最大剩余块与未关闭站点合计
+  std::vector<LargestPiece> largest(componentSize.size());
+  int openStations = 0;
+  double openFlow = 0.0;
+  for (int u = 0; u < nodeCount; ++u) {
+    if (closed[u] || component[u] < 0) {
+      continue;
+    }
+    openStations++;
+    openFlow += stationFlow[u];
+    if (sets.find(u) == u) {
+      largest[component[u]].offer(sets.size[u], sets.flow[u]);
+    }
+  }
+  int largestTotal = 0;
+  double largestFlow = 0.0;
+  for (const auto &piece : largest) {
+    largestTotal += piece.size;
+    largestFlow += piece.flow;
+  }
+  auto offer = [&](int root) {
+    LargestPiece &piece = largest[component[root]];
+    int oldSize = piece.size;
+    double oldFlow = piece.flow;
+    if (piece.offer(sets.size[root], sets.flow[root])) {
+      largestTotal += piece.size - oldSize;
+      largestFlow += piece.flow - oldFlow;
+    }
+  };
+
+  for (size_t i = order.size(); i-- > 0;) {
+    if (reopenAt[i]) {
+      int u = order[i];
+      closed[u] = 0;
+      openStations++;
+      openFlow += stationFlow[u];
+      current.componentCount++;
+      offer(u);
+      for (int e = offsets[u]; e < offsets[u + 1]; ++e) {
+        int v = edges[e].target;
+        if (closed[v]) {
+          continue;
+        }
+        long long sizeA = sets.size[sets.find(u)];
+        long long sizeB = sets.size[sets.find(v)];
+        int root = sets.unite(u, v);
+        if (root < 0) {
+          continue;
+        }
+        current.componentCount--;
+        current.connectedPairs += sizeA * sizeB;
+        offer(root);
+      }
+      current.largestComponent =
+          std::max(current.largestComponent, sets.size[sets.find(u)]);
+      current.lostPairs = baselinePairs - current.connectedPairs;
+      current.strandedStations = openStations - largestTotal;
+      current.strandedFlow = std::max(0.0, openFlow - largestFlow);
+    }
+    outcomes[i] = current;
+  }
+  return outcomes;
+}
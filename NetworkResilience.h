@@ -0,0 +1,105 @@
+#ifndef NETWORKRESILIENCE_H
+#define NETWORKRESILIENCE_H
+
+#include "RailNetwork.h"
+#include <utility>
+#include <vector>
+
+// 关闭单个站点的影响
+struct StationImpact {
+  EntityHandle station;
+  bool articulation;    // 是否为割点（关闭后所在连通分量分裂）
+  int pieces;           // 关闭后原连通分量剩余的块数
+  long long lostPairs;  // 失去连通的站点对数（含与该站自身的站点对）
+  int strandedStations; // 与最大剩余块断开的站点数
+  double strandedFlow;  // 上述站点的客流合计
+};
+
+// 关闭单个区间（桥）的影响
+struct SectionImpact {
+  EntityHandle fromStation;
+  EntityHandle toStation;
+  long long lostPairs;
+  int strandedStations; // 较小一侧的站点数
+  double strandedFlow;
+};
+
+// 关闭场景：若干站点与区间同时关闭
+struct ClosureScenario {
+  std::vector<EntityHandle> stations;
+  std::vector<std::pair<EntityHandle, EntityHandle>> sections;
+};
+
+// 场景评估结果（只统计至少有一条区间的站点）
+struct ScenarioOutcome {
+  int componentCount;
+  int largestComponent;
+  long long connectedPairs;
+  long long lostPairs; // 相对基准网络
+  int strandedStations; // 未关闭但与原连通分量最大剩余块断开的站点
+  double strandedFlow;
+
+  ScenarioOutcome()
+      : componentCount(0), largestComponent(0), connectedPairs(0),
+        lostPairs(0), strandedStations(0), strandedFlow(0.0) {}
+};
+
+// 网络连通性与韧性：一次深度优先搜索求出割点、桥以及关闭每个站点的
+// 影响；任意关闭场景用并查集批量评估，逐步关闭序列用离线逆序加点求解
+class NetworkResilience {
+private:
+  const RailNetwork &network;
+  std::vector<double> stationFlow;     // 按站点句柄
+  std::vector<int> component;          // 基准连通分量编号（孤立站点为-1）
+  std::vector<int> componentSize;
+  std::vector<double> componentFlow;
+  long long baselinePairs;
+  std::vector<StationImpact> stationImpacts; // 按站点句柄（孤立站点无影响）
+  std::vector<SectionImpact> bridges;        // 按影响降序
+
+public:
+  // 构造函数（network须在本对象使用期间保持有效）。
+  // flows为按站点句柄的客流，可为空
+  explicit NetworkResilience(const RailNetwork &railNetwork,
+                             const std::vector<double> &flows = {});
+
+  int getComponentCount() const {
+    return static_cast<int>(componentSize.size());
+  }
+  long long getBaselinePairs() const { return baselinePairs; }
+  const StationImpact &getStationImpact(EntityHandle station) const {
+    return stationImpacts[station];
+  }
+  std::vector<EntityHandle> getArticulationPoints() const;
+  const std::vector<SectionImpact> &getBridges() const { return bridges; }
+
+  // 全部站点按关闭影响排序（滞留客流优先，其次失联站点对）
+  std::vector<StationImpact> rankStations() const;
+
+  ScenarioOutcome evaluate(const ClosureScenario &scenario) const;
+  // 批量独立场景，按场景并行
+  std::vector<ScenarioOutcome>
+  evaluateBatch(const std::vector<ClosureScenario> &scenarios) const;
+  // 按顺序逐个关闭站点：结果第i项为关闭前i个站点后的状态（第0项为基准）
+  std::vector<ScenarioOutcome>
+  progressiveClosure(const std::vector<EntityHandle> &order) const;
+
+private:
+  struct DisjointSet {
+    std::vector<int> parent;
+    std::vector<int> size;
+    std::vector<double> flow;
+
+    void reset(const std::vector<double> &stationFlow);
+    int find(int x);
+    int unite(int a, int b); // 返回合并后的根，已在同一集合返回-1
+  };
+
+  void findComponents();
+  void analyzeCutVertices();
+  ScenarioOutcome evaluateWith(const ClosureScenario &scenario,
+                               DisjointSet &sets,
+                               std::vector<char> &closed) const;
+};
+
+#endif // NETWORKRESILIENCE_H
@@ -0,0 +1,67 @@
+#ifndef PARALLELUTILS_H
+#define PARALLELUTILS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 根据任务量确定工作线程数（至少1个）
+inline unsigned parallelWorkerCount(size_t count, size_t minPerWorker = 1) {
+  unsigned hardware = std::thread::hardware_concurrency();
+  if (hardware == 0) {
+    hardware = 2;
+  }
+  size_t byWork = std::max<size_t>(1, count / std::max<size_t>(1, minPerWorker));
+  return static_cast<unsigned>(std::min<size_t>(hardware, byWork));
+}
+
+// 将[0, count)划分为连续区间并行执行 fn(begin, end, workerIndex)。
+// 工作线程中抛出的第一个异常会在所有线程结束后重新抛出。
+template <typename Fn>
+void parallelFor(size_t count, Fn &&fn, size_t minPerWorker = 1) {
+  if (count == 0) {
+    return;
+  }
+
+  unsigned workers = parallelWorkerCount(count, minPerWorker);
+  if (workers <= 1) {
+    fn(size_t(0), count, 0u);
+    return;
+  }
+
+  std::exception_ptr firstError;
+  std::mutex errorMutex;
+  std::vector<std::thread> threads;
+  threads.reserve(workers);
+
+  size_t chunk = (count + workers - 1) / workers;
+  for (unsigned w = 0; w < workers; ++w) {
+    size_t begin = w * chunk;
+    size_t end = std::min(count, begin + chunk);
+    if (begin >= end) {
+      break;
+    }
+    threads.emplace_back([&, begin, end, w]() {
+      try {
+        fn(begin, end, w);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if (!firstError) {
+          firstError = std::current_exception();
+        }
+      }
+    });
+  }
+
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  if (firstError) {
+    std::rethrow_exception(firstError);
+  }
+}
+
+#endif // PARALLELUTILS_H
@@ -0,0 +1,323 @@
+#include "PassengerAssignment.h"
+#include "ParallelUtils.h"
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <numeric>
+
+int TrainLoad::getPeakLoad() const {
+  return sectionLoads.empty()
+             ? 0
+             : *std::max_element(sectionLoads.begin(), sectionLoads.end());
+}
+
+std::vector<SectionLoad>
+AssignmentResult::getCrowdedSections(double threshold) const {
+  std::vector<SectionLoad> sections;
+  for (EntityHandle train = 0; train < static_cast<int>(trains.size());
+       ++train) {
+    const TrainLoad &load = trains[train];
+    for (size_t i = 0; i < load.sectionLoads.size(); ++i) {
+      SectionLoad section{train, load.stops[i], load.stops[i + 1],
+                          load.sectionLoads[i], load.capacity};
+      if (load.capacity > 0 && section.getLoadFactor() >= threshold) {
+        sections.push_back(section);
+      }
+    }
+  }
+  std::sort(sections.begin(), sections.end(),
+            [](const SectionLoad &a, const SectionLoad &b) {
+              return a.getLoadFactor() > b.getLoadFactor();
+            });
+  return sections;
+}
+
+namespace {
+
+// 并查集（按列车句柄）
+EntityHandle findRoot(std::vector<EntityHandle> &parent, EntityHandle x) {
+  while (parent[x] != x) {
+    parent[x] = parent[parent[x]];
+    x = parent[x];
+  }
+  return x;
+}
+
+} // namespace
+
+std::vector<PassengerAssignment::Boarding>::const_iterator
+PassengerAssignment::firstBoarding(const std::vector<Boarding> &list,
+                                   int minute) {
+  return std::lower_bound(list.begin(), list.end(), minute,
+                          [](const Boarding &boarding, int value) {
+                            return boarding.departureMinute < value;
+                          });
+}
+
+// 构造函数：整理各列车停站，建立按站发车索引
+PassengerAssignment::PassengerAssignment(
+    std::shared_ptr<const EntityCatalog> entityCatalog, int maxWait)
+    : catalog(entityCatalog ? entityCatalog : EntityCatalog::empty()),
+      maxWaitMinutes(maxWait) {
+  int trainCount = catalog->getTrainCount();
+  trainStops.resize(trainCount);
+  trainDepartures.resize(trainCount);
+  stopLookup.resize(trainCount);
+  boardings.resize(catalog->getStationCount());
+
+  for (EntityHandle train = 0; train < trainCount; ++train) {
+    const auto &trainPtr = catalog->getTrain(train);
+    const auto &schedule = trainPtr->getSchedule();
+    for (size_t i = 0; i < schedule.size(); ++i) {
+      EntityHandle station = catalog->getStationHandle(schedule[i].stationId);
+      if (station == INVALID_HANDLE) {
+        continue;
+      }
+      trainStops[train].push_back(station);
+      trainDepartures[train].push_back(trainPtr->getDepartureMinute(i));
+    }
+    if (trainStops[train].size() < 2) {
+      trainStops[train].clear();
+      trainDepartures[train].clear();
+      continue;
+    }
+
+    const auto &stops = trainStops[train];
+    auto &lookup = stopLookup[train];
+    for (size_t i = 0; i < stops.size(); ++i) {
+      lookup.emplace_back(stops[i], static_cast<int>(i));
+      if (i + 1 < stops.size()) {
+        boardings[stops[i]].push_back(
+            {trainDepartures[train][i], train, static_cast<int>(i)});
+      }
+    }
+    std::sort(lookup.begin(), lookup.end());
+  }
+
+  for (auto &list : boardings) {
+    std::sort(list.begin(), list.end(),
+              [](const Boarding &a, const Boarding &b) {
+                if (a.departureMinute != b.departureMinute) {
+                  return a.departureMinute < b.departureMinute;
+                }
+                return a.train < b.train;
+              });
+  }
+}
+
+int PassengerAssignment::findStop(EntityHandle train, EntityHandle station,
+                                  int after) const {
+  const auto &lookup = stopLookup[train];
+  auto it = std::lower_bound(lookup.begin(), lookup.end(),
+                             std::make_pair(station, after + 1));
+  return (it != lookup.end() && it->first == station) ? it->second : -1;
+}
+
+AssignmentResult
+PassengerAssignment::assign(const std::vector<OdDemand> &demands) const {
+  AssignmentResult result;
+  int trainCount = static_cast<int>(trainStops.size());
+  int stationCount = static_cast<int>(boardings.size());
+  result.trains.resize(trainCount);
+  for (EntityHandle train = 0; train < trainCount; ++train) {
+    TrainLoad &load = result.trains[train];
+    load.capacity = catalog->getTrain(train)->getTotalCapacity();
+    load.stops = trainStops[train];
+    load.sectionLoads.assign(
+        load.stops.empty() ? 0 : load.stops.size() - 1, 0);
+  }
+
+  // 合并同一需求在等待时限内可乘的全部直达列车（分配只会用到这些列车）；
+  // 无可乘列车的需求直接计为未服务
+  std::vector<EntityHandle> parent(trainCount);
+  std::iota(parent.begin(), parent.end(), 0);
+  std::vector<EntityHandle> demandTrain(demands.size(), INVALID_HANDLE);
+  for (size_t k = 0; k < demands.size(); ++k) {
+    const OdDemand &demand = demands[k];
+    if (demand.passengers <= 0) {
+      continue;
+    }
+    result.totalDemand += demand.passengers;
+    if (demand.origin < 0 || demand.origin >= stationCount ||
+        demand.destination < 0 || demand.destination >= stationCount) {
+      result.unservedPassengers += demand.passengers;
+      continue;
+    }
+
+    const auto &list = boardings[demand.origin];
+    for (auto it = firstBoarding(list, demand.departureMinute);
+         it != list.end() &&
+         it->departureMinute - demand.departureMinute <= maxWaitMinutes;
+         ++it) {
+      if (findStop(it->train, demand.destination, it->stop) < 0) {
+        continue;
+      }
+      if (demandTrain[k] == INVALID_HANDLE) {
+        demandTrain[k] = it->train;
+      } else {
+        parent[findRoot(parent, it->train)] = findRoot(parent, demandTrain[k]);
+      }
+    }
+    if (demandTrain[k] == INVALID_HANDLE) {
+      result.unservedPassengers += demand.passengers;
+    }
+  }
+
+  // 按走廊分组需求
+  std::vector<int> corridorOfRoot(trainCount, -1);
+  std::vector<std::vector<const OdDemand *>> byCorridor;
+  for (size_t k = 0; k < demands.size(); ++k) {
+    if (demandTrain[k] == INVALID_HANDLE) {
+      continue;
+    }
+    EntityHandle root = findRoot(parent, demandTrain[k]);
+    if (corridorOfRoot[root] < 0) {
+      corridorOfRoot[root] = static_cast<int>(byCorridor.size());
+      byCorridor.emplace_back();
+    }
+    byCorridor[corridorOfRoot[root]].push_back(&demands[k]);
+  }
+  result.corridorCount = static_cast<int>(byCorridor.size());
+
+  // 大走廊优先，由各工作线程动态领取
+  std::vector<int> order(byCorridor.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&byCorridor](int a, int b) {
+    return byCorridor[a].size() > byCorridor[b].size();
+  });
+  std::vector<AssignmentResult> totals(order.size());
+  std::atomic<size_t> next(0);
+  parallelFor(parallelWorkerCount(order.size()),
+              [&](size_t, size_t, unsigned) {
+                for (size_t i = next++; i < order.size(); i = next++) {
+                  int corridor = order[i];
+                  assignCorridor(byCorridor[corridor], result.trains,
+                                 totals[corridor]);
+                }
+              });
+
+  for (const auto &partial : totals) {
+    result.assignedPassengers += partial.assignedPassengers;
+    result.unservedPassengers += partial.unservedPassengers;
+    result.deniedBoardings += partial.deniedBoardings;
+    result.totalWaitMinutes += partial.totalWaitMinutes;
+  }
+  return result;
+}
+
+// 走廊内按期望出发时刻依次处理；每个需求沿起点站的发车序列尝试各班
+// 直达列车，可装载人数为容量减去所经区间的最大断面客流
+void PassengerAssignment::assignCorridor(
+    const std::vector<const OdDemand *> &demands,
+    std::vector<TrainLoad> &trains, AssignmentResult &totals) const {
+  std::vector<const OdDemand *> sorted(demands);
+  std::stable_sort(sorted.begin(), sorted.end(),
+                   [](const OdDemand *a, const OdDemand *b) {
+                     return a->departureMinute < b->departureMinute;
+                   });
+
+  for (const OdDemand *demand : sorted) {
+    const auto &list = boardings[demand->origin];
+    int waiting = demand->passengers;
+    for (auto it = firstBoarding(list, demand->departureMinute);
+         it != list.end() && waiting > 0; ++it) {
+      if (it->departureMinute - demand->departureMinute > maxWaitMinutes) {
+        break;
+      }
+      int alight = findStop(it->train, demand->destination, it->stop);
+      if (alight < 0) {
+        continue;
+      }
+      TrainLoad &load = trains[it->train];
+      int peak = *std::max_element(load.sectionLoads.begin() + it->stop,
+                                   load.sectionLoads.begin() + alight);
+      int boarding = std::min(waiting, std::max(0, load.capacity - peak));
+      if (boarding < waiting) {
+        load.deniedBoardings += waiting - boarding;
+        totals.deniedBoardings += waiting - boarding;
+      }
+      if (boarding == 0) {
+        continue;
+      }
+      for (int section = it->stop; section < alight; ++section) {
+        load.sectionLoads[section] += boarding;
+      }
+      load.boarded += boarding;
+      waiting -= boarding;
+      totals.assignedPassengers += boarding;
+      totals.totalWaitMinutes += static_cast<long long>(boarding) *
+                                 (it->departureMinute - demand->departureMinute);
+    }
+    totals.unservedPassengers += waiting;
+  }
+}
+
+std::vector<OdDemand>
+PassengerAssignment::demandFromFlow(const PassengerFlow &passengerFlow,
+                                    const Date &date) const {
+  // (列车, 停站序号) -> 上车、下车人数
+  std::map<std::pair<EntityHandle, int>, std::pair<int, int>> counts;
+  for (const auto &record : passengerFlow.getRecordsByDate(date)) {
+    EntityHandle train = catalog->getTrainHandle(record.getTrainId());
+    EntityHandle station = catalog->getStationHandle(record.getStationId());
+    if (train == INVALID_HANDLE || station == INVALID_HANDLE) {
+      continue;
+    }
+    int stop = findStop(train, station, -1);
+    if (stop < 0) {
+      continue;
+    }
+    auto &count = counts[{train, stop}];
+    count.first += record.getBoardingCount();
+    count.second += record.getAlightingCount();
+  }
+
+  std::vector<OdDemand> demands;
+  for (const auto &entry : counts) {
+    EntityHandle train = entry.first.first;
+    int stop = entry.first.second;
+    int boarding = entry.second.first;
+    const auto &stops = trainStops[train];
+    if (boarding <= 0 || stop + 1 >= static_cast<int>(stops.size())) {
+      continue;
+    }
+
+    // 后续各站的下车权重
+    std::vector<long long> weights;
+    long long weightSum = 0;
+    for (size_t j = stop + 1; j < stops.size(); ++j) {
+      auto found = counts.find({train, static_cast<int>(j)});
+      long long weight = (found != counts.end()) ? found->second.second : 0;
+      weights.push_back(weight);
+      weightSum += weight;
+    }
+    if (weightSum == 0) {
+      std::fill(weights.begin(), weights.end(), 1);
+      weightSum = static_cast<long long>(weights.size());
+    }
+
+    // 按比例取整，余数归入权重最大的去向
+    int remaining = boarding;
+    size_t heaviest = 0;
+    for (size_t k = 0; k < weights.size(); ++k) {
+      if (weights[k] > weights[heaviest]) {
+        heaviest = k;
+      }
+    }
+    std::vector<int> shares(weights.size());
+    for (size_t k = 0; k < weights.size(); ++k) {
+      shares[k] = static_cast<int>(boarding * weights[k] / weightSum);
+      remaining -= shares[k];
+    }
+    shares[heaviest] += remaining;
+
+    int departure = trainDepartures[train][stop];
+    for (size_t k = 0; k < shares.size(); ++k) {
+      if (shares[k] > 0) {
+        demands.push_back(
+            {stops[stop], stops[stop + 1 + k], departure, shares[k]});
+      }
+    }
+  }
+  return demands;
+}
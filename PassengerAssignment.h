@@ -0,0 +1,116 @@
+#ifndef PASSENGERASSIGNMENT_H
+#define PASSENGERASSIGNMENT_H
+
+#include "EntityCatalog.h"
+#include "PassengerFlow.h"
+#include <memory>
+#include <vector>
+
+// 起讫点需求：希望不早于departureMinute从origin出发前往destination
+struct OdDemand {
+  EntityHandle origin;
+  EntityHandle destination;
+  int departureMinute;
+  int passengers;
+};
+
+// 单个列车区间的断面客流
+struct SectionLoad {
+  EntityHandle train;
+  EntityHandle fromStation;
+  EntityHandle toStation;
+  int passengers;
+  int capacity;
+
+  double getLoadFactor() const {
+    return capacity > 0 ? static_cast<double>(passengers) / capacity : 0.0;
+  }
+};
+
+// 单列车的分配结果
+struct TrainLoad {
+  int capacity;
+  int boarded;                     // 上车总人数
+  int deniedBoardings;             // 因满员未能登乘本车的人次
+  std::vector<EntityHandle> stops; // 停站（按顺序）
+  std::vector<int> sectionLoads;   // 第i段为stops[i]->stops[i+1]的断面客流
+
+  TrainLoad() : capacity(0), boarded(0), deniedBoardings(0) {}
+  int getPeakLoad() const;
+  double getPeakLoadFactor() const {
+    return capacity > 0 ? static_cast<double>(getPeakLoad()) / capacity : 0.0;
+  }
+};
+
+// 一次分配的汇总
+struct AssignmentResult {
+  std::vector<TrainLoad> trains; // 按列车句柄
+  long long totalDemand;
+  long long assignedPassengers;
+  long long unservedPassengers; // 等待时限内没有可乘列车或均已满员
+  long long deniedBoardings;
+  long long totalWaitMinutes; // 已分配乘客自期望时刻至发车的等待
+  int corridorCount;          // 相互独立的列车组数
+
+  AssignmentResult()
+      : totalDemand(0), assignedPassengers(0), unservedPassengers(0),
+        deniedBoardings(0), totalWaitMinutes(0), corridorCount(0) {}
+  double getAverageWait() const {
+    return assignedPassengers > 0
+               ? static_cast<double>(totalWaitMinutes) / assignedPassengers
+               : 0.0;
+  }
+  // 满载率不低于threshold的区间，按满载率降序
+  std::vector<SectionLoad> getCrowdedSections(double threshold) const;
+};
+
+// 容量约束下的客流分配：按期望出发时刻先到先得，将起讫点需求装载到
+// 时刻表上依次发车的直达列车，满员则溢出到下一班可乘列车。
+// 可被同一起讫点需求乘坐的列车归入同一走廊，走廊之间没有共同的
+// 需求与区间，按走廊并行计算
+class PassengerAssignment {
+private:
+  struct Boarding {
+    int departureMinute;
+    EntityHandle train;
+    int stop;
+  };
+
+  std::shared_ptr<const EntityCatalog> catalog;
+  std::vector<std::vector<EntityHandle>> trainStops; // 按列车句柄
+  std::vector<std::vector<int>> trainDepartures;     // 各停站发车分钟
+  // 按列车句柄：(站点, 停站序号)按站点排序，用于查找下车站
+  std::vector<std::vector<std::pair<EntityHandle, int>>> stopLookup;
+  std::vector<std::vector<Boarding>> boardings; // 按站点句柄，按发车时刻排序
+  int maxWaitMinutes;
+
+public:
+  static constexpr int DEFAULT_MAX_WAIT_MINUTES = 180;
+
+  // 由目录中列车的时刻表构建；少于两个有效停站的列车不参与分配
+  explicit PassengerAssignment(
+      std::shared_ptr<const EntityCatalog> entityCatalog,
+      int maxWait = DEFAULT_MAX_WAIT_MINUTES);
+
+  int getMaxWaitMinutes() const { return maxWaitMinutes; }
+
+  AssignmentResult assign(const std::vector<OdDemand> &demands) const;
+
+  // 由指定日期的客流记录推算起讫点需求：各列车在某站的上车人数按
+  // 该车后续各站下车人数的比例分配去向（无下车记录时平均分配）
+  std::vector<OdDemand> demandFromFlow(const PassengerFlow &passengerFlow,
+                                       const Date &date) const;
+
+private:
+  // 各走廊的列车互不相交，trains可由多个线程分别写入；合计写入totals
+  void assignCorridor(const std::vector<const OdDemand *> &demands,
+                      std::vector<TrainLoad> &trains,
+                      AssignmentResult &totals) const;
+  // 发车时刻不早于minute的第一个上车机会
+  static std::vector<Boarding>::const_iterator
+  firstBoarding(const std::vector<Boarding> &list, int minute);
+  // 列车在after之后停靠station的序号，不停靠返回-1
+  int findStop(EntityHandle train, EntityHandle station, int after) const;
+};
+
+#endif // PASSENGERASSIGNMENT_H
@@ -4,9 +4,30 @@
 #include <cstdlib>
 #include <ctime>
 #include <iomanip>
+#include <iterator>
 #include <numeric>
 #include <sstream>
 
+namespace {
+
+// (小时, 净上车人数)按小时排序后求前缀和，返回车上人数峰值
+int peakOnboard(std::vector<std::pair<int, int>> &changes) {
+  std::stable_sort(changes.begin(), changes.end(),
+                   [](const std::pair<int, int> &a,
+                      const std::pair<int, int> &b) {
+                     return a.first < b.first;
+                   });
+  int onboard = 0;
+  int peak = 0;
+  for (const auto &change : changes) {
+    onboard = std::max(0, onboard + change.second);
+    peak = std::max(peak, onboard);
+  }
+  return peak;
+}
+
+} // namespace
+
 // Date类方法实现
 std::string Date::toString() const {
   std::ostringstream oss;
@@ -67,6 +88,16 @@ void PassengerFlow::addRecord(const FlowRecord &record) {
   updateStatistics();
 }
 
+void PassengerFlow::addRecords(std::vector<FlowRecord> &&batch) {
+  if (records.empty()) {
+    records = std::move(batch);
+  } else {
+    records.insert(records.end(), std::make_move_iterator(batch.begin()),
+                   std::make_move_iterator(batch.end()));
+  }
+  updateStatistics();
+}
+
 void PassengerFlow::removeRecord(const std::string &recordId) {
   records.erase(std::remove_if(records.begin(), records.end(),
                                [&recordId](const FlowRecord &record) {
@@ -153,11 +184,10 @@ PassengerFlow::getStationHourlyFlow(const std::string &stationId,
 std::map<std::string, int> PassengerFlow::getAllStationsFlow() const {
   std::map<std::string, int> stationFlow;
   for (const auto &record : records) {
-    // 使用站点名称而不是站点ID作为键
-    std::string stationKey = record.getStationName();
-    if (stationKey.empty()) {
-      stationKey = record.getStationId(); // 如果没有站点名称，使用ID作为备用
-    }
+    // 使用站点名称而不是站点ID作为键，没有站点名称时使用ID作为备用
+    const std::string &stationKey = record.getStationName().empty()
+                                        ? record.getStationId()
+                                        : record.getStationName();
     stationFlow[stationKey] += record.getTotalFlow();
   }
   return stationFlow;
@@ -201,52 +231,39 @@ double PassengerFlow::getFlowRatio() const {
 }
 
 double PassengerFlow::calculateLoadFactor(const std::string &trainId,
-                                          const Date &date) const {
-  // 这里需要结合列车容量信息，暂时返回一个模拟值
-  int totalPassengers = 0;
-  int recordCount = 0;
-
+                                          const Date &date,
+                                          int capacity) const {
+  std::vector<std::pair<int, int>> changes;
   for (const auto &record : records) {
     if (record.getTrainId() == trainId && record.getDate() == date) {
-      totalPassengers += record.getBoardingCount();
-      recordCount++;
+      changes.emplace_back(record.getHour(), record.getNetFlow());
     }
   }
 
-  // 假设列车容量为1200人
-  int trainCapacity = 1200;
-  if (recordCount > 0) {
-    return (static_cast<double>(totalPassengers) / recordCount /
-            trainCapacity) *
-           100.0;
+  if (changes.empty() || capacity <= 0) {
+    return 0.0;
   }
-  return 0.0;
+  return static_cast<double>(peakOnboard(changes)) / capacity * 100.0;
 }
 
 std::map<std::string, double>
-PassengerFlow::getAllTrainsLoadFactor(const Date &date) const {
+PassengerFlow::getAllTrainsLoadFactor(const Date &date, int capacity) const {
   std::map<std::string, double> loadFactors;
-  std::map<std::string, int> trainPassengers;
-  std::map<std::string, int> trainRecords;
+  std::map<std::string, std::vector<std::pair<int, int>>> changesByTrain;
 
   for (const auto &record : records) {
     if (record.getDate() == date && !record.getTrainId().empty()) {
-      trainPassengers[record.getTrainId()] += record.getBoardingCount();
-      trainRecords[record.getTrainId()]++;
+      changesByTrain[record.getTrainId()].emplace_back(record.getHour(),
+                                                       record.getNetFlow());
     }
   }
 
-  for (const auto &pair : trainPassengers) {
-    const std::string &trainId = pair.first;
-    int totalPassengers = pair.second;
-    int recordCount = trainRecords[trainId];
-
-    int trainCapacity = 1200; // 假设容量
-    if (recordCount > 0) {
-      loadFactors[trainId] =
-          (static_cast<double>(totalPassengers) / recordCount / trainCapacity) *
-          100.0;
-    }
+  if (capacity <= 0) {
+    return loadFactors;
+  }
+  for (auto &pair : changesByTrain) {
+    loadFactors[pair.first] =
+        static_cast<double>(peakOnboard(pair.second)) / capacity * 100.0;
   }
 
   return loadFactors;
@@ -510,11 +527,14 @@ std::string PassengerFlow::generateFlowReport(const Date &date) const {
   std::ostringstream oss;
   oss << "=== " << date.toString() << " 客流报告 ===\n\n";
 
-  auto dayRecords = getRecordsByDate(date);
   int totalFlow = 0;
 
+  // 直接遍历记录，避免复制当天的记录
   std::map<std::string, int> stationFlow;
-  for (const auto &record : dayRecords) {
+  for (const auto &record : records) {
+    if (!(record.getDate() == date)) {
+      continue;
+    }
     totalFlow += record.getTotalFlow();
     stationFlow[record.getStationName()] += record.getTotalFlow();
   }
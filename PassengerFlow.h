@@ -44,15 +44,15 @@ public:
   ~FlowRecord();
 
   // Getter方法
-  std::string getRecordId() const { return recordId; }
-  std::string getStationId() const { return stationId; }
-  std::string getStationName() const { return stationName; }
+  const std::string &getRecordId() const { return recordId; }
+  const std::string &getStationId() const { return stationId; }
+  const std::string &getStationName() const { return stationName; }
   Date getDate() const { return date; }
   int getHour() const { return hour; }
   int getBoardingCount() const { return boardingCount; }
   int getAlightingCount() const { return alightingCount; }
-  std::string getTrainId() const { return trainId; }
-  std::string getDirection() const { return direction; }
+  const std::string &getTrainId() const { return trainId; }
+  const std::string &getDirection() const { return direction; }
 
   // Setter方法
   void setRecordId(const std::string &id) { recordId = id; }
@@ -87,6 +87,7 @@ public:
 
   // 数据管理
   void addRecord(const FlowRecord &record);
+  void addRecords(std::vector<FlowRecord> &&batch); // 批量添加，仅统计一次
   void removeRecord(const std::string &recordId);
   FlowRecord *findRecord(const std::string &recordId);
   std::vector<FlowRecord>
@@ -107,10 +108,14 @@ public:
   int getChongqingToChengduFlow(const Date &date) const;
   double getFlowRatio() const; // 川渝流量比
 
-  // 载客率分析
-  double calculateLoadFactor(const std::string &trainId,
-                             const Date &date) const;
-  std::map<std::string, double> getAllTrainsLoadFactor(const Date &date) const;
+  // 载客率分析（%）：无停站顺序时按记录小时顺序累计上车减下车，取车上
+  // 人数峰值除以定员；已知列车停站与定员时使用SectionLoadIndex
+  static constexpr int DEFAULT_TRAIN_CAPACITY = 1200;
+  double calculateLoadFactor(const std::string &trainId, const Date &date,
+                             int capacity = DEFAULT_TRAIN_CAPACITY) const;
+  std::map<std::string, double>
+  getAllTrainsLoadFactor(const Date &date,
+                         int capacity = DEFAULT_TRAIN_CAPACITY) const;
 
   // 预测功能
   std::vector<int> predictFlow(const std::string &stationId,
@@ -125,6 +130,7 @@ public:
 
   // 辅助方法
   int getRecordCount() const { return static_cast<int>(records.size()); }
+  const std::vector<FlowRecord> &getRecords() const { return records; }
   void clearAllRecords() { records.clear(); }
 };
 
@@ -0,0 +1,207 @@
+#include "PlatformOccupancy.h"
+#include "ParallelUtils.h"
+#include <algorithm>
+#include <atomic>
+
+namespace {
+
+const int MINUTES_PER_DAY = 24 * 60;
+
+// 站台状态（分配时间轴自切点起算）
+struct Platform {
+  int freeAt;       // 此后空闲
+  int reservedFrom; // 跨切点列车自此时刻重新占用，无预留为MINUTES_PER_DAY
+};
+
+} // namespace
+
+// 构造函数：整理各站点的停靠时段
+PlatformOccupancy::PlatformOccupancy(
+    std::shared_ptr<const EntityCatalog> entityCatalog, int clearance)
+    : catalog(entityCatalog ? entityCatalog : EntityCatalog::empty()),
+      clearanceMinutes(clearance) {
+  visits.resize(catalog->getStationCount());
+  for (EntityHandle train = 0; train < catalog->getTrainCount(); ++train) {
+    const auto &trainPtr = catalog->getTrain(train);
+    const auto &schedule = trainPtr->getSchedule();
+    for (size_t i = 0; i < schedule.size(); ++i) {
+      EntityHandle station = catalog->getStationHandle(schedule[i].stationId);
+      if (station == INVALID_HANDLE) {
+        continue;
+      }
+      int arrival = trainPtr->getArrivalMinute(i);
+      int duration =
+          trainPtr->getDepartureMinute(i) - arrival + clearanceMinutes;
+      visits[station].push_back(
+          {train, static_cast<int>(i), arrival % MINUTES_PER_DAY,
+           std::min(MINUTES_PER_DAY, std::max(1, duration))});
+    }
+  }
+}
+
+void PlatformOccupancy::fillOccupancy(EntityHandle station,
+                                      std::vector<int> &occupancy) const {
+  occupancy.assign(MINUTES_PER_DAY + 1, 0);
+  for (const auto &visit : visits[station]) {
+    int end = visit.start + visit.duration;
+    occupancy[visit.start]++;
+    if (end <= MINUTES_PER_DAY) {
+      occupancy[end]--;
+    } else {
+      occupancy[MINUTES_PER_DAY]--;
+      occupancy[0]++;
+      occupancy[end - MINUTES_PER_DAY]--;
+    }
+  }
+  for (int minute = 1; minute <= MINUTES_PER_DAY; ++minute) {
+    occupancy[minute] += occupancy[minute - 1];
+  }
+  occupancy.pop_back();
+}
+
+// 区间划分：按切点后的到达顺序，在到达时已空闲且不妨碍预留的站台中
+// 选空闲最晚者，没有则启用新站台
+int PlatformOccupancy::partition(
+    EntityHandle station, const std::vector<int> &occupancy,
+    std::vector<PlatformAssignment> *assignments) const {
+  const auto &stationVisits = visits[station];
+  int cut = static_cast<int>(
+      std::min_element(occupancy.begin(), occupancy.end()) -
+      occupancy.begin());
+  auto rotate = [cut](int minute) {
+    return (minute - cut + MINUTES_PER_DAY) % MINUTES_PER_DAY;
+  };
+
+  std::vector<size_t> order(stationVisits.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    int ra = rotate(stationVisits[a].start);
+    int rb = rotate(stationVisits[b].start);
+    return ra != rb ? ra < rb : a < b;
+  });
+
+  std::vector<Platform> platforms;
+  std::vector<int> platformOf(stationVisits.size(), -1);
+
+  // 跨切点的停靠先占用站台：切点后占用至其结束，到自身到达时刻再次占用
+  for (size_t i : order) {
+    const Visit &visit = stationVisits[i];
+    int begin = rotate(visit.start);
+    if (begin + visit.duration > MINUTES_PER_DAY) {
+      platformOf[i] = static_cast<int>(platforms.size());
+      platforms.push_back({begin + visit.duration - MINUTES_PER_DAY, begin});
+    }
+  }
+
+  for (size_t i : order) {
+    if (platformOf[i] >= 0) {
+      continue;
+    }
+    const Visit &visit = stationVisits[i];
+    int begin = rotate(visit.start);
+    int end = begin + visit.duration;
+    int best = -1;
+    for (size_t p = 0; p < platforms.size(); ++p) {
+      if (platforms[p].freeAt <= begin && end <= platforms[p].reservedFrom &&
+          (best < 0 || platforms[p].freeAt > platforms[best].freeAt)) {
+        best = static_cast<int>(p);
+      }
+    }
+    if (best < 0) {
+      best = static_cast<int>(platforms.size());
+      platforms.push_back({0, MINUTES_PER_DAY});
+    }
+    platforms[best].freeAt = end;
+    platformOf[i] = best;
+  }
+
+  if (assignments) {
+    assignments->clear();
+    for (size_t i = 0; i < stationVisits.size(); ++i) {
+      const Visit &visit = stationVisits[i];
+      assignments->push_back({visit.train, visit.stop, platformOf[i],
+                              visit.start, visit.start + visit.duration});
+    }
+    std::sort(assignments->begin(), assignments->end(),
+              [](const PlatformAssignment &a, const PlatformAssignment &b) {
+                if (a.arrivalMinute != b.arrivalMinute) {
+                  return a.arrivalMinute < b.arrivalMinute;
+                }
+                return a.train != b.train ? a.train < b.train : a.stop < b.stop;
+              });
+  }
+  return static_cast<int>(platforms.size());
+}
+
+PlatformUsage PlatformOccupancy::evaluateStation(EntityHandle station) const {
+  PlatformUsage usage;
+  usage.station = station;
+  usage.platformCount = catalog->getStation(station)->getPlatformCount();
+  usage.stopCount = static_cast<int>(visits[station].size());
+  if (visits[station].empty()) {
+    return usage;
+  }
+
+  std::vector<int> occupancy;
+  fillOccupancy(station, occupancy);
+  auto peak = std::max_element(occupancy.begin(), occupancy.end());
+  usage.peakOccupancy = *peak;
+  usage.peakMinute = static_cast<int>(peak - occupancy.begin());
+
+  // 超出站台数的连续时段，首尾相接的时段跨午夜合并；站台数未知时跳过
+  for (int minute = 0; usage.platformCount > 0 && minute < MINUTES_PER_DAY;
+       ++minute) {
+    if (occupancy[minute] <= usage.platformCount) {
+      continue;
+    }
+    usage.overflowMinutes++;
+    if (!usage.overflows.empty() &&
+        usage.overflows.back().endMinute == minute) {
+      usage.overflows.back().endMinute = minute + 1;
+      usage.overflows.back().peakDemand =
+          std::max(usage.overflows.back().peakDemand, occupancy[minute]);
+    } else {
+      usage.overflows.push_back({minute, minute + 1, occupancy[minute]});
+    }
+  }
+  if (usage.overflows.size() > 1 && usage.overflows.front().startMinute == 0 &&
+      usage.overflows.back().endMinute == MINUTES_PER_DAY) {
+    OverflowWindow &last = usage.overflows.back();
+    last.endMinute += usage.overflows.front().endMinute;
+    last.peakDemand =
+        std::max(last.peakDemand, usage.overflows.front().peakDemand);
+    usage.overflows.erase(usage.overflows.begin());
+  }
+
+  usage.platformsAssigned = partition(station, occupancy, nullptr);
+  return usage;
+}
+
+std::vector<PlatformUsage> PlatformOccupancy::evaluate() const {
+  size_t stationCount = visits.size();
+  std::vector<PlatformUsage> usages(stationCount);
+
+  // 各站停靠数差异很大，由工作线程动态领取
+  std::atomic<size_t> next(0);
+  parallelFor(parallelWorkerCount(stationCount, 64),
+              [&](size_t, size_t, unsigned) {
+                for (size_t s = next++; s < stationCount; s = next++) {
+                  usages[s] = evaluateStation(static_cast<EntityHandle>(s));
+                }
+              });
+  return usages;
+}
+
+std::vector<PlatformAssignment>
+PlatformOccupancy::assignPlatforms(EntityHandle station) const {
+  std::vector<PlatformAssignment> assignments;
+  if (visits[station].empty()) {
+    return assignments;
+  }
+  std::vector<int> occupancy;
+  fillOccupancy(station, occupancy);
+  partition(station, occupancy, &assignments);
+  return assignments;
+}
@@ -0,0 +1,86 @@
+#ifndef PLATFORMOCCUPANCY_H
+#define PLATFORMOCCUPANCY_H
+
+#include "EntityCatalog.h"
+#include <memory>
+#include <vector>
+
+// 站台需求超过站台数的时段[startMinute, endMinute)，跨午夜时endMinute大于1440
+struct OverflowWindow {
+  int startMinute;
+  int endMinute;
+  int peakDemand;
+};
+
+// 单个站点的站台占用
+// 站台数未知（platformCount为0）时只统计占用，不判定超出
+struct PlatformUsage {
+  EntityHandle station;
+  int platformCount;     // 0为未知
+  int stopCount;         // 停靠列次
+  int peakOccupancy;     // 同一分钟同时占用站台的最大列车数
+  int peakMinute;        // 首次达到峰值的时刻
+  // 区间划分实际使用的站台数：全天存在无列车占用的分钟时等于
+  // peakOccupancy（即最少所需站台数），否则可能多于峰值
+  int platformsAssigned;
+  int overflowMinutes;   // 需求超过站台数的总分钟数
+  std::vector<OverflowWindow> overflows;
+
+  PlatformUsage()
+      : station(INVALID_HANDLE), platformCount(0), stopCount(0),
+        peakOccupancy(0), peakMinute(0), platformsAssigned(0),
+        overflowMinutes(0) {}
+  bool isOverloaded() const {
+    return platformCount > 0 && peakOccupancy > platformCount;
+  }
+};
+
+// 单次停靠的站台分配
+struct PlatformAssignment {
+  EntityHandle train;
+  int stop;     // 停站序号
+  int platform; // 从0开始
+  int arrivalMinute;
+  int releaseMinute; // 离站加清空时间，可能超过1440
+};
+
+// 站台占用评估：各站以列车到发时段（离站后再计清空时间）为区间，
+// 按分钟差分求同时占用数，得到峰值与超出站台数的时段（站台数已知时）；
+// 站台分配为按到达排序的区间划分，在到达时已空闲的站台中选空闲最晚者，
+// 没有则启用新站台。时刻表按日循环，分配从全天占用最少的时刻切开，
+// 该时刻无列车时所用站台数等于峰值。
+// 站点之间相互独立，按站点并行
+class PlatformOccupancy {
+private:
+  struct Visit {
+    EntityHandle train;
+    int stop;
+    int start;    // 当日分钟，[0, 1440)
+    int duration; // 至少1分钟
+  };
+
+  std::shared_ptr<const EntityCatalog> catalog;
+  std::vector<std::vector<Visit>> visits; // 按站点句柄
+  int clearanceMinutes;
+
+public:
+  static constexpr int DEFAULT_CLEARANCE_MINUTES = 2;
+
+  // 构造函数（整理各站点的停靠）
+  explicit PlatformOccupancy(std::shared_ptr<const EntityCatalog> entityCatalog,
+                             int clearance = DEFAULT_CLEARANCE_MINUTES);
+
+  // 全部站点（按站点句柄）
+  std::vector<PlatformUsage> evaluate() const;
+  PlatformUsage evaluateStation(EntityHandle station) const;
+  // 按到达时刻排序
+  std::vector<PlatformAssignment> assignPlatforms(EntityHandle station) const;
+
+private:
+  // occupancy为各分钟的占用数（长度1440），返回使用的站台数
+  int partition(EntityHandle station, const std::vector<int> &occupancy,
+                std::vector<PlatformAssignment> *assignments) const;
+  void fillOccupancy(EntityHandle station, std::vector<int> &occupancy) const;
+};
+
+#endif // PLATFORMOCCUPANCY_H
@@ -0,0 +1,290 @@
+#include "RailNetwork.h"
+#include <algorithm>
+#include <functional>
+
+namespace {
+
+const double INF = std::numeric_limits<double>::infinity();
+
+struct Arc {
+  int source;
+  int target;
+  double distance;
+  double minutes;
+};
+
+DijkstraWorkspace &localWorkspace() {
+  thread_local DijkstraWorkspace workspace;
+  return workspace;
+}
+
+} // namespace
+
+// ========== DijkstraWorkspace ==========
+
+DijkstraWorkspace::DijkstraWorkspace() : generation(0) {}
+
+void DijkstraWorkspace::prepare(size_t nodeCount) {
+  for (auto &side : sides) {
+    if (side.dist.size() != nodeCount) {
+      side.dist.assign(nodeCount, INF);
+      side.parent.assign(nodeCount, -1);
+      side.stamp.assign(nodeCount, 0);
+    }
+    side.heap.clear();
+  }
+  ++generation;
+  if (generation == 0) {
+    // 版本号回绕时整表清零一次
+    for (auto &side : sides) {
+      std::fill(side.stamp.begin(), side.stamp.end(), 0u);
+    }
+    generation = 1;
+  }
+}
+
+void DijkstraWorkspace::relax(int side, int node, double dist, int parent) {
+  Side &s = sides[side];
+  s.dist[node] = dist;
+  s.parent[node] = parent;
+  s.stamp[node] = generation;
+  s.heap.emplace_back(dist, node);
+  std::push_heap(s.heap.begin(), s.heap.end(),
+                 std::greater<std::pair<double, int>>());
+}
+
+std::pair<double, int> DijkstraWorkspace::popMin(int side) {
+  auto &heap = sides[side].heap;
+  std::pop_heap(heap.begin(), heap.end(),
+                std::greater<std::pair<double, int>>());
+  auto top = heap.back();
+  heap.pop_back();
+  return top;
+}
+
+double DijkstraWorkspace::distanceTo(int node) const {
+  if (node < 0 || node >= static_cast<int>(sides[0].stamp.size()) ||
+      !reached(0, node)) {
+    return INF;
+  }
+  return sides[0].dist[node];
+}
+
+int DijkstraWorkspace::parentOf(int node) const {
+  if (node < 0 || node >= static_cast<int>(sides[0].stamp.size()) ||
+      !reached(0, node)) {
+    return -1;
+  }
+  return sides[0].parent[node];
+}
+
+// ========== RailNetwork ==========
+
+RailNetwork::RailNetwork(std::shared_ptr<const EntityCatalog> entityCatalog)
+    : catalog(entityCatalog ? entityCatalog : EntityCatalog::empty()) {
+  int nodeCount = catalog->getStationCount();
+
+  // 收集两个方向的弧
+  std::vector<Arc> arcs;
+  for (const auto &route : catalog->getRoutes()) {
+    const auto &routeStations = route->getStations();
+    double speed = (route->getMaxSpeed() > 0)
+                       ? route->getMaxSpeed() * SPEED_FACTOR
+                       : DEFAULT_SPEED;
+    int previous = INVALID_HANDLE;
+    for (size_t i = 0; i < routeStations.size(); ++i) {
+      int current = catalog->getStationHandle(routeStations[i]->getStationId());
+      if (i > 0 && previous != INVALID_HANDLE && current != INVALID_HANDLE &&
+          previous != current) {
+        double distance = route->getSegmentDistance(static_cast<int>(i));
+        double minutes = distance / speed * 60.0;
+        arcs.push_back({previous, current, distance, minutes});
+        arcs.push_back({current, previous, distance, minutes});
+      }
+      previous = current;
+    }
+  }
+
+  // 按(起点,终点)排序，合并平行弧
+  std::sort(arcs.begin(), arcs.end(), [](const Arc &a, const Arc &b) {
+    return (a.source != b.source) ? a.source < b.source : a.target < b.target;
+  });
+
+  offsets.assign(nodeCount + 1, 0);
+  edges.reserve(arcs.size());
+  for (size_t i = 0; i < arcs.size(); ++i) {
+    const Arc &arc = arcs[i];
+    if (i > 0 && arcs[i - 1].source == arc.source &&
+        arcs[i - 1].target == arc.target) {
+      NetworkEdge &last = edges.back();
+      last.distance = std::min(last.distance, arc.distance);
+      last.minutes = std::min(last.minutes, arc.minutes);
+      continue;
+    }
+    edges.push_back({arc.target, arc.distance, arc.minutes});
+    ++offsets[arc.source + 1];
+  }
+  for (int i = 0; i < nodeCount; ++i) {
+    offsets[i + 1] += offsets[i];
+  }
+}
+
+void RailNetwork::shortestPathTree(int source, PathMetric metric,
+                                   DijkstraWorkspace &workspace,
+                                   double maxCost) const {
+  workspace.prepare(getNodeCount());
+  if (source < 0 || source >= getNodeCount()) {
+    return;
+  }
+
+  auto &forward = workspace.sides[0];
+  workspace.relax(0, source, 0.0, -1);
+  while (!forward.heap.empty()) {
+    auto top = workspace.popMin(0);
+    int node = top.second;
+    if (top.first > forward.dist[node]) {
+      continue;
+    }
+    if (top.first > maxCost) {
+      break;
+    }
+    for (int e = offsets[node]; e < offsets[node + 1]; ++e) {
+      const NetworkEdge &edge = edges[e];
+      double candidate = top.first + edge.weight(metric);
+      if (!workspace.reached(0, edge.target) ||
+          candidate < forward.dist[edge.target]) {
+        workspace.relax(0, edge.target, candidate, node);
+      }
+    }
+  }
+}
+
+PathResult RailNetwork::shortestPath(int source, int target, PathMetric metric,
+                                     DijkstraWorkspace &workspace) const {
+  PathResult result;
+  workspace.prepare(getNodeCount());
+  if (source < 0 || source >= getNodeCount() || target < 0 ||
+      target >= getNodeCount()) {
+    return result;
+  }
+
+  auto &forward = workspace.sides[0];
+  workspace.relax(0, source, 0.0, -1);
+  while (!forward.heap.empty()) {
+    auto top = workspace.popMin(0);
+    int node = top.second;
+    if (top.first > forward.dist[node]) {
+      continue;
+    }
+    if (node == target) {
+      result.found = true;
+      result.cost = top.first;
+      break;
+    }
+    for (int e = offsets[node]; e < offsets[node + 1]; ++e) {
+      const NetworkEdge &edge = edges[e];
+      double candidate = top.first + edge.weight(metric);
+      if (!workspace.reached(0, edge.target) ||
+          candidate < forward.dist[edge.target]) {
+        workspace.relax(0, edge.target, candidate, node);
+      }
+    }
+  }
+
+  if (result.found) {
+    for (int node = target; node != -1; node = forward.parent[node]) {
+      result.stations.push_back(node);
+    }
+    std::reverse(result.stations.begin(), result.stations.end());
+  }
+  return result;
+}
+
+PathResult
+RailNetwork::bidirectionalShortestPath(int source, int target,
+                                       PathMetric metric,
+                                       DijkstraWorkspace &workspace) const {
+  PathResult result;
+  workspace.prepare(getNodeCount());
+  if (source < 0 || source >= getNodeCount() || target < 0 ||
+      target >= getNodeCount()) {
+    return result;
+  }
+
+  double best = (source == target) ? 0.0 : INF;
+  int meeting = (source == target) ? source : -1;
+  workspace.relax(0, source, 0.0, -1);
+  workspace.relax(1, target, 0.0, -1);
+
+  auto &heapF = workspace.sides[0].heap;
+  auto &heapB = workspace.sides[1].heap;
+  while (!heapF.empty() && !heapB.empty()) {
+    if (heapF.front().first + heapB.front().first >= best) {
+      break;
+    }
+    // 网络为无向图，反向搜索与正向共用同一组弧；每次扩展堆较小的一侧
+    int side = (heapF.size() <= heapB.size()) ? 0 : 1;
+    int other = 1 - side;
+    auto &current = workspace.sides[side];
+    auto &opposite = workspace.sides[other];
+
+    auto top = workspace.popMin(side);
+    int node = top.second;
+    if (top.first > current.dist[node]) {
+      continue;
+    }
+    for (int e = offsets[node]; e < offsets[node + 1]; ++e) {
+      const NetworkEdge &edge = edges[e];
+      double candidate = top.first + edge.weight(metric);
+      if (!workspace.reached(side, edge.target) ||
+          candidate < current.dist[edge.target]) {
+        workspace.relax(side, edge.target, candidate, node);
+        if (workspace.reached(other, edge.target)) {
+          double total = candidate + opposite.dist[edge.target];
+          if (total < best) {
+            best = total;
+            meeting = edge.target;
+          }
+        }
+      }
+    }
+  }
+
+  if (meeting < 0) {
+    return result;
+  }
+  result.found = true;
+  result.cost = best;
+  for (int node = meeting; node != -1; node = workspace.sides[0].parent[node]) {
+    result.stations.push_back(node);
+  }
+  std::reverse(result.stations.begin(), result.stations.end());
+  for (int node = workspace.sides[1].parent[meeting]; node != -1;
+       node = workspace.sides[1].parent[node]) {
+    result.stations.push_back(node);
+  }
+  return result;
+}
+
+PathResult RailNetwork::findPath(const std::string &fromStationId,
+                                 const std::string &toStationId,
+                                 PathMetric metric) const {
+  EntityHandle source = catalog->getStationHandle(fromStationId);
+  EntityHandle target = catalog->getStationHandle(toStationId);
+  if (source == INVALID_HANDLE || target == INVALID_HANDLE) {
+    return PathResult();
+  }
+  return bidirectionalShortestPath(source, target, metric, localWorkspace());
+}
+
+double RailNetwork::shortestDistance(const std::string &fromStationId,
+                                     const std::string &toStationId) const {
+  PathResult result = findPath(fromStationId, toStationId, PathMetric::Distance);
+  return result.found ? result.cost : -1.0;
+}
+
+double RailNetwork::shortestTravelTime(const std::string &fromStationId,
+                                       const std::string &toStationId) const {
+  PathResult result = findPath(fromStationId, toStationId, PathMetric::Time);
+  return result.found ? result.cost : -1.0;
+}
@@ -0,0 +1,122 @@
+#ifndef RAILNETWORK_H
+#define RAILNETWORK_H
+
+#include "EntityCatalog.h"
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// 最短路度量
+enum class PathMetric {
+  Distance = 0, // 里程（公里）
+  Time          // 典型运行时间（分钟）
+};
+
+// 有向弧（无向区间按两个方向各存一条）
+struct NetworkEdge {
+  int target;      // 目标站点句柄
+  double distance; // 区间里程（公里）
+  double minutes;  // 典型运行时间（分钟）
+
+  double weight(PathMetric metric) const {
+    return (metric == PathMetric::Distance) ? distance : minutes;
+  }
+};
+
+// 最短路查询结果
+struct PathResult {
+  bool found;
+  double cost;                        // 按查询度量的总代价
+  std::vector<EntityHandle> stations; // 途经站点句柄（含起终点）
+
+  PathResult() : found(false), cost(std::numeric_limits<double>::infinity()) {}
+};
+
+// Dijkstra工作区：距离、前驱与二叉堆按节点数预分配，
+// 以版本号代替每次查询的整表清零，可在多次查询间复用（非线程安全）
+class DijkstraWorkspace {
+private:
+  friend class RailNetwork;
+  friend class ContractionHierarchy;
+
+  struct Side {
+    std::vector<double> dist;
+    std::vector<int> parent;
+    std::vector<unsigned> stamp;
+    std::vector<std::pair<double, int>> heap; // 小顶堆（懒删除）
+  };
+
+  Side sides[2]; // 0为正向，1为反向（双向搜索）
+  unsigned generation;
+
+  void prepare(size_t nodeCount);
+  bool reached(int side, int node) const {
+    return sides[side].stamp[node] == generation;
+  }
+  void relax(int side, int node, double dist, int parent);
+  std::pair<double, int> popMin(int side);
+
+public:
+  // 构造函数
+  DijkstraWorkspace();
+
+  // 最近一次单源查询（shortestPathTree）的结果；不可达返回无穷大/-1
+  double distanceTo(int node) const;
+  int parentOf(int node) const;
+};
+
+// CSR格式的铁路网络：站点为节点，线路相邻站点之间的区间为边，
+// 平行区间保留最小里程与最短运行时间
+class RailNetwork {
+private:
+  std::shared_ptr<const EntityCatalog> catalog;
+  std::vector<int> offsets; // 节点i的出弧为edges[offsets[i], offsets[i+1])
+  std::vector<NetworkEdge> edges;
+
+public:
+  static constexpr double SPEED_FACTOR = 0.8;    // 典型速度占最高速度的比例
+  static constexpr double DEFAULT_SPEED = 120.0; // 无最高速度时使用（km/h）
+
+  // 由目录中的全部线路构建；线路站点不在目录中时该区间被忽略
+  explicit RailNetwork(std::shared_ptr<const EntityCatalog> entityCatalog);
+
+  const EntityCatalog &getCatalog() const { return *catalog; }
+  const std::shared_ptr<const EntityCatalog> &getSharedCatalog() const {
+    return catalog;
+  }
+  int getNodeCount() const { return static_cast<int>(offsets.size()) - 1; }
+  int getArcCount() const { return static_cast<int>(edges.size()); }
+  int getDegree(int node) const { return offsets[node + 1] - offsets[node]; }
+  const std::vector<int> &getOffsets() const { return offsets; }
+  const std::vector<NetworkEdge> &getEdges() const { return edges; }
+
+  // 单源最短路树，结果通过workspace.distanceTo/parentOf读取。
+  // 给定maxCost时代价不超过maxCost的站点保证为最短，更远的站点可能未到达
+  void shortestPathTree(int source, PathMetric metric,
+                        DijkstraWorkspace &workspace,
+                        double maxCost =
+                            std::numeric_limits<double>::infinity()) const;
+
+  // 点对点最短路（单向，目标出堆即停止）
+  PathResult shortestPath(int source, int target, PathMetric metric,
+                          DijkstraWorkspace &workspace) const;
+
+  // 点对点最短路（双向Dijkstra）
+  PathResult bidirectionalShortestPath(int source, int target,
+                                       PathMetric metric,
+                                       DijkstraWorkspace &workspace) const;
+
+  // 按站点ID查询（使用线程局部工作区）；站点不存在或不可达时found为false
+  PathResult findPath(const std::string &fromStationId,
+                      const std::string &toStationId,
+                      PathMetric metric = PathMetric::Distance) const;
+  // 最短里程（公里）/最短运行时间（分钟），不可达返回-1
+  double shortestDistance(const std::string &fromStationId,
+                          const std::string &toStationId) const;
+  double shortestTravelTime(const std::string &fromStationId,
+                            const std::string &toStationId) const;
+};
+
+#endif // RAILNETWORK_H
@@ -1,4 +1,4 @@
-QT += core gui widgets charts
+QT += core gui widgets charts concurrent
 CONFIG += c++17 console
 TEMPLATE = app
 TARGET = RailwaySystemGUI
@@ -9,6 +9,27 @@ SOURCES += Station.cpp \
            PassengerFlow.cpp \
            DataAnalyzer.cpp \
            FileManager.cpp \
+           DataReloader.cpp \
+           BackupStore.cpp \
+           CsvWriter.cpp \
+           MappedFile.cpp \
+           ValidationEngine.cpp \
+           EntityCatalog.cpp \
+           RailNetwork.cpp \
+           ContractionHierarchy.cpp \
+           JourneyPlanner.cpp \
+           DistanceMatrix.cpp \
+           SpatialIndex.cpp \
+           TrainSimulator.cpp \
+           PassengerAssignment.cpp \
+           NetworkCentrality.cpp \
+           NetworkResilience.cpp \
+           SectionLoadIndex.cpp \
+           FlowScheduleJoin.cpp \
+           HeadwayChecker.cpp \
+           PlatformOccupancy.cpp \
+           TimetableGenerator.cpp \
+           IsochroneIndex.cpp \
            AdvancedAnalyzer.cpp \
            TimeSeriesAnalyzer.cpp \
            main_gui.cpp
@@ -19,6 +40,28 @@ HEADERS += Station.h \
            PassengerFlow.h \
            DataAnalyzer.h \
            FileManager.h \
+           DataReloader.h \
+           BackupStore.h \
+           ParallelUtils.h \
+           CsvWriter.h \
+           MappedFile.h \
+           ValidationEngine.h \
+           EntityCatalog.h \
+           RailNetwork.h \
+           ContractionHierarchy.h \
+           JourneyPlanner.h \
+           DistanceMatrix.h \
+           SpatialIndex.h \
+           TrainSimulator.h \
+           PassengerAssignment.h \
+           NetworkCentrality.h \
+           NetworkResilience.h \
+           SectionLoadIndex.h \
+           FlowScheduleJoin.h \
+           HeadwayChecker.h \
+           PlatformOccupancy.h \
+           TimetableGenerator.h \
+           IsochroneIndex.h \
            AdvancedAnalyzer.h \
            TimeSeriesAnalyzer.h
 
@@ -20,9 +20,25 @@ Route::Route(const std::string &id, const std::string &name,
 Route::~Route() { stations.clear(); }
 
 // 添加站点
-void Route::addStation(std::shared_ptr<Station> station) {
+void Route::addStation(std::shared_ptr<Station> station,
+                       double segmentDistance) {
   if (station) {
+    double position = 0.0;
+    if (!stations.empty()) {
+      // 缺少站间距离时退回到两站的球面距离
+      if (segmentDistance < 0.0) {
+        segmentDistance = stations.back()->distanceTo(*station);
+      }
+      position = cumulativeDistance.back() + segmentDistance;
+    }
+
     stations.push_back(station);
+    cumulativeDistance.push_back(position);
+    // 环线等重复经过的站点以首次出现的位置为准
+    stationIndex.emplace(station->getStationId(), stations.size() - 1);
+    if (position > totalDistance) {
+      totalDistance = position;
+    }
 
     // 更新起始和终点城市
     if (stations.size() == 1) {
@@ -34,24 +50,45 @@ void Route::addStation(std::shared_ptr<Station> station) {
 
 // 移除站点
 void Route::removeStation(const std::string &stationId) {
-  stations.erase(
-      std::remove_if(stations.begin(), stations.end(),
-                     [&stationId](const std::shared_ptr<Station> &station) {
-                       return station && station->getStationId() == stationId;
-                     }),
-      stations.end());
+  // 累计里程是沿线位置，删除站点后其余站点的位置不变
+  size_t kept = 0;
+  for (size_t i = 0; i < stations.size(); ++i) {
+    if (stations[i]->getStationId() != stationId) {
+      stations[kept] = stations[i];
+      cumulativeDistance[kept] = cumulativeDistance[i];
+      ++kept;
+    }
+  }
+  if (kept == stations.size()) {
+    return;
+  }
+  stations.resize(kept);
+  cumulativeDistance.resize(kept);
+
+  // 保持起点里程为0
+  if (!cumulativeDistance.empty() && cumulativeDistance[0] != 0.0) {
+    double origin = cumulativeDistance[0];
+    for (auto &position : cumulativeDistance) {
+      position -= origin;
+    }
+  }
+
+  stationIndex.clear();
+  for (size_t i = 0; i < stations.size(); ++i) {
+    stationIndex.emplace(stations[i]->getStationId(), i);
+  }
 }
 
 // 查找站点
 std::shared_ptr<Station>
 Route::findStation(const std::string &stationId) const {
-  auto it =
-      std::find_if(stations.begin(), stations.end(),
-                   [&stationId](const std::shared_ptr<Station> &station) {
-                     return station && station->getStationId() == stationId;
-                   });
+  auto it = stationIndex.find(stationId);
+  return (it != stationIndex.end()) ? stations[it->second] : nullptr;
+}
 
-  return (it != stations.end()) ? *it : nullptr;
+int Route::getStationIndex(const std::string &stationId) const {
+  auto it = stationIndex.find(stationId);
+  return (it != stationIndex.end()) ? static_cast<int>(it->second) : -1;
 }
 
 // 获取站点数量
@@ -72,27 +109,36 @@ std::string Route::getStationsInOrder() const {
   return oss.str();
 }
 
-// 计算两站间距离（简化版，基于坐标计算）
+// 计算两站间沿线距离（累计里程相减）
 double Route::calculateDistance(const std::string &fromStationId,
                                 const std::string &toStationId) const {
-  auto fromStation = findStation(fromStationId);
-  auto toStation = findStation(toStationId);
+  auto from = stationIndex.find(fromStationId);
+  auto to = stationIndex.find(toStationId);
 
-  if (!fromStation || !toStation) {
+  if (from == stationIndex.end() || to == stationIndex.end()) {
     return 0.0;
   }
 
-  // 使用简化的距离计算公式
-  double lat1 = fromStation->getLatitude();
-  double lon1 = fromStation->getLongitude();
-  double lat2 = toStation->getLatitude();
-  double lon2 = toStation->getLongitude();
+  return std::fabs(cumulativeDistance[to->second] -
+                   cumulativeDistance[from->second]);
+}
+
+double Route::getCumulativeDistance(int index) const {
+  if (index < 0 || index >= static_cast<int>(cumulativeDistance.size())) {
+    return 0.0;
+  }
+  return cumulativeDistance[index];
+}
 
-  // 简化的欧几里得距离
-  double dx = (lon2 - lon1) * 111.0; // 经度转公里的近似值
-  double dy = (lat2 - lat1) * 111.0; // 纬度转公里的近似值
+double Route::getSegmentDistance(int index) const {
+  if (index <= 0 || index >= static_cast<int>(cumulativeDistance.size())) {
+    return 0.0;
+  }
+  return cumulativeDistance[index] - cumulativeDistance[index - 1];
+}
 
-  return std::sqrt(dx * dx + dy * dy);
+double Route::getTrackLength() const {
+  return cumulativeDistance.empty() ? 0.0 : cumulativeDistance.back();
 }
 
 // 转换为字符串
@@ -4,6 +4,7 @@
 #include "Station.h"
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 
@@ -18,6 +19,8 @@ private:
   std::string startCity;                          // 起始城市
   std::string endCity;                            // 终点城市
   bool isOperational;                             // 是否正在运营
+  std::unordered_map<std::string, size_t> stationIndex; // 站点ID→线路位置
+  std::vector<double> cumulativeDistance; // 起点到各站的沿线里程（公里）
 
 public:
   // 构造函数
@@ -29,14 +32,16 @@ public:
   ~Route();
 
   // Getter方法
-  std::string getRouteId() const { return routeId; }
-  std::string getRouteName() const { return routeName; }
-  std::string getRouteType() const { return routeType; }
-  std::vector<std::shared_ptr<Station>> getStations() const { return stations; }
+  const std::string &getRouteId() const { return routeId; }
+  const std::string &getRouteName() const { return routeName; }
+  const std::string &getRouteType() const { return routeType; }
+  const std::vector<std::shared_ptr<Station>> &getStations() const {
+    return stations;
+  }
   double getTotalDistance() const { return totalDistance; }
   int getMaxSpeed() const { return maxSpeed; }
-  std::string getStartCity() const { return startCity; }
-  std::string getEndCity() const { return endCity; }
+  const std::string &getStartCity() const { return startCity; }
+  const std::string &getEndCity() const { return endCity; }
   bool getIsOperational() const { return isOperational; }
 
   // Setter方法
@@ -50,13 +55,20 @@ public:
   void setIsOperational(bool operational) { isOperational = operational; }
 
   // 功能方法
-  void addStation(std::shared_ptr<Station> station);
+  // segmentDistance为与上一站的站间距离（公里），为负数时按坐标估算
+  void addStation(std::shared_ptr<Station> station,
+                  double segmentDistance = -1.0);
   void removeStation(const std::string &stationId);
   std::shared_ptr<Station> findStation(const std::string &stationId) const;
+  int getStationIndex(const std::string &stationId) const; // 不存在返回-1
   int getStationCount() const;
   std::string getStationsInOrder() const;
+  // 沿线里程：两次索引查找加一次减法
   double calculateDistance(const std::string &fromStationId,
                            const std::string &toStationId) const;
+  double getCumulativeDistance(int index) const;
+  double getSegmentDistance(int index) const; // 第index站与上一站的距离
+  double getTrackLength() const;
   std::string toString() const;
   bool operator==(const Route &other) const;
 };
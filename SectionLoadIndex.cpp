@@ -0,0 +1,213 @@
+#include "SectionLoadIndex.h"
+#include "ParallelUtils.h"
+#include <algorithm>
+#include <cmath>
+
+// 构造函数：整理各列车停站与沿线里程，登记所经区间
+SectionLoadIndex::SectionLoadIndex(
+    std::shared_ptr<const EntityCatalog> entityCatalog)
+    : catalog(entityCatalog ? entityCatalog : EntityCatalog::empty()),
+      matchedRecords(0), unmatchedRecords(0) {
+  int trainCount = catalog->getTrainCount();
+  trains.resize(trainCount);
+  stopLookup.resize(trainCount);
+
+  for (EntityHandle train = 0; train < trainCount; ++train) {
+    const auto &trainPtr = catalog->getTrain(train);
+    const auto &route = trainPtr->getRoute();
+    TrainLoadProfile &profile = trains[train];
+    profile.capacity = trainPtr->getTotalCapacity();
+
+    // 停站及其在所属线路上的序号（不在线路上为-1）
+    std::vector<std::pair<EntityHandle, int>> stops;
+    if (!trainPtr->getSchedule().empty()) {
+      for (const auto &entry : trainPtr->getSchedule()) {
+        EntityHandle station = catalog->getStationHandle(entry.stationId);
+        if (station != INVALID_HANDLE) {
+          stops.emplace_back(station,
+                             route ? route->getStationIndex(entry.stationId)
+                                   : -1);
+        }
+      }
+    } else if (route) {
+      const auto &routeStations = route->getStations();
+      for (size_t i = 0; i < routeStations.size(); ++i) {
+        EntityHandle station =
+            routeStations[i]
+                ? catalog->getStationHandle(routeStations[i]->getStationId())
+                : INVALID_HANDLE;
+        if (station != INVALID_HANDLE) {
+          stops.emplace_back(station, static_cast<int>(i));
+        }
+      }
+    }
+    if (stops.size() < 2) {
+      continue;
+    }
+
+    // 相邻停站均在线路上时取沿线里程，否则取球面距离
+    profile.stops.reserve(stops.size());
+    profile.stopDistance.reserve(stops.size());
+    for (size_t i = 0; i < stops.size(); ++i) {
+      double distance = 0.0;
+      if (i > 0) {
+        if (stops[i - 1].second >= 0 && stops[i].second >= 0) {
+          distance = std::fabs(route->getCumulativeDistance(stops[i].second) -
+                               route->getCumulativeDistance(stops[i - 1].second));
+        } else {
+          distance = catalog->getStation(stops[i - 1].first)
+                         ->distanceTo(*catalog->getStation(stops[i].first));
+        }
+        distance += profile.stopDistance.back();
+      }
+      profile.stops.push_back(stops[i].first);
+      profile.stopDistance.push_back(distance);
+      stopLookup[train].emplace_back(stops[i].first, static_cast<int>(i));
+    }
+    std::sort(stopLookup[train].begin(), stopLookup[train].end());
+    profile.sectionLoads.assign(stops.size() - 1, 0);
+
+    // 区间登记（同一对站点不分方向共用一个区间）
+    profile.segments.reserve(stops.size() - 1);
+    for (size_t i = 0; i + 1 < stops.size(); ++i) {
+      EntityHandle from = profile.stops[i];
+      EntityHandle to = profile.stops[i + 1];
+      auto inserted = segmentByStations.emplace(
+          segmentKey(from, to), static_cast<int>(segments.size()));
+      if (inserted.second) {
+        SegmentLoad segment;
+        segment.fromStation = std::min(from, to);
+        segment.toStation = std::max(from, to);
+        segment.distance = profile.stopDistance[i + 1] - profile.stopDistance[i];
+        segments.push_back(segment);
+      }
+      SegmentLoad &segment = segments[inserted.first->second];
+      segment.trainCount++;
+      segment.capacity += profile.capacity;
+      profile.segments.push_back(inserted.first->second);
+    }
+  }
+}
+
+long long SectionLoadIndex::segmentKey(EntityHandle a, EntityHandle b) {
+  return (static_cast<long long>(std::min(a, b)) << 32) |
+         static_cast<unsigned int>(std::max(a, b));
+}
+
+int SectionLoadIndex::findStop(EntityHandle train, EntityHandle station) const {
+  const auto &lookup = stopLookup[train];
+  auto it = std::lower_bound(lookup.begin(), lookup.end(),
+                             std::make_pair(station, -1));
+  return (it != lookup.end() && it->first == station) ? it->second : -1;
+}
+
+int SectionLoadIndex::compute(const PassengerFlow &passengerFlow,
+                              const Date &date) {
+  matchedRecords = 0;
+  unmatchedRecords = 0;
+  for (auto &profile : trains) {
+    std::fill(profile.sectionLoads.begin(), profile.sectionLoads.end(), 0);
+    profile.boarded = 0;
+  }
+
+  // 各停站的净上车人数暂存在sectionLoads中：终点站上车与始发站下车
+  // 不影响任何区间，不计入
+  for (const auto &record : passengerFlow.getRecords()) {
+    if (!(record.getDate() == date)) {
+      continue;
+    }
+    EntityHandle train = catalog->getTrainHandle(record.getTrainId());
+    EntityHandle station = train != INVALID_HANDLE
+                               ? catalog->getStationHandle(record.getStationId())
+                               : INVALID_HANDLE;
+    int stop = station != INVALID_HANDLE ? findStop(train, station) : -1;
+    if (stop < 0) {
+      unmatchedRecords++;
+      continue;
+    }
+    matchedRecords++;
+    TrainLoadProfile &profile = trains[train];
+    if (stop < static_cast<int>(profile.sectionLoads.size())) {
+      profile.sectionLoads[stop] += record.getBoardingCount();
+      profile.boarded += record.getBoardingCount();
+    }
+    if (stop > 0 && stop < static_cast<int>(profile.sectionLoads.size())) {
+      profile.sectionLoads[stop] -= record.getAlightingCount();
+    }
+  }
+
+  // 按停站顺序求前缀和得到车上人数；下车多于在车人数视为数据误差，截断为0
+  parallelFor(
+      trains.size(),
+      [this](size_t begin, size_t end, unsigned) {
+        for (size_t t = begin; t < end; ++t) {
+          TrainLoadProfile &profile = trains[t];
+          profile.peakLoad = 0;
+          profile.peakSection = -1;
+          profile.passengerKm = 0.0;
+          int onboard = 0;
+          for (size_t i = 0; i < profile.sectionLoads.size(); ++i) {
+            onboard = std::max(0, onboard + profile.sectionLoads[i]);
+            profile.sectionLoads[i] = onboard;
+            profile.passengerKm +=
+                onboard * (profile.stopDistance[i + 1] - profile.stopDistance[i]);
+            if (onboard > profile.peakLoad) {
+              profile.peakLoad = onboard;
+              profile.peakSection = static_cast<int>(i);
+            }
+          }
+        }
+      },
+      64);
+
+  for (auto &segment : segments) {
+    segment.passengers = 0;
+    segment.peakLoad = 0;
+    segment.peakTrain = INVALID_HANDLE;
+    segment.passengerKm = 0.0;
+  }
+  for (EntityHandle train = 0; train < static_cast<int>(trains.size());
+       ++train) {
+    const TrainLoadProfile &profile = trains[train];
+    for (size_t i = 0; i < profile.sectionLoads.size(); ++i) {
+      int load = profile.sectionLoads[i];
+      SegmentLoad &segment = segments[profile.segments[i]];
+      segment.passengers += load;
+      segment.passengerKm += load * segment.distance;
+      if (load > segment.peakLoad) {
+        segment.peakLoad = load;
+        segment.peakTrain = train;
+      }
+    }
+  }
+  return matchedRecords;
+}
+
+const SegmentLoad *SectionLoadIndex::findSegment(EntityHandle a,
+                                                 EntityHandle b) const {
+  auto it = segmentByStations.find(segmentKey(a, b));
+  return (it != segmentByStations.end()) ? &segments[it->second] : nullptr;
+}
+
+std::vector<SegmentLoad> SectionLoadIndex::getBusiestSegments(size_t k) const {
+  std::vector<SegmentLoad> ranking(segments);
+  k = std::min(k, ranking.size());
+  std::partial_sort(ranking.begin(), ranking.begin() + k, ranking.end(),
+                    [](const SegmentLoad &a, const SegmentLoad &b) {
+                      return a.getLoadFactor() > b.getLoadFactor();
+                    });
+  ranking.resize(k);
+  return ranking;
+}
+
+std::map<std::string, double> SectionLoadIndex::getLoadFactors() const {
+  std::map<std::string, double> loadFactors;
+  for (EntityHandle train = 0; train < static_cast<int>(trains.size());
+       ++train) {
+    if (trains[train].boarded > 0) {
+      loadFactors[catalog->getTrain(train)->getTrainId()] =
+          trains[train].getPeakLoadFactor() * 100.0;
+    }
+  }
+  return loadFactors;
+}
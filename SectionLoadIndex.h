@@ -0,0 +1,107 @@
+#ifndef SECTIONLOADINDEX_H
+#define SECTIONLOADINDEX_H
+
+#include "EntityCatalog.h"
+#include "PassengerFlow.h"
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// 单列车沿停站顺序的断面客流
+struct TrainLoadProfile {
+  int capacity;
+  std::vector<EntityHandle> stops;  // 停站（按顺序）
+  std::vector<double> stopDistance; // 始发站至各停站的里程（公里）
+  std::vector<int> segments;        // 第i区间在区间索引中的下标
+  std::vector<int> sectionLoads;    // 第i区间stops[i]->stops[i+1]的车上人数
+  int boarded;
+  int peakLoad;
+  int peakSection; // 无客流时为-1
+  double passengerKm;
+
+  TrainLoadProfile()
+      : capacity(0), boarded(0), peakLoad(0), peakSection(-1),
+        passengerKm(0.0) {}
+  double getLength() const {
+    return stopDistance.empty() ? 0.0 : stopDistance.back();
+  }
+  // 最大断面满载率
+  double getPeakLoadFactor() const {
+    return capacity > 0 ? static_cast<double>(peakLoad) / capacity : 0.0;
+  }
+  // 平均满载率：人公里 / 座公里
+  double getAverageLoadFactor() const {
+    double seatKm = capacity * getLength();
+    return seatKm > 0 ? passengerKm / seatKm : 0.0;
+  }
+};
+
+// 线路区间（两站之间，不分方向）上全部列车的断面客流汇总
+struct SegmentLoad {
+  EntityHandle fromStation; // fromStation < toStation
+  EntityHandle toStation;
+  double distance;
+  int trainCount;     // 经过的列车数（双向）
+  long long capacity; // 经过列车的定员之和
+  long long passengers;
+  int peakLoad; // 单列车最大断面客流
+  EntityHandle peakTrain;
+  double passengerKm;
+
+  SegmentLoad()
+      : fromStation(INVALID_HANDLE), toStation(INVALID_HANDLE), distance(0.0),
+        trainCount(0), capacity(0), passengers(0), peakLoad(0),
+        peakTrain(INVALID_HANDLE), passengerKm(0.0) {}
+  double getLoadFactor() const {
+    return capacity > 0 ? static_cast<double>(passengers) / capacity : 0.0;
+  }
+};
+
+// 区间客流索引：构造时整理各列车停站、里程与所经区间，compute按日期
+// 把客流记录计入停站，以停站顺序的前缀和（累计上车减下车）得到各区间
+// 车上人数，再按区间汇总。停站结构可在多个日期间复用
+class SectionLoadIndex {
+private:
+  std::shared_ptr<const EntityCatalog> catalog;
+  std::vector<TrainLoadProfile> trains; // 按列车句柄
+  // 各列车(站点句柄, 停站序号)，按站点句柄排序
+  std::vector<std::vector<std::pair<EntityHandle, int>>> stopLookup;
+  std::vector<SegmentLoad> segments;
+  std::unordered_map<long long, int> segmentByStations;
+  int matchedRecords;
+  int unmatchedRecords;
+
+public:
+  // 构造函数（列车有时刻表时按时刻表停站，否则按所属线路全部站点）
+  explicit SectionLoadIndex(std::shared_ptr<const EntityCatalog> entityCatalog);
+
+  // 计算指定日期的断面客流，返回计入的记录数
+  int compute(const PassengerFlow &passengerFlow, const Date &date);
+
+  const std::vector<TrainLoadProfile> &getTrainProfiles() const {
+    return trains;
+  }
+  const TrainLoadProfile &getTrainProfile(EntityHandle train) const {
+    return trains[train];
+  }
+  const std::vector<SegmentLoad> &getSegments() const { return segments; }
+  // 两站间区间（不分方向），不存在返回nullptr
+  const SegmentLoad *findSegment(EntityHandle a, EntityHandle b) const;
+  // 满载率最高的k个区间
+  std::vector<SegmentLoad> getBusiestSegments(size_t k) const;
+  // 有客流的列车：列车号 -> 最大断面满载率（%）
+  std::map<std::string, double> getLoadFactors() const;
+
+  int getMatchedRecords() const { return matchedRecords; }
+  // 列车或站点不在目录、或站点不在该列车停站中的记录数
+  int getUnmatchedRecords() const { return unmatchedRecords; }
+
+private:
+  static long long segmentKey(EntityHandle a, EntityHandle b);
+  int findStop(EntityHandle train, EntityHandle station) const;
+};
+
+#endif // SECTIONLOADINDEX_H
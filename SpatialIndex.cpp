@@ -0,0 +1,200 @@
+#include "SpatialIndex.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const double EARTH_RADIUS_KM = 6371.0;
+const double PI = 3.14159265358979323846;
+const double TO_RADIANS = PI / 180.0;
+
+typedef SpatialIndex::Neighbor Neighbor;
+
+double coordinate(const SpatialPoint &point, int axis) {
+  return (axis == 0) ? point.longitude : point.latitude;
+}
+
+// 查询点到分割线另一侧任意点的球面距离下界：
+// 纬线取纬度差，经线取到该经线所在大圆的距离
+double splitLowerBound(double longitude, double latitude, int axis,
+                       double split) {
+  if (axis == 1) {
+    return std::abs(latitude - split) * TO_RADIANS * EARTH_RADIUS_KM;
+  }
+  double dLon = std::abs(longitude - split) * TO_RADIANS;
+  if (dLon >= PI / 2) {
+    return 0.0;
+  }
+  return EARTH_RADIUS_KM *
+         std::asin(std::min(1.0, std::sin(dLon) *
+                                     std::cos(latitude * TO_RADIANS)));
+}
+
+bool byDistance(const Neighbor &a, const Neighbor &b) {
+  return a.second < b.second;
+}
+
+struct Query {
+  const std::vector<SpatialPoint> &points;
+  double longitude;
+  double latitude;
+
+  double distanceTo(const SpatialPoint &point) const {
+    return Station::sphericalDistance(longitude, latitude, point.longitude,
+                                      point.latitude);
+  }
+
+  // best为按距离的大顶堆，保存当前最近的k个
+  void nearest(size_t lo, size_t hi, int axis, size_t k,
+               std::vector<Neighbor> &best) const {
+    if (lo >= hi) {
+      return;
+    }
+    size_t mid = lo + (hi - lo) / 2;
+    const SpatialPoint &point = points[mid];
+    double distance = distanceTo(point);
+    if (best.size() < k) {
+      best.emplace_back(point.station, distance);
+      std::push_heap(best.begin(), best.end(), byDistance);
+    } else if (distance < best.front().second) {
+      std::pop_heap(best.begin(), best.end(), byDistance);
+      best.back() = Neighbor(point.station, distance);
+      std::push_heap(best.begin(), best.end(), byDistance);
+    }
+
+    double split = coordinate(point, axis);
+    bool leftFirst = (axis == 0 ? longitude : latitude) < split;
+    int next = 1 - axis;
+    if (leftFirst) {
+      nearest(lo, mid, next, k, best);
+    } else {
+      nearest(mid + 1, hi, next, k, best);
+    }
+    double bound = splitLowerBound(longitude, latitude, axis, split);
+    if (best.size() < k || bound < best.front().second) {
+      if (leftFirst) {
+        nearest(mid + 1, hi, next, k, best);
+      } else {
+        nearest(lo, mid, next, k, best);
+      }
+    }
+  }
+
+  void withinRadius(size_t lo, size_t hi, int axis, double radiusKm,
+                    std::vector<Neighbor> &found) const {
+    if (lo >= hi) {
+      return;
+    }
+    size_t mid = lo + (hi - lo) / 2;
+    const SpatialPoint &point = points[mid];
+    double distance = distanceTo(point);
+    if (distance <= radiusKm) {
+      found.emplace_back(point.station, distance);
+    }
+
+    double split = coordinate(point, axis);
+    bool leftSide = (axis == 0 ? longitude : latitude) < split;
+    bool reachOther =
+        splitLowerBound(longitude, latitude, axis, split) <= radiusKm;
+    int next = 1 - axis;
+    if (leftSide || reachOther) {
+      withinRadius(lo, mid, next, radiusKm, found);
+    }
+    if (!leftSide || reachOther) {
+      withinRadius(mid + 1, hi, next, radiusKm, found);
+    }
+  }
+};
+
+void boxSearch(const std::vector<SpatialPoint> &points, size_t lo, size_t hi,
+               int axis, const double minCorner[2], const double maxCorner[2],
+               std::vector<EntityHandle> &found) {
+  if (lo >= hi) {
+    return;
+  }
+  size_t mid = lo + (hi - lo) / 2;
+  const SpatialPoint &point = points[mid];
+  if (point.longitude >= minCorner[0] && point.longitude <= maxCorner[0] &&
+      point.latitude >= minCorner[1] && point.latitude <= maxCorner[1]) {
+    found.push_back(point.station);
+  }
+
+  double split = coordinate(point, axis);
+  if (split >= minCorner[axis]) {
+    boxSearch(points, lo, mid, 1 - axis, minCorner, maxCorner, found);
+  }
+  if (split <= maxCorner[axis]) {
+    boxSearch(points, mid + 1, hi, 1 - axis, minCorner, maxCorner, found);
+  }
+}
+
+} // namespace
+
+// 构造函数
+SpatialIndex::SpatialIndex(const EntityCatalog &catalog) {
+  points.reserve(catalog.getStationCount());
+  for (EntityHandle handle = 0; handle < catalog.getStationCount(); ++handle) {
+    const auto &station = catalog.getStation(handle);
+    if (station->getLongitude() == 0.0 && station->getLatitude() == 0.0) {
+      continue;
+    }
+    points.push_back(
+        {station->getLongitude(), station->getLatitude(), handle});
+  }
+  build(0, points.size(), 0);
+}
+
+// 以中位数递归划分
+void SpatialIndex::build(size_t lo, size_t hi, int axis) {
+  if (hi - lo <= 1) {
+    return;
+  }
+  size_t mid = lo + (hi - lo) / 2;
+  std::nth_element(points.begin() + lo, points.begin() + mid,
+                   points.begin() + hi,
+                   [axis](const SpatialPoint &a, const SpatialPoint &b) {
+                     return coordinate(a, axis) < coordinate(b, axis);
+                   });
+  build(lo, mid, 1 - axis);
+  build(mid + 1, hi, 1 - axis);
+}
+
+std::vector<SpatialIndex::Neighbor>
+SpatialIndex::nearest(double longitude, double latitude, size_t k) const {
+  std::vector<Neighbor> best;
+  if (k == 0) {
+    return best;
+  }
+  best.reserve(std::min(k, points.size()));
+  Query query{points, longitude, latitude};
+  query.nearest(0, points.size(), 0, k, best);
+  std::sort_heap(best.begin(), best.end(), byDistance);
+  return best;
+}
+
+EntityHandle SpatialIndex::nearestStation(double longitude,
+                                          double latitude) const {
+  auto best = nearest(longitude, latitude, 1);
+  return best.empty() ? INVALID_HANDLE : best.front().first;
+}
+
+std::vector<SpatialIndex::Neighbor>
+SpatialIndex::withinRadius(double longitude, double latitude,
+                           double radiusKm) const {
+  std::vector<Neighbor> found;
+  Query query{points, longitude, latitude};
+  query.withinRadius(0, points.size(), 0, radiusKm, found);
+  std::sort(found.begin(), found.end(), byDistance);
+  return found;
+}
+
+std::vector<EntityHandle> SpatialIndex::withinBox(double minLongitude,
+                                                  double minLatitude,
+                                                  double maxLongitude,
+                                                  double maxLatitude) const {
+  std::vector<EntityHandle> found;
+  const double minCorner[2] = {minLongitude, minLatitude};
+  const double maxCorner[2] = {maxLongitude, maxLatitude};
+  boxSearch(points, 0, points.size(), 0, minCorner, maxCorner, found);
+  return found;
+}
@@ -0,0 +1,46 @@
+#ifndef SPATIALINDEX_H
+#define SPATIALINDEX_H
+
+#include "EntityCatalog.h"
+#include <utility>
+#include <vector>
+
+// 站点坐标点
+struct SpatialPoint {
+  double longitude;
+  double latitude;
+  EntityHandle station;
+};
+
+// 站点坐标的二维k-d树（经度、纬度交替划分，隐式存储于数组）。
+// 距离均为球面距离（公里），按分割线的球面距离下界剪枝
+class SpatialIndex {
+private:
+  std::vector<SpatialPoint> points; // 子树[lo, hi)的根为(lo+hi)/2
+
+public:
+  typedef std::pair<EntityHandle, double> Neighbor; // 站点句柄与距离（公里）
+
+  // 由目录中全部站点构建（经纬度均为0的站点视为无坐标而跳过）
+  explicit SpatialIndex(const EntityCatalog &catalog);
+
+  size_t size() const { return points.size(); }
+
+  // 最近的k个站点，按距离升序
+  std::vector<Neighbor> nearest(double longitude, double latitude,
+                                size_t k) const;
+  // 最近站点，索引为空时返回INVALID_HANDLE
+  EntityHandle nearestStation(double longitude, double latitude) const;
+  // 半径内的站点，按距离升序
+  std::vector<Neighbor> withinRadius(double longitude, double latitude,
+                                     double radiusKm) const;
+  // 经纬度矩形内的站点（含边界），用于地图视窗裁剪
+  std::vector<EntityHandle> withinBox(double minLongitude, double minLatitude,
+                                      double maxLongitude,
+                                      double maxLatitude) const;
+
+private:
+  void build(size_t lo, size_t hi, int axis);
+};
+
+#endif // SPATIALINDEX_H
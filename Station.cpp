@@ -1,4 +1,6 @@
 #include "Station.h"
+#include <algorithm>
+#include <cmath>
 #include <sstream>
 
 // 默认构造函数
@@ -27,6 +29,29 @@ std::string Station::toString() const {
   return oss.str();
 }
 
+// 两站间球面距离（haversine公式）
+double Station::distanceTo(const Station &other) const {
+  return sphericalDistance(longitude, latitude, other.longitude,
+                           other.latitude);
+}
+
+// 两个经纬度点之间的球面距离（公里）
+double Station::sphericalDistance(double lng1, double lat1, double lng2,
+                                  double lat2) {
+  const double earthRadiusKm = 6371.0;
+  const double toRadians = 3.14159265358979323846 / 180.0;
+
+  double phi1 = lat1 * toRadians;
+  double phi2 = lat2 * toRadians;
+  double dLat = phi2 - phi1;
+  double dLon = (lng2 - lng1) * toRadians;
+
+  double a = std::sin(dLat / 2) * std::sin(dLat / 2) +
+             std::cos(phi1) * std::cos(phi2) * std::sin(dLon / 2) *
+                 std::sin(dLon / 2);
+  return 2.0 * earthRadiusKm * std::asin(std::sqrt(std::min(1.0, a)));
+}
+
 // 比较操作符
 bool Station::operator==(const Station &other) const {
   return stationId == other.stationId;
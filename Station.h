@@ -13,8 +13,9 @@ private:
   double longitude;        // 经度
   double latitude;         // 纬度
   std::string stationType; // 站点类型（起始站、中间站、终点站）
-  int platformCount;       // 站台数量
+  int platformCount;       // 站台数量，0为未知
   bool isTransferStation;  // 是否为换乘站
+  std::string stationCode; // 原始数据中的站点编号（线路文件按此关联）
 
 public:
   // 构造函数
@@ -28,14 +29,15 @@ public:
   ~Station();
 
   // Getter方法
-  std::string getStationId() const { return stationId; }
-  std::string getStationName() const { return stationName; }
-  std::string getCityName() const { return cityName; }
+  const std::string &getStationId() const { return stationId; }
+  const std::string &getStationName() const { return stationName; }
+  const std::string &getCityName() const { return cityName; }
   double getLongitude() const { return longitude; }
   double getLatitude() const { return latitude; }
-  std::string getStationType() const { return stationType; }
+  const std::string &getStationType() const { return stationType; }
   int getPlatformCount() const { return platformCount; }
   bool getIsTransferStation() const { return isTransferStation; }
+  const std::string &getStationCode() const { return stationCode; }
 
   // Setter方法
   void setStationId(const std::string &id) { stationId = id; }
@@ -46,9 +48,13 @@ public:
   void setStationType(const std::string &type) { stationType = type; }
   void setPlatformCount(int count) { platformCount = count; }
   void setIsTransferStation(bool transfer) { isTransferStation = transfer; }
+  void setStationCode(const std::string &code) { stationCode = code; }
 
   // 功能方法
   std::string toString() const;
+  double distanceTo(const Station &other) const; // 球面距离（公里）
+  static double sphericalDistance(double lng1, double lat1, double lng2,
+                                  double lat2);
   bool operator==(const Station &other) const;
 };
 
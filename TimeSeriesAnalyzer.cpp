@@ -1,4 +1,5 @@
 #include "TimeSeriesAnalyzer.h"
+#include "NetworkCentrality.h"
 #include <algorithm>
 #include <cmath>
 #include <iostream>
@@ -7,20 +8,23 @@
 
 
 // 构造函数
-TimeSeriesAnalyzer::TimeSeriesAnalyzer() : passengerFlow(nullptr) {}
+TimeSeriesAnalyzer::TimeSeriesAnalyzer()
+    : passengerFlow(nullptr), catalog(EntityCatalog::empty()) {}
 
-TimeSeriesAnalyzer::TimeSeriesAnalyzer(std::shared_ptr<PassengerFlow> flow)
-    : passengerFlow(flow) {}
+TimeSeriesAnalyzer::TimeSeriesAnalyzer(
+    std::shared_ptr<PassengerFlow> flow,
+    std::shared_ptr<const EntityCatalog> entityCatalog)
+    : passengerFlow(flow),
+      catalog(entityCatalog ? entityCatalog : EntityCatalog::empty()) {}
 
 // 设置数据
 void TimeSeriesAnalyzer::setPassengerFlow(std::shared_ptr<PassengerFlow> flow) {
   passengerFlow = flow;
 }
 
-void TimeSeriesAnalyzer::addStation(std::shared_ptr<Station> station) {
-  if (station) {
-    stations.push_back(station);
-  }
+void TimeSeriesAnalyzer::setCatalog(
+    std::shared_ptr<const EntityCatalog> entityCatalog) {
+  catalog = entityCatalog ? entityCatalog : EntityCatalog::empty();
 }
 
 // ========== 高级时间序列预测实现 ==========
@@ -216,6 +220,7 @@ TimeSeriesAnalyzer::predictWithEnsemble(const std::string &stationId,
 // ========== 聚类分析实现 ==========
 
 ClusterAnalysis TimeSeriesAnalyzer::clusterStationsByFlowPattern(int k) {
+  const auto &stations = catalog->getStations();
   ClusterAnalysis result;
 
   if (!passengerFlow || stations.empty()) {
@@ -226,7 +231,8 @@ ClusterAnalysis TimeSeriesAnalyzer::clusterStationsByFlowPattern(int k) {
   std::vector<std::vector<double>> features;
   std::vector<std::string> stationNames;
 
-  for (const auto &station : stations) {
+  for (EntityHandle handle = 0; handle < catalog->getStationCount(); ++handle) {
+    const auto &station = catalog->getStation(handle);
     std::vector<double> feature;
 
     // 特征1: 总客流量
@@ -236,8 +242,8 @@ ClusterAnalysis TimeSeriesAnalyzer::clusterStationsByFlowPattern(int k) {
     // 特征2: 平台数量
     feature.push_back(static_cast<double>(station->getPlatformCount()));
 
-    // 特征3: 是否换乘站
-    feature.push_back(station->getIsTransferStation() ? 1.0 : 0.0);
+    // 特征3: 是否换乘站（含多线路经停）
+    feature.push_back(catalog->isTransferStation(handle) ? 1.0 : 0.0);
 
     features.push_back(feature);
     stationNames.push_back(station->getStationName());
@@ -265,6 +271,7 @@ ClusterAnalysis TimeSeriesAnalyzer::clusterStationsByFlowPattern(int k) {
 }
 
 ClusterAnalysis TimeSeriesAnalyzer::clusterStationsByTimePattern(int k) {
+  const auto &stations = catalog->getStations();
   ClusterAnalysis result;
 
   if (!passengerFlow || stations.empty()) {
@@ -315,6 +322,7 @@ ClusterAnalysis TimeSeriesAnalyzer::clusterStationsByTimePattern(int k) {
 // ========== 模式挖掘实现 ==========
 
 std::map<std::string, double> TimeSeriesAnalyzer::mineTemporalPatterns() {
+  const auto &stations = catalog->getStations();
   std::map<std::string, double> patterns;
 
   if (!passengerFlow || stations.empty()) {
@@ -366,6 +374,7 @@ std::map<std::string, double> TimeSeriesAnalyzer::mineTemporalPatterns() {
 }
 
 std::map<std::string, double> TimeSeriesAnalyzer::mineSpatialPatterns() {
+  const auto &stations = catalog->getStations();
   std::map<std::string, double> patterns;
 
   if (!passengerFlow || stations.empty()) {
@@ -412,7 +421,7 @@ std::vector<std::string> TimeSeriesAnalyzer::detectAnomalousPatterns() {
   }
 
   // 检测异常客流模式
-  for (const auto &station : stations) {
+  for (const auto &station : catalog->getStations()) {
     auto timeSeriesData = getTimeSeriesData(station->getStationId(), 7);
 
     if (timeSeriesData.size() >= 3) {
@@ -444,6 +453,7 @@ std::vector<std::string> TimeSeriesAnalyzer::detectAnomalousPatterns() {
 
 std::map<std::pair<std::string, std::string>, double>
 TimeSeriesAnalyzer::analyzeStationCorrelations() {
+  const auto &stations = catalog->getStations();
   std::map<std::pair<std::string, std::string>, double> correlations;
 
   if (!passengerFlow || stations.size() < 2) {
@@ -479,23 +489,39 @@ std::map<std::string, double> TimeSeriesAnalyzer::analyzeTransferEfficiency() {
   }
 
   // 分析换乘站的效率
-  for (const auto &station : stations) {
-    if (station->getIsTransferStation()) {
-      int totalFlow =
-          passengerFlow->getStationTotalFlow(station->getStationId());
-      int platformCount = station->getPlatformCount();
-
-      // 简单的效率指标：客流/平台数
-      double efficiencyRatio =
-          platformCount > 0 ? static_cast<double>(totalFlow) / platformCount
-                            : 0.0;
-      efficiency[station->getStationName()] = efficiencyRatio;
-    }
+  for (EntityHandle handle : catalog->getTransferStations()) {
+    const auto &station = catalog->getStation(handle);
+    int totalFlow = passengerFlow->getStationTotalFlow(station->getStationId());
+    int platformCount = station->getPlatformCount();
+
+    // 简单的效率指标：客流/平台数
+    double efficiencyRatio =
+        platformCount > 0 ? static_cast<double>(totalFlow) / platformCount
+                          : 0.0;
+    efficiency[station->getStationName()] = efficiencyRatio;
   }
 
   return efficiency;
 }
 
+// 各连通站点按里程加权的归一化介数中心性
+std::map<std::string, double> TimeSeriesAnalyzer::analyzeNetworkCentrality() {
+  std::map<std::string, double> centrality;
+
+  RailNetwork network(catalog);
+  BetweennessResult betweenness =
+      NetworkCentrality(network).betweenness(true);
+  for (EntityHandle station = 0; station < network.getNodeCount();
+       ++station) {
+    if (network.getDegree(station) > 0) {
+      centrality[catalog->getStation(station)->getStationName()] =
+          betweenness.normalized[station];
+    }
+  }
+
+  return centrality;
+}
+
 // ========== 决策支持实现 ==========
 
 std::vector<std::string> TimeSeriesAnalyzer::generateCapacityRecommendations() {
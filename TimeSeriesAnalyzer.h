@@ -1,6 +1,7 @@
 #ifndef TIMESERIESANALYZER_H
 #define TIMESERIESANALYZER_H
 
+#include "EntityCatalog.h"
 #include "PassengerFlow.h"
 #include "Station.h"
 #include <map>
@@ -33,16 +34,18 @@ struct ClusterAnalysis {
 class TimeSeriesAnalyzer {
 private:
   std::shared_ptr<PassengerFlow> passengerFlow;
-  std::vector<std::shared_ptr<Station>> stations;
+  std::shared_ptr<const EntityCatalog> catalog; // 共享只读实体目录
 
 public:
   // 构造函数
   TimeSeriesAnalyzer();
-  explicit TimeSeriesAnalyzer(std::shared_ptr<PassengerFlow> flow);
+  explicit TimeSeriesAnalyzer(
+      std::shared_ptr<PassengerFlow> flow,
+      std::shared_ptr<const EntityCatalog> entityCatalog = nullptr);
 
   // 设置数据
   void setPassengerFlow(std::shared_ptr<PassengerFlow> flow);
-  void addStation(std::shared_ptr<Station> station);
+  void setCatalog(std::shared_ptr<const EntityCatalog> entityCatalog);
 
   // ========== 高级时间序列预测 ==========
 
@@ -0,0 +1,445 @@
+#include "TimetableGenerator.h"
+#include "ParallelUtils.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <tuple>
+#include <unordered_map>
+
+namespace {
+
+const int MINUTES_PER_DAY = 24 * 60;
+
+// 列车类型名与车次字母的对应
+const struct {
+  const char *name;
+  char code;
+} TYPE_NAMES[] = {{"高铁", 'G'}, {"动车", 'D'}, {"城际", 'C'},
+                  {"快速", 'K'}, {"特快", 'T'}};
+
+TimePoint toTimePoint(int minute) {
+  return TimePoint(minute / 60 % 24, minute % 60);
+}
+
+// 占用时段[begin, end)，begin为当日分钟
+struct Span {
+  int begin;
+  int end;
+};
+
+// 按开始时刻排序的占用时段
+class SpanList {
+private:
+  std::vector<Span> spans;
+  int maxLength = 0;
+
+public:
+  void insert(const Span &span) {
+    auto position = std::upper_bound(
+        spans.begin(), spans.end(), span.begin,
+        [](int begin, const Span &other) { return begin < other.begin; });
+    spans.insert(position, span);
+    maxLength = std::max(maxLength, span.end - span.begin);
+  }
+
+  // 时刻表按日循环：对平移一天（或不平移）后开始时刻落在开区间
+  // (from - maxLength, to)内的时段调用visit(平移后的时段)，
+  // 与[from, to)有交集的时段都在其中
+  template <typename Visit> void visitNear(int from, int to, Visit visit) const {
+    for (int shift = -MINUTES_PER_DAY; shift <= MINUTES_PER_DAY;
+         shift += MINUTES_PER_DAY) {
+      int low = from - maxLength - shift;
+      auto it = std::upper_bound(
+          spans.begin(), spans.end(), low,
+          [](int begin, const Span &other) { return begin < other.begin; });
+      for (; it != spans.end() && it->begin + shift < to; ++it) {
+        visit(Span{it->begin + shift, it->end + shift});
+      }
+    }
+  }
+};
+
+// 站台：a与b重叠时返回使a不再与b重叠所需推迟的分钟数，不重叠返回0
+int overlapDelay(const Span &a, const Span &b) {
+  return (a.begin < b.end && b.begin < a.end) ? b.end - a.begin : 0;
+}
+
+// 同一有向区间：进入或离开的间隔小于headway，或进入与离开顺序颠倒
+// （越行）。对运行时长固定的a，冲突的进入时刻恰为开区间(lo, hi)，
+// 返回推迟到hi所需的分钟数，不冲突返回0
+int headwayDelay(const Span &a, const Span &b, int headway) {
+  int sameExit = b.end - (a.end - a.begin); // 与b同时离开时a的进入时刻
+  int lo = std::min(b.begin, sameExit) - headway;
+  int hi = std::max(b.begin, sameExit) + headway;
+  return (lo < a.begin && a.begin < hi) ? hi - a.begin : 0;
+}
+
+} // namespace
+
+// 构造函数
+TimetableGenerator::TimetableGenerator(int first, int last, int minHeadway)
+    : profiles{{350.0, 0.5, 0.6, 2, 3},  // G
+               {250.0, 0.5, 0.6, 2, 2},  // D
+               {200.0, 0.6, 0.7, 1, 1},  // C
+               {120.0, 0.3, 0.4, 4, 2},  // K
+               {140.0, 0.3, 0.4, 4, 3},  // T
+               {100.0, 0.25, 0.35, 3, 1}}, // 普通
+      firstDeparture(first), lastDeparture(std::max(first, last)),
+      minHeadwayMinutes(std::max(0, minHeadway)) {}
+
+int TimetableGenerator::profileIndex(char typeCode) {
+  switch (typeCode) {
+  case 'G':
+    return 0;
+  case 'D':
+    return 1;
+  case 'C':
+    return 2;
+  case 'K':
+    return 3;
+  case 'T':
+    return 4;
+  default:
+    return PROFILE_COUNT - 1;
+  }
+}
+
+int TimetableGenerator::profileIndex(const Train &train) {
+  const std::string &type = train.getTrainType();
+  if (type.size() == 1) {
+    return profileIndex(type[0]);
+  }
+  for (const auto &entry : TYPE_NAMES) {
+    if (type == entry.name) {
+      return profileIndex(entry.code);
+    }
+  }
+  const std::string &code = train.getTrainId();
+  return code.empty() ? PROFILE_COUNT - 1 : profileIndex(code[0]);
+}
+
+void TimetableGenerator::setProfile(char typeCode,
+                                    const TrainTypeProfile &profile) {
+  profiles[profileIndex(typeCode)] = profile;
+}
+
+const TrainTypeProfile &TimetableGenerator::getProfile(char typeCode) const {
+  return profiles[profileIndex(typeCode)];
+}
+
+const TrainTypeProfile &TimetableGenerator::getProfile(const Train &train) const {
+  return profiles[profileIndex(train)];
+}
+
+// 距离不足以加速到最高速度时按三角形速度曲线计算
+double TimetableGenerator::sectionMinutes(double kilometres, double speed,
+                                          const TrainTypeProfile &profile) {
+  double distance = kilometres * 1000.0;
+  double velocity = speed / 3.6;
+  if (distance <= 0 || velocity <= 0) {
+    return 0.0;
+  }
+  double a = profile.acceleration;
+  double b = profile.deceleration;
+  if (a <= 0 || b <= 0) {
+    return distance / velocity / 60.0;
+  }
+  double ramp = velocity * velocity / (2 * a) + velocity * velocity / (2 * b);
+  if (distance >= ramp) {
+    return ((distance - ramp) / velocity + velocity / a + velocity / b) / 60.0;
+  }
+  double peak = std::sqrt(2 * distance * a * b / (a + b));
+  return (peak / a + peak / b) / 60.0;
+}
+
+// 中间站按在线路上的位次隔站停，stopOffset使同线同类列车错开停站
+TimetableGenerator::Template
+TimetableGenerator::buildTemplate(const Route &route, int profile,
+                                  bool reversed, int stopOffset) const {
+  const TrainTypeProfile &params = profiles[profile];
+  const auto &stations = route.getStations();
+  int count = static_cast<int>(stations.size());
+  double speed = route.getMaxSpeed() > 0
+                     ? std::min(params.maxSpeed,
+                                static_cast<double>(route.getMaxSpeed()))
+                     : params.maxSpeed;
+  int spacing = std::max(1, params.stopSpacing);
+
+  std::vector<int> candidates;
+  for (int k = 0; k < count; ++k) {
+    int index = reversed ? count - 1 - k : k;
+    if (stations[index]) {
+      candidates.push_back(index);
+    }
+  }
+
+  Template result;
+  if (candidates.size() < 2) {
+    return result;
+  }
+  int last = static_cast<int>(candidates.size()) - 1;
+  for (int p = 0; p <= last; ++p) {
+    if (p == 0 || p == last || (p + stopOffset) % spacing == 0) {
+      result.routeIndices.push_back(candidates[p]);
+    }
+  }
+
+  int minute = 0;
+  for (size_t i = 0; i < result.routeIndices.size(); ++i) {
+    if (i > 0) {
+      double kilometres =
+          std::abs(route.getCumulativeDistance(result.routeIndices[i]) -
+                   route.getCumulativeDistance(result.routeIndices[i - 1]));
+      double run = sectionMinutes(kilometres, speed, params);
+      minute += std::max(1, static_cast<int>(std::ceil(run - 1e-9)));
+    }
+    result.arrivals.push_back(minute);
+    if (i > 0 && i + 1 < result.routeIndices.size()) {
+      minute += params.dwellMinutes;
+    }
+    result.departures.push_back(minute);
+  }
+  return result;
+}
+
+std::vector<std::vector<ScheduleEntry>> TimetableGenerator::generate(
+    const std::vector<std::shared_ptr<Train>> &trains,
+    size_t *unresolved) const {
+  size_t trainCount = trains.size();
+  std::vector<std::vector<ScheduleEntry>> schedules(trainCount);
+
+  // 按线路分组，确定各列车的方向与发车时刻
+  std::unordered_map<const Route *, std::vector<size_t>> byRoute;
+  for (size_t i = 0; i < trainCount; ++i) {
+    const auto &route = trains[i] ? trains[i]->getRoute() : nullptr;
+    if (route && route->getStationCount() >= 2) {
+      byRoute[route.get()].push_back(i);
+    }
+  }
+
+  // 模板按(线路, 类型, 方向, 停站错位)共用
+  std::vector<Template> templates;
+  std::map<std::tuple<const Route *, int, bool, int>, size_t> templateIds;
+  std::vector<size_t> templateOf(trainCount, SIZE_MAX);
+  std::vector<int> departureOf(trainCount, 0);
+  int span = lastDeparture - firstDeparture;
+  for (const auto &group : byRoute) {
+    const auto &members = group.second;
+    int perDirection = static_cast<int>((members.size() + 1) / 2);
+    // 均匀分布的间隔小于最小间隔时按最小间隔发车
+    double step =
+        perDirection > 1 ? static_cast<double>(span) / (perDirection - 1) : 0.0;
+    step = std::max(step, static_cast<double>(minHeadwayMinutes));
+    for (size_t k = 0; k < members.size(); ++k) {
+      size_t i = members[k];
+      int slot = static_cast<int>(k / 2);
+      bool reversed = k % 2 == 1;
+      int profile = profileIndex(*trains[i]);
+      int stopOffset = slot % std::max(1, profiles[profile].stopSpacing);
+
+      auto key = std::make_tuple(group.first, profile, reversed, stopOffset);
+      auto inserted = templateIds.emplace(key, templates.size());
+      if (inserted.second) {
+        templates.push_back(
+            buildTemplate(*group.first, profile, reversed, stopOffset));
+      }
+      templateOf[i] = inserted.first->second;
+      departureOf[i] = firstDeparture + static_cast<int>(slot * step);
+    }
+  }
+
+  size_t conflicting =
+      resolveConflicts(trains, templates, templateOf, departureOf);
+  if (unresolved) {
+    *unresolved = conflicting;
+  }
+
+  // 逐车套用模板
+  parallelFor(
+      trainCount,
+      [&](size_t begin, size_t end, unsigned) {
+        for (size_t i = begin; i < end; ++i) {
+          if (templateOf[i] == SIZE_MAX) {
+            continue;
+          }
+          const Template &plan = templates[templateOf[i]];
+          const auto &stations = trains[i]->getRoute()->getStations();
+          int departure = departureOf[i] % MINUTES_PER_DAY;
+          auto &entries = schedules[i];
+          entries.reserve(plan.routeIndices.size());
+          for (size_t s = 0; s < plan.routeIndices.size(); ++s) {
+            const auto &station = stations[plan.routeIndices[s]];
+            entries.emplace_back(station->getStationId(),
+                                 station->getStationName(),
+                                 toTimePoint(departure + plan.arrivals[s]),
+                                 toTimePoint(departure + plan.departures[s]),
+                                 plan.departures[s] - plan.arrivals[s]);
+          }
+        }
+      },
+      64);
+  return schedules;
+}
+
+size_t TimetableGenerator::resolveConflicts(
+    const std::vector<std::shared_ptr<Train>> &trains,
+    const std::vector<Template> &templates, std::vector<size_t> &templateOf,
+    std::vector<int> &departureOf) const {
+  std::vector<size_t> order;
+  for (size_t i = 0; i < trains.size(); ++i) {
+    if (templateOf[i] != SIZE_MAX) {
+      order.push_back(i);
+    }
+  }
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return departureOf[a] < departureOf[b];
+  });
+
+  // 已铺画的区间占用与站台占用，时刻取当日分钟[0, 1440)起算
+  std::map<std::pair<const Station *, const Station *>, SpanList> segments;
+  std::unordered_map<const Station *, SpanList> platforms;
+  size_t conflicting = 0;
+
+  for (size_t i : order) {
+    const Template &plan = templates[templateOf[i]];
+    const auto &stations = trains[i]->getRoute()->getStations();
+    size_t stopCount = plan.routeIndices.size();
+    std::vector<SpanList *> segmentSpans(stopCount, nullptr);
+    std::vector<SpanList *> platformSpans(stopCount);
+    for (size_t s = 0; s < stopCount; ++s) {
+      const Station *station = stations[plan.routeIndices[s]].get();
+      platformSpans[s] = &platforms[station];
+      if (s > 0) {
+        segmentSpans[s] = &segments[{
+            stations[plan.routeIndices[s - 1]].get(), station}];
+      }
+    }
+
+    // 第s站（及到达该站的区间）在给定发车时刻下与已铺画列车冲突时，
+    // 返回至少需要推迟的分钟数（其间的发车时刻均冲突），不冲突返回0
+    auto stopDelay = [&](size_t s, int departure) {
+      int delay = 0;
+      if (s > 0) {
+        int enter = (departure + plan.departures[s - 1]) % MINUTES_PER_DAY;
+        Span run{enter, enter + plan.arrivals[s] - plan.departures[s - 1]};
+        // 冲突的对方进入时刻在(run.begin - 对方时长 - 间隔, run.end + 间隔)内
+        segmentSpans[s]->visitNear(
+            run.begin - minHeadwayMinutes, run.end + minHeadwayMinutes,
+            [&](const Span &other) {
+              delay =
+                  std::max(delay, headwayDelay(run, other, minHeadwayMinutes));
+            });
+      }
+      // 站台数未知（0）的车站不作站台约束
+      int platformCount = stations[plan.routeIndices[s]]->getPlatformCount();
+      if (platformCount > 0) {
+        int arrival = (departure + plan.arrivals[s]) % MINUTES_PER_DAY;
+        Span dwell{arrival, arrival + plan.departures[s] - plan.arrivals[s] +
+                                CLEARANCE_MINUTES};
+        // 站台已满时须推迟到最早离开的一列车清空之后
+        int occupied = 0;
+        int release = MINUTES_PER_DAY;
+        platformSpans[s]->visitNear(dwell.begin, dwell.end,
+                                    [&](const Span &other) {
+                                      int overlap = overlapDelay(dwell, other);
+                                      if (overlap > 0) {
+                                        occupied++;
+                                        release = std::min(release, overlap);
+                                      }
+                                    });
+        if (occupied >= platformCount) {
+          delay = std::max(delay, release);
+        }
+      }
+      return delay;
+    };
+
+    // 上次造成冲突的停站最可能再次冲突，先检查
+    size_t blocking = 0;
+    auto requiredDelay = [&](int departure) {
+      int delay = stopDelay(blocking, departure);
+      for (size_t s = 0; s < stopCount && delay == 0; ++s) {
+        if (s != blocking && (delay = stopDelay(s, departure)) > 0) {
+          blocking = s;
+        }
+      }
+      return delay;
+    };
+
+    int desired = departureOf[i];
+    int shift = 0;
+    for (int delay; shift < MINUTES_PER_DAY &&
+                    (delay = requiredDelay(desired + shift)) > 0;) {
+      shift += delay;
+    }
+    if (shift >= MINUTES_PER_DAY) {
+      templateOf[i] = SIZE_MAX;
+      conflicting++;
+      continue;
+    }
+    int departure = desired + shift;
+    departureOf[i] = departure;
+
+    for (size_t s = 0; s < stopCount; ++s) {
+      if (s > 0) {
+        int enter = (departure + plan.departures[s - 1]) % MINUTES_PER_DAY;
+        segmentSpans[s]->insert(
+            {enter, enter + plan.arrivals[s] - plan.departures[s - 1]});
+      }
+      int arrival = (departure + plan.arrivals[s]) % MINUTES_PER_DAY;
+      platformSpans[s]->insert(
+          {arrival, arrival + plan.departures[s] - plan.arrivals[s] +
+                        CLEARANCE_MINUTES});
+    }
+  }
+  return conflicting;
+}
+
+size_t TimetableGenerator::fillMissingSchedules(
+    const std::vector<std::shared_ptr<Train>> &trains) const {
+  std::vector<std::shared_ptr<Train>> unscheduled;
+  for (const auto &train : trains) {
+    if (train && train->getStopCount() == 0) {
+      unscheduled.push_back(train);
+    }
+  }
+
+  auto schedules = generate(unscheduled);
+  size_t filled = 0;
+  for (size_t i = 0; i < unscheduled.size(); ++i) {
+    if (schedules[i].empty()) {
+      continue;
+    }
+    for (const auto &entry : schedules[i]) {
+      unscheduled[i]->addScheduleEntry(entry);
+    }
+    unscheduled[i]->setSynthetic(true);
+    filled++;
+  }
+  return filled;
+}
+
+size_t TimetableGenerator::bindSyntheticRoutes(
+    const std::vector<std::shared_ptr<Train>> &trains,
+    const std::vector<std::shared_ptr<Route>> &routes) {
+  std::vector<std::shared_ptr<Route>> usable;
+  for (const auto &route : routes) {
+    if (route && route->getStationCount() >= 2) {
+      usable.push_back(route);
+    }
+  }
+  if (usable.empty()) {
+    return 0;
+  }
+
+  size_t bound = 0;
+  for (const auto &train : trains) {
+    if (train && !train->getRoute()) {
+      train->setRoute(usable[bound % usable.size()]);
+      train->setSynthetic(true);
+      bound++;
+    }
+  }
+  return bound;
+}
@@ -0,0 +1,98 @@
+#ifndef TIMETABLEGENERATOR_H
+#define TIMETABLEGENERATOR_H
+
+#include "Route.h"
+#include "Train.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+// 列车类型的运行参数
+struct TrainTypeProfile {
+  double maxSpeed;     // km/h，与线路最高速度取小
+  double acceleration; // 起动加速度（m/s²）
+  double deceleration; // 常用制动减速度（m/s²）
+  int dwellMinutes;    // 中间站停站时长
+  int stopSpacing;     // 每隔几站停一站（1为站站停），始发、终到站必停
+};
+
+// 批量时刻表生成：各线路上的列车按序号上下行交替，在
+// [firstDeparture, lastDeparture]内均匀发车（同向间隔不小于minHeadway）；
+// 按列车类型（G/D/C/K/T，其余按普通车）取速度、加减速与停站参数，相邻
+// 停站之间按"加速-匀速-制动"计算运行时分，向上取整到分钟。同一线路、
+// 类型、方向与停站组合的列车共用一份相对时刻模板。
+// 线路之间共用区间与车站，因此按期望发车时刻依次铺画：与已铺画列车在
+// 任一有向区间追踪间隔不足或越行、或停站时车站站台已满（只约束站台数
+// 已知的车站，源数据不含站台数时不作站台约束）时，发车直接顺延
+// 到消除该冲突所需的最少分钟（满足追踪间隔、或最早离站列车清空站台）
+// 后重新检查；一整天内找不到可行时刻的列车不生成时刻表，计入unresolved
+// （多为全程超过一天、途经大量共用区间的长线列车）。铺画为顺序过程，
+// 逐车套用模板生成时刻表按列车并行
+class TimetableGenerator {
+private:
+  // 相对始发的停站时刻（分钟）
+  struct Template {
+    std::vector<int> routeIndices; // 停站在线路上的序号，按运行方向
+    std::vector<int> arrivals;
+    std::vector<int> departures;
+  };
+
+  static constexpr int PROFILE_COUNT = 6; // G、D、C、K、T、普通
+
+  TrainTypeProfile profiles[PROFILE_COUNT];
+  int firstDeparture;
+  int lastDeparture;
+  int minHeadwayMinutes;
+
+public:
+  static constexpr int DEFAULT_FIRST_DEPARTURE = 6 * 60; // 06:00
+  static constexpr int DEFAULT_LAST_DEPARTURE = 22 * 60; // 22:00
+  static constexpr int DEFAULT_MIN_HEADWAY_MINUTES = 5;  // 区间最小追踪间隔
+  static constexpr int CLEARANCE_MINUTES = 2; // 列车离站后站台的清空时间
+
+  // 构造函数（使用各类型的默认参数）
+  explicit TimetableGenerator(int first = DEFAULT_FIRST_DEPARTURE,
+                              int last = DEFAULT_LAST_DEPARTURE,
+                              int minHeadway = DEFAULT_MIN_HEADWAY_MINUTES);
+
+  // typeCode为G、D、C、K、T，其他字符设置普通车参数
+  void setProfile(char typeCode, const TrainTypeProfile &profile);
+  const TrainTypeProfile &getProfile(char typeCode) const;
+  // 列车类型可为类型名（高铁、动车等）或车次字母，均不符时取车次首字母
+  const TrainTypeProfile &getProfile(const Train &train) const;
+
+  // 站间运行分钟（两端停车）；speed为实际最高速度（km/h）
+  static double sectionMinutes(double kilometres, double speed,
+                               const TrainTypeProfile &profile);
+
+  // 按trains的顺序返回生成的时刻表，无线路、线路少于两站或无法无冲突
+  // 铺画的列车为空；unresolved非空时写入无法铺画的列车数
+  std::vector<std::vector<ScheduleEntry>>
+  generate(const std::vector<std::shared_ptr<Train>> &trains,
+           size_t *unresolved = nullptr) const;
+  // 为尚无时刻表的列车生成并写入，返回写入的列车数
+  // （无法铺画的列车保持无时刻表）。写入的列车标记为合成
+  size_t fillMissingSchedules(
+      const std::vector<std::shared_ptr<Train>> &trains) const;
+
+  // 可选步骤：列车表不含运行线路，为未绑定线路的列车按顺序轮流分配到
+  // 至少有两站的线路上（同一输入结果相同），分配的线路并非真实运行线路，
+  // 列车标记为合成。返回绑定的列车数
+  static size_t bindSyntheticRoutes(
+      const std::vector<std::shared_ptr<Train>> &trains,
+      const std::vector<std::shared_ptr<Route>> &routes);
+
+private:
+  static int profileIndex(char typeCode);
+  static int profileIndex(const Train &train);
+  Template buildTemplate(const Route &route, int profile, bool reversed,
+                         int stopOffset) const;
+  // 按期望发车时刻依次铺画，顺延departureOf使列车之间无冲突；
+  // 找不到可行时刻的列车templateOf置为SIZE_MAX，返回其数量
+  size_t resolveConflicts(const std::vector<std::shared_ptr<Train>> &trains,
+                          const std::vector<Template> &templates,
+                          std::vector<size_t> &templateOf,
+                          std::vector<int> &departureOf) const;
+};
+
+#endif // TIMETABLEGENERATOR_H
@@ -16,40 +16,83 @@ std::string TimePoint::toString() const {
 Train::Train()
     : trainId(""), trainType("G"), route(nullptr), totalCapacity(1200),
       currentPassengers(0), currentSpeed(0.0), currentStatus("停靠"),
-      isInService(true) {}
+      isInService(true), synthetic(false) {}
 
 // 带参数的构造函数
 Train::Train(const std::string &id, const std::string &type,
              std::shared_ptr<Route> trainRoute, int capacity)
     : trainId(id), trainType(type), route(trainRoute), totalCapacity(capacity),
       currentPassengers(0), currentSpeed(0.0), currentStatus("停靠"),
-      isInService(true) {}
+      isInService(true), synthetic(false) {}
 
 // 析构函数
 Train::~Train() { schedule.clear(); }
 
+namespace {
+
+const int MINUTES_PER_DAY = 24 * 60;
+
+// from到to经过的分钟数（to早于from时视为次日）
+int minutesForward(int from, int to) {
+  return ((to - from) % MINUTES_PER_DAY + MINUTES_PER_DAY) % MINUTES_PER_DAY;
+}
+
+} // namespace
+
 // 添加时刻表条目
 void Train::addScheduleEntry(const ScheduleEntry &entry) {
+  int arrival = entry.arrivalTime.toMinutes();
+  if (!schedule.empty()) {
+    int previous = departureMinutes.back();
+    arrival = previous + minutesForward(previous, arrival);
+  }
+  int departure =
+      arrival + minutesForward(arrival, entry.departureTime.toMinutes());
+
+  stopIndex.emplace(entry.stationId, schedule.size());
   schedule.push_back(entry);
+  arrivalMinutes.push_back(arrival);
+  departureMinutes.push_back(departure);
 }
 
 // 移除时刻表条目
 void Train::removeScheduleEntry(const std::string &stationId) {
+  if (stopIndex.find(stationId) == stopIndex.end()) {
+    return;
+  }
   schedule.erase(std::remove_if(schedule.begin(), schedule.end(),
                                 [&stationId](const ScheduleEntry &entry) {
                                   return entry.stationId == stationId;
                                 }),
                  schedule.end());
+  rebuildScheduleIndex();
 }
 
 // 查找时刻表条目
 ScheduleEntry *Train::findScheduleEntry(const std::string &stationId) {
-  auto it = std::find_if(schedule.begin(), schedule.end(),
-                         [&stationId](const ScheduleEntry &entry) {
-                           return entry.stationId == stationId;
-                         });
+  auto it = stopIndex.find(stationId);
+  return (it != stopIndex.end()) ? &schedule[it->second] : nullptr;
+}
 
-  return (it != schedule.end()) ? &(*it) : nullptr;
+const ScheduleEntry *
+Train::findScheduleEntry(const std::string &stationId) const {
+  auto it = stopIndex.find(stationId);
+  return (it != stopIndex.end()) ? &schedule[it->second] : nullptr;
+}
+
+// 按当前时刻表重建站点索引与累计分钟
+void Train::rebuildScheduleIndex() {
+  std::vector<ScheduleEntry> entries;
+  entries.swap(schedule);
+  stopIndex.clear();
+  arrivalMinutes.clear();
+  departureMinutes.clear();
+  schedule.reserve(entries.size());
+  arrivalMinutes.reserve(entries.size());
+  departureMinutes.reserve(entries.size());
+  for (const auto &entry : entries) {
+    addScheduleEntry(entry);
+  }
 }
 
 // 获取载客率
@@ -77,31 +120,40 @@ std::string Train::getScheduleString() const {
 
 // 获取到达时间
 TimePoint Train::getArrivalTime(const std::string &stationId) const {
-  auto it = std::find_if(schedule.begin(), schedule.end(),
-                         [&stationId](const ScheduleEntry &entry) {
-                           return entry.stationId == stationId;
-                         });
-
-  return (it != schedule.end()) ? it->arrivalTime : TimePoint();
+  const ScheduleEntry *entry = findScheduleEntry(stationId);
+  return entry ? entry->arrivalTime : TimePoint();
 }
 
 // 获取发车时间
 TimePoint Train::getDepartureTime(const std::string &stationId) const {
-  auto it = std::find_if(schedule.begin(), schedule.end(),
-                         [&stationId](const ScheduleEntry &entry) {
-                           return entry.stationId == stationId;
-                         });
+  const ScheduleEntry *entry = findScheduleEntry(stationId);
+  return entry ? entry->departureTime : TimePoint();
+}
 
-  return (it != schedule.end()) ? it->departureTime : TimePoint();
+// 获取停站序号
+int Train::getStopIndex(const std::string &stationId) const {
+  auto it = stopIndex.find(stationId);
+  return (it != stopIndex.end()) ? static_cast<int>(it->second) : -1;
 }
 
 // 计算行程时间
 int Train::calculateTravelTime(const std::string &fromStationId,
                                const std::string &toStationId) const {
-  TimePoint fromTime = getDepartureTime(fromStationId);
-  TimePoint toTime = getArrivalTime(toStationId);
+  int from = getStopIndex(fromStationId);
+  int to = getStopIndex(toStationId);
+  if (from < 0 || to < 0 || to <= from) {
+    return -1;
+  }
+  return getTravelTimeByIndex(from, to);
+}
 
-  return toTime.toMinutes() - fromTime.toMinutes();
+// 计算停站时长
+int Train::getDwellTime(const std::string &stationId) const {
+  int index = getStopIndex(stationId);
+  if (index < 0) {
+    return -1;
+  }
+  return departureMinutes[index] - arrivalMinutes[index];
 }
 
 // 转换为字符串
@@ -116,6 +168,9 @@ std::string Train::toString() const {
   if (route) {
     oss << " - 线路: " << route->getRouteName();
   }
+  if (synthetic) {
+    oss << "（合成）";
+  }
 
   return oss.str();
 }
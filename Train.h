@@ -6,6 +6,7 @@
 #include <ctime>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 
@@ -38,12 +39,17 @@ private:
   std::string trainId;                 // 列车号
   std::string trainType;               // 列车类型（G、D、C、K等）
   std::shared_ptr<Route> route;        // 运行线路
-  std::vector<ScheduleEntry> schedule; // 时刻表
+  std::vector<ScheduleEntry> schedule; // 时刻表（按停站顺序）
+  std::unordered_map<std::string, size_t> stopIndex; // 站点ID -> 停站序号
+  // 各站到达/发车的累计分钟（自始发日零点起，跨日累加）
+  std::vector<int> arrivalMinutes;
+  std::vector<int> departureMinutes;
   int totalCapacity;                   // 总载客量
   int currentPassengers;               // 当前载客数
   double currentSpeed;                 // 当前速度
   std::string currentStatus;           // 当前状态（运行中、停靠、检修等）
   bool isInService;                    // 是否在服务中
+  bool synthetic; // 线路或时刻表由TimetableGenerator合成，非源数据
 
 public:
   // 构造函数
@@ -55,15 +61,16 @@ public:
   ~Train();
 
   // Getter方法
-  std::string getTrainId() const { return trainId; }
-  std::string getTrainType() const { return trainType; }
-  std::shared_ptr<Route> getRoute() const { return route; }
-  std::vector<ScheduleEntry> getSchedule() const { return schedule; }
+  const std::string &getTrainId() const { return trainId; }
+  const std::string &getTrainType() const { return trainType; }
+  const std::shared_ptr<Route> &getRoute() const { return route; }
+  const std::vector<ScheduleEntry> &getSchedule() const { return schedule; }
   int getTotalCapacity() const { return totalCapacity; }
   int getCurrentPassengers() const { return currentPassengers; }
   double getCurrentSpeed() const { return currentSpeed; }
-  std::string getCurrentStatus() const { return currentStatus; }
+  const std::string &getCurrentStatus() const { return currentStatus; }
   bool getIsInService() const { return isInService; }
+  bool isSynthetic() const { return synthetic; }
 
   // Setter方法
   void setTrainId(const std::string &id) { trainId = id; }
@@ -74,17 +81,33 @@ public:
   void setCurrentSpeed(double speed) { currentSpeed = speed; }
   void setCurrentStatus(const std::string &status) { currentStatus = status; }
   void setIsInService(bool inService) { isInService = inService; }
+  void setSynthetic(bool value) { synthetic = value; }
 
   // 功能方法
+  // 时刻表条目须按停站顺序添加；时刻早于上一时刻视为跨过午夜
   void addScheduleEntry(const ScheduleEntry &entry);
   void removeScheduleEntry(const std::string &stationId);
+  // 通过返回的指针修改时刻后需调用rebuildScheduleIndex
   ScheduleEntry *findScheduleEntry(const std::string &stationId);
+  const ScheduleEntry *findScheduleEntry(const std::string &stationId) const;
+  void rebuildScheduleIndex();
   double getLoadFactor() const; // 载客率
   std::string getScheduleString() const;
   TimePoint getArrivalTime(const std::string &stationId) const;
   TimePoint getDepartureTime(const std::string &stationId) const;
+  // 行程时间（分钟，自发站发车至到站到达）；站点不存在或顺序相反返回-1
   int calculateTravelTime(const std::string &fromStationId,
                           const std::string &toStationId) const;
+  int getDwellTime(const std::string &stationId) const; // 停站时长，不存在返回-1
+
+  // 按停站序号访问（调用方保证序号有效）
+  int getStopIndex(const std::string &stationId) const; // 不存在返回-1
+  size_t getStopCount() const { return schedule.size(); }
+  int getArrivalMinute(size_t index) const { return arrivalMinutes[index]; }
+  int getDepartureMinute(size_t index) const { return departureMinutes[index]; }
+  int getTravelTimeByIndex(size_t fromIndex, size_t toIndex) const {
+    return arrivalMinutes[toIndex] - departureMinutes[fromIndex];
+  }
   std::string toString() const;
   bool operator==(const Train &other) const;
 };
@@ -0,0 +1,361 @@
+#include "TrainSimulator.h"
+#include "RailNetwork.h"
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+// 构造函数
+TrainSimulator::TrainSimulator(
+    std::shared_ptr<const EntityCatalog> entityCatalog, int firstDeparture,
+    int lastDeparture)
+    : catalog(entityCatalog ? std::move(entityCatalog)
+                            : EntityCatalog::empty()),
+      clock(0.0), nextSequence(0), processedEvents(0) {
+  runs.resize(catalog->getTrainCount());
+
+  // 无时刻表的列车按线路分组，用于均匀分配发车时刻
+  std::unordered_map<const Route *, std::vector<EntityHandle>> unscheduled;
+  for (EntityHandle handle = 0; handle < catalog->getTrainCount(); ++handle) {
+    const auto &train = catalog->getTrain(handle);
+    const auto &route = train->getRoute();
+    runs[handle].maxSpeed = (route && route->getMaxSpeed() > 0)
+                                ? route->getMaxSpeed()
+                                : RailNetwork::DEFAULT_SPEED;
+    if (train->getStopCount() >= 2) {
+      planFromSchedule(*train, runs[handle]);
+    } else if (route && route->getStationCount() >= 2) {
+      unscheduled[route.get()].push_back(handle);
+    }
+  }
+
+  int span = std::max(0, lastDeparture - firstDeparture);
+  for (const auto &group : unscheduled) {
+    const auto &handles = group.second;
+    int perDirection = static_cast<int>((handles.size() + 1) / 2);
+    for (size_t k = 0; k < handles.size(); ++k) {
+      int slot = static_cast<int>(k / 2);
+      int departure = firstDeparture + (perDirection > 1
+                                            ? slot * span / (perDirection - 1)
+                                            : 0);
+      planFromRoute(*group.first, k % 2 == 1, departure, runs[handles[k]]);
+    }
+  }
+
+  reset();
+}
+
+// 由列车时刻表生成计划；里程优先取线路沿线里程，否则按站点坐标估算
+void TrainSimulator::planFromSchedule(const Train &train,
+                                      TrainRun &run) const {
+  const auto &route = train.getRoute();
+  const auto &entries = train.getSchedule();
+  int previousIndex = -1;
+  int firstIndex = -1;
+  const Station *previousStation = nullptr;
+  double kilometre = 0.0;
+
+  for (size_t i = 0; i < entries.size(); ++i) {
+    EntityHandle station = catalog->getStationHandle(entries[i].stationId);
+    if (station == INVALID_HANDLE) {
+      continue;
+    }
+    const Station *current = catalog->getStation(station).get();
+    int routeIndex =
+        route ? route->getStationIndex(entries[i].stationId) : -1;
+    if (previousStation) {
+      if (routeIndex >= 0 && previousIndex >= 0) {
+        kilometre += std::abs(route->getCumulativeDistance(routeIndex) -
+                              route->getCumulativeDistance(previousIndex));
+      } else {
+        kilometre += previousStation->distanceTo(*current);
+      }
+    }
+    run.stops.push_back({station, train.getArrivalMinute(i),
+                         train.getDepartureMinute(i), kilometre, 0, 0, 0});
+    if (routeIndex >= 0) {
+      // 运行方向取首末两个线路上停站的站序
+      if (firstIndex < 0) {
+        firstIndex = routeIndex;
+      }
+      run.reversed = routeIndex < firstIndex;
+    }
+    previousIndex = routeIndex;
+    previousStation = current;
+  }
+  if (run.stops.size() < 2) {
+    run.stops.clear();
+  }
+}
+
+// 按线路生成计划：区间按典型速度运行，中间站停DEFAULT_DWELL_MINUTES
+void TrainSimulator::planFromRoute(const Route &route, bool reversed,
+                                   int firstDeparture, TrainRun &run) const {
+  const auto &stations = route.getStations();
+  int count = static_cast<int>(stations.size());
+  double typicalSpeed = run.maxSpeed * RailNetwork::SPEED_FACTOR;
+  double origin = route.getCumulativeDistance(reversed ? count - 1 : 0);
+  double previousKilometre = 0.0;
+  int minute = firstDeparture;
+  run.reversed = reversed;
+
+  for (int k = 0; k < count; ++k) {
+    int index = reversed ? count - 1 - k : k;
+    EntityHandle station =
+        stations[index] ? catalog->getStationHandle(
+                              stations[index]->getStationId())
+                        : INVALID_HANDLE;
+    if (station == INVALID_HANDLE) {
+      continue;
+    }
+    double kilometre = std::abs(route.getCumulativeDistance(index) - origin);
+    int arrival = minute;
+    if (!run.stops.empty()) {
+      arrival = run.stops.back().departure +
+                std::max(1, static_cast<int>(std::ceil(
+                                (kilometre - previousKilometre) /
+                                typicalSpeed * 60.0)));
+    }
+    run.stops.push_back({station, arrival, arrival + DEFAULT_DWELL_MINUTES,
+                         kilometre, 0, 0, 0});
+    previousKilometre = kilometre;
+  }
+  if (run.stops.size() < 2) {
+    run.stops.clear();
+    return;
+  }
+  run.stops.front().departure = run.stops.front().arrival;
+  run.stops.back().departure = run.stops.back().arrival;
+}
+
+void TrainSimulator::setPassengerFlow(const PassengerFlow &passengerFlow,
+                                      const Date &date) {
+  for (auto &run : runs) {
+    for (auto &stop : run.stops) {
+      stop.boarding = 0;
+      stop.alighting = 0;
+    }
+  }
+  for (const auto &record : passengerFlow.getRecordsByDate(date)) {
+    EntityHandle train = catalog->getTrainHandle(record.getTrainId());
+    EntityHandle station = catalog->getStationHandle(record.getStationId());
+    if (train == INVALID_HANDLE || station == INVALID_HANDLE) {
+      continue;
+    }
+    for (auto &stop : runs[train].stops) {
+      if (stop.station == station) {
+        stop.boarding += record.getBoardingCount();
+        stop.alighting += record.getAlightingCount();
+        break;
+      }
+    }
+  }
+  reset();
+}
+
+bool TrainSimulator::addDelay(const std::string &trainId,
+                              const std::string &stationId, int minutes) {
+  EntityHandle train = catalog->getTrainHandle(trainId);
+  EntityHandle station = catalog->getStationHandle(stationId);
+  if (train == INVALID_HANDLE || station == INVALID_HANDLE) {
+    return false;
+  }
+  for (auto &stop : runs[train].stops) {
+    if (stop.station == station) {
+      stop.holdMinutes += minutes;
+      return true;
+    }
+  }
+  return false;
+}
+
+void TrainSimulator::clearDelays() {
+  for (auto &run : runs) {
+    for (auto &stop : run.stops) {
+      stop.holdMinutes = 0;
+    }
+  }
+}
+
+void TrainSimulator::reset() {
+  calendar = decltype(calendar)();
+  clock = 0.0;
+  nextSequence = 0;
+  processedEvents = 0;
+  for (EntityHandle handle = 0; handle < static_cast<int>(runs.size());
+       ++handle) {
+    TrainRun &run = runs[handle];
+    run.state = TrainState::Waiting;
+    run.stop = 0;
+    run.departedAt = run.arrivesAt = run.arrivedAt = 0.0;
+    run.passengers = 0;
+    if (run.stops.size() >= 2) {
+      scheduleEvent(SimulationEvent::Departure, handle, 0,
+                    run.stops.front().departure);
+    }
+  }
+}
+
+void TrainSimulator::scheduleEvent(SimulationEvent::Type type,
+                                   EntityHandle train, int stop,
+                                   double minute) {
+  calendar.push({minute, nextSequence++, type, train, stop});
+}
+
+size_t TrainSimulator::advanceTo(double minute) {
+  if (minute < clock) {
+    reset();
+  }
+  size_t processed = 0;
+  while (!calendar.empty() && calendar.top().minute <= minute) {
+    SimulationEvent event = calendar.top();
+    calendar.pop();
+    clock = event.minute;
+    process(event);
+    ++processed;
+  }
+  clock = minute;
+  processedEvents += processed;
+  return processed;
+}
+
+size_t TrainSimulator::runToEnd() {
+  size_t processed = 0;
+  while (!calendar.empty()) {
+    SimulationEvent event = calendar.top();
+    calendar.pop();
+    clock = event.minute;
+    process(event);
+    ++processed;
+  }
+  processedEvents += processed;
+  return processed;
+}
+
+// 计划发车时刻加上该站的额外停留。始发站按计划发车，中间站按计划
+// 与最短停站取较晚者
+double TrainSimulator::departureDue(const TrainRun &run, int stop) const {
+  const StopPlan &plan = run.stops[stop];
+  double departure = plan.departure;
+  if (stop > 0) {
+    departure = std::max(run.arrivedAt + MIN_DWELL_MINUTES, departure);
+  }
+  return departure + plan.holdMinutes;
+}
+
+// 发车：额外停留在处理时才计入（事件入历后注入的扰动同样生效），未到
+// 时刻则顺延；否则上客后进入区间，按计划与最高速度取较晚者到达。
+// 到达：下客，终点站结束，否则按计划与最短停站取较晚者发车
+void TrainSimulator::process(const SimulationEvent &event) {
+  TrainRun &run = runs[event.train];
+  const StopPlan &current = run.stops[event.stop];
+
+  if (event.type == SimulationEvent::Departure) {
+    double due = departureDue(run, event.stop);
+    if (event.minute < due) {
+      scheduleEvent(SimulationEvent::Departure, event.train, event.stop, due);
+      return;
+    }
+    int capacity = catalog->getTrain(event.train)->getTotalCapacity();
+    run.passengers = std::min(capacity, run.passengers + current.boarding);
+    const StopPlan &next = run.stops[event.stop + 1];
+    double minimumRun =
+        (next.kilometre - current.kilometre) / run.maxSpeed * 60.0;
+    run.state = TrainState::Running;
+    run.stop = event.stop;
+    run.departedAt = event.minute;
+    run.arrivesAt = std::max(event.minute + minimumRun,
+                             static_cast<double>(next.arrival));
+    scheduleEvent(SimulationEvent::Arrival, event.train, event.stop + 1,
+                  run.arrivesAt);
+    return;
+  }
+
+  run.passengers = std::max(0, run.passengers - current.alighting);
+  run.stop = event.stop;
+  run.arrivedAt = event.minute;
+  if (event.stop + 1 == static_cast<int>(run.stops.size())) {
+    run.state = TrainState::Finished;
+    return;
+  }
+  run.state = TrainState::Dwelling;
+  scheduleEvent(SimulationEvent::Departure, event.train, event.stop,
+                std::max(event.minute + MIN_DWELL_MINUTES,
+                         static_cast<double>(current.departure)));
+}
+
+std::vector<TrainPosition> TrainSimulator::snapshot() const {
+  std::vector<TrainPosition> positions;
+  for (EntityHandle handle = 0; handle < static_cast<int>(runs.size());
+       ++handle) {
+    TrainState state = runs[handle].state;
+    if (state == TrainState::Running || state == TrainState::Dwelling) {
+      positions.push_back(positionOf(handle));
+    }
+  }
+  return positions;
+}
+
+TrainPosition TrainSimulator::positionOf(EntityHandle train) const {
+  const TrainRun &run = runs[train];
+  const StopPlan &from = run.stops[run.stop];
+  const Station &fromStation = *catalog->getStation(from.station);
+
+  TrainPosition position;
+  position.train = train;
+  position.state = run.state;
+  position.fromStation = from.station;
+  position.toStation = from.station;
+  position.progress = 0.0;
+  position.reversed = run.reversed;
+  position.kilometre = from.kilometre;
+  position.longitude = fromStation.getLongitude();
+  position.latitude = fromStation.getLatitude();
+  position.speed = 0.0;
+  position.passengers = run.passengers;
+  position.delayMinutes =
+      static_cast<int>(std::lround(run.arrivedAt - from.arrival));
+
+  if (run.state == TrainState::Running) {
+    const StopPlan &to = run.stops[run.stop + 1];
+    const Station &toStation = *catalog->getStation(to.station);
+    double duration = run.arrivesAt - run.departedAt;
+    double progress =
+        duration > 0.0 ? (clock - run.departedAt) / duration : 1.0;
+    progress = std::max(0.0, std::min(1.0, progress));
+    double length = to.kilometre - from.kilometre;
+
+    position.toStation = to.station;
+    position.progress = progress;
+    position.kilometre = from.kilometre + length * progress;
+    position.longitude +=
+        (toStation.getLongitude() - fromStation.getLongitude()) * progress;
+    position.latitude +=
+        (toStation.getLatitude() - fromStation.getLatitude()) * progress;
+    position.speed = duration > 0.0 ? length / duration * 60.0 : 0.0;
+    position.delayMinutes =
+        static_cast<int>(std::lround(run.departedAt - from.departure));
+  }
+  return position;
+}
+
+int TrainSimulator::getSimulatedTrainCount() const {
+  return static_cast<int>(
+      std::count_if(runs.begin(), runs.end(), [](const TrainRun &run) {
+        return run.stops.size() >= 2;
+      }));
+}
+
+int TrainSimulator::getDelayMinutes(EntityHandle train) const {
+  const TrainRun &run = runs[train];
+  switch (run.state) {
+  case TrainState::Running:
+    return static_cast<int>(
+        std::lround(run.departedAt - run.stops[run.stop].departure));
+  case TrainState::Dwelling:
+  case TrainState::Finished:
+    return static_cast<int>(
+        std::lround(run.arrivedAt - run.stops[run.stop].arrival));
+  default:
+    return 0;
+  }
+}
@@ -0,0 +1,142 @@
+#ifndef TRAINSIMULATOR_H
+#define TRAINSIMULATOR_H
+
+#include "EntityCatalog.h"
+#include "PassengerFlow.h"
+#include <functional>
+#include <memory>
+#include <queue>
+#include <string>
+#include <vector>
+
+// 列车运行状态
+enum class TrainState { Waiting, Running, Dwelling, Finished };
+
+// 某一模拟时刻的列车位置与载客
+struct TrainPosition {
+  EntityHandle train;
+  TrainState state;
+  EntityHandle fromStation; // 停站时为所在站，运行时为区间起点
+  EntityHandle toStation;   // 停站时与fromStation相同
+  double progress;          // 区间内已走比例（0-1）
+  bool reversed;            // 沿线路站序递减方向运行（上行），停站时同样有效
+  double kilometre;         // 自始发站起沿运行方向的里程
+  double longitude;
+  double latitude;
+  double speed;             // km/h，停站为0
+  int passengers;
+  int delayMinutes; // 相对计划的晚点（运行中按发车、停站时按到达计）
+};
+
+// 事件日历中的事件
+struct SimulationEvent {
+  enum Type { Departure, Arrival };
+
+  double minute; // 自运营日零点起的分钟
+  unsigned long sequence; // 同一时刻按加入顺序处理，保证可重放
+  Type type;
+  EntityHandle train;
+  int stop; // 停站序号
+
+  bool operator>(const SimulationEvent &other) const {
+    return minute != other.minute ? minute > other.minute
+                                  : sequence > other.sequence;
+  }
+};
+
+// 离散事件列车运行模拟器：按时刻表（无时刻表的列车按线路里程与
+// 最高速度生成计划）推进全部列车，晚点列车在区间内按最高速度赶点，
+// 停站不少于最短停站时间。可在任意模拟时刻取位置与载客快照
+class TrainSimulator {
+private:
+  struct StopPlan {
+    EntityHandle station;
+    int arrival;      // 计划到达（累计分钟）
+    int departure;    // 计划发车
+    double kilometre; // 自始发站起的里程
+    int boarding;
+    int alighting;
+    int holdMinutes; // 注入的额外停留（扰动）
+  };
+
+  struct TrainRun {
+    std::vector<StopPlan> stops; // 少于两站的列车不参与模拟
+    double maxSpeed;
+    bool reversed; // 沿线路站序递减方向运行
+    TrainState state;
+    int stop;          // 当前（或刚离开的）停站序号
+    double departedAt; // 最近一次发车时刻
+    double arrivesAt;  // 运行中预计到达下一站的时刻
+    double arrivedAt;  // 最近一次到达时刻
+    int passengers;
+  };
+
+  std::shared_ptr<const EntityCatalog> catalog;
+  std::vector<TrainRun> runs; // 按列车句柄
+  std::priority_queue<SimulationEvent, std::vector<SimulationEvent>,
+                      std::greater<SimulationEvent>>
+      calendar;
+  double clock;
+  unsigned long nextSequence;
+  size_t processedEvents;
+
+public:
+  static constexpr int DEFAULT_FIRST_DEPARTURE = 6 * 60; // 06:00
+  static constexpr int DEFAULT_LAST_DEPARTURE = 22 * 60; // 22:00
+  static constexpr int DEFAULT_DWELL_MINUTES = 2;        // 生成计划的停站时长
+  static constexpr int MIN_DWELL_MINUTES = 1;            // 晚点时的最短停站
+
+  // 由目录中的列车构建运行计划。无时刻表的列车按其在线路上的序号
+  // 上下行交替，在[firstDeparture, lastDeparture]内均匀发车
+  explicit TrainSimulator(std::shared_ptr<const EntityCatalog> entityCatalog,
+                          int firstDeparture = DEFAULT_FIRST_DEPARTURE,
+                          int lastDeparture = DEFAULT_LAST_DEPARTURE);
+
+  // 按指定日期的客流记录（列车号+站点）设置各站上下车人数，并重置模拟
+  void setPassengerFlow(const PassengerFlow &passengerFlow, const Date &date);
+
+  // 扰动注入：列车在某站额外停留minutes分钟，只影响尚未处理的事件
+  // （包括已入历但未处理的发车，如未发车列车的始发和停站中的列车）
+  bool addDelay(const std::string &trainId, const std::string &stationId,
+                int minutes);
+  void clearDelays();
+
+  // 回到运营日开始，重新填充事件日历
+  void reset();
+  // 处理时刻不晚于minute的全部事件；minute早于当前时钟时从头重放。
+  // 返回本次处理的事件数
+  size_t advanceTo(double minute);
+  size_t runToEnd();
+
+  // 当前时钟下在途及停站列车的快照（未发车与已到终点的不含在内）
+  std::vector<TrainPosition> snapshot() const;
+  std::vector<TrainPosition> snapshotAt(double minute) {
+    advanceTo(minute);
+    return snapshot();
+  }
+
+  double getClock() const { return clock; }
+  size_t getProcessedEventCount() const { return processedEvents; }
+  size_t getPendingEventCount() const { return calendar.size(); }
+  int getSimulatedTrainCount() const;
+  bool isSimulated(EntityHandle train) const {
+    return runs[train].stops.size() >= 2;
+  }
+  TrainState getTrainState(EntityHandle train) const {
+    return runs[train].state;
+  }
+  // 终到站的晚点（列车尚未到达终点时返回当前晚点）
+  int getDelayMinutes(EntityHandle train) const;
+
+private:
+  void planFromSchedule(const Train &train, TrainRun &run) const;
+  void planFromRoute(const Route &route, bool reversed, int firstDeparture,
+                     TrainRun &run) const;
+  void scheduleEvent(SimulationEvent::Type type, EntityHandle train,
+                     int stop, double minute);
+  double departureDue(const TrainRun &run, int stop) const;
+  void process(const SimulationEvent &event);
+  TrainPosition positionOf(EntityHandle train) const;
+};
+
+#endif // TRAINSIMULATOR_H
@@ -0,0 +1,975 @@
+#include "ValidationEngine.h"
+#include "MappedFile.h"
+#include "ParallelUtils.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <sstream>
+#include <string_view>
+#include <unordered_set>
+
+const char *validationCategoryName(ValidationCategory category) {
+  switch (category) {
+  case ValidationCategory::FileAccess:
+    return "文件访问";
+  case ValidationCategory::Schema:
+    return "字段结构";
+  case ValidationCategory::MissingValue:
+    return "缺失值";
+  case ValidationCategory::Type:
+    return "类型错误";
+  case ValidationCategory::Range:
+    return "数值范围";
+  case ValidationCategory::Reference:
+    return "引用完整性";
+  case ValidationCategory::Duplicate:
+    return "重复主键";
+  }
+  return "未知";
+}
+
+const char *dataFileKindName(DataFileKind kind) {
+  switch (kind) {
+  case DataFileKind::Stations:
+    return "站点";
+  case DataFileKind::Routes:
+    return "线路";
+  case DataFileKind::Trains:
+    return "列车";
+  case DataFileKind::FlowRecords:
+    return "客流";
+  }
+  return "未知";
+}
+
+ValidationReport::ValidationReport() : elapsedMs(0.0) {
+  std::fill(categoryCounts, categoryCounts + VALIDATION_CATEGORY_COUNT, 0);
+  std::fill(fileIssueCounts, fileIssueCounts + DATA_FILE_KIND_COUNT, 0);
+  std::fill(linesChecked, linesChecked + DATA_FILE_KIND_COUNT, 0);
+  std::fill(fileChecked, fileChecked + DATA_FILE_KIND_COUNT, false);
+}
+
+long long ValidationReport::totalIssues() const {
+  long long total = 0;
+  for (int c = 0; c < VALIDATION_CATEGORY_COUNT; ++c) {
+    total += categoryCounts[c];
+  }
+  return total;
+}
+
+std::string ValidationReport::toString(size_t maxIssueLines) const {
+  std::ostringstream oss;
+  oss << "=== 数据校验报告 ===\n";
+  for (int f = 0; f < DATA_FILE_KIND_COUNT; ++f) {
+    if (!fileChecked[f]) {
+      continue;
+    }
+    oss << dataFileKindName(static_cast<DataFileKind>(f)) << "文件: 校验"
+        << linesChecked[f] << "行，问题" << fileIssueCounts[f] << "个\n";
+  }
+
+  oss << "问题统计（共" << totalIssues() << "个）:\n";
+  for (int c = 0; c < VALIDATION_CATEGORY_COUNT; ++c) {
+    if (categoryCounts[c] > 0) {
+      oss << "  " << validationCategoryName(static_cast<ValidationCategory>(c))
+          << ": " << categoryCounts[c] << "\n";
+    }
+  }
+
+  size_t shown = std::min(maxIssueLines, issues.size());
+  if (shown > 0) {
+    oss << "问题明细（前" << shown << "条）:\n";
+  }
+  for (size_t i = 0; i < shown; ++i) {
+    const auto &issue = issues[i];
+    oss << "  [" << dataFileKindName(issue.file) << "] ";
+    if (issue.line > 0) {
+      oss << "第" << issue.line << "行 ";
+    }
+    oss << validationCategoryName(issue.category) << ": " << issue.message
+        << "\n";
+  }
+  oss << "耗时: " << elapsedMs << " ms\n";
+  return oss.str();
+}
+
+namespace {
+
+const size_t SHARD_COUNT = 64;
+
+// 按行对齐的校验分块
+struct Chunk {
+  int file;
+  size_t begin;
+  size_t end;
+  bool skipHeader;      // 文件首块跳过表头
+  long long lineCount;  // 块内行数（校验时填写）
+  long long firstLine;  // 块首行的全局行号
+};
+
+// 主键出现位置：哈希 + 所在行起始偏移
+struct KeyOccurrence {
+  uint64_t hash;
+  uint64_t offset;
+};
+
+struct LocalIssue {
+  int file;
+  size_t chunk;
+  long long relLine;
+  ValidationCategory category;
+  std::string message;
+};
+
+struct DuplicateHit {
+  int file;
+  uint64_t offset;      // 重复行
+  uint64_t firstOffset; // 首次出现的行
+};
+
+// 每个工作线程独占的状态，合并前无需加锁
+struct WorkerState {
+  std::vector<LocalIssue> issues;
+  long long counts[VALIDATION_CATEGORY_COUNT] = {};
+  long long fileCounts[DATA_FILE_KIND_COUNT] = {};
+  long long lines[DATA_FILE_KIND_COUNT] = {};
+  std::vector<KeyOccurrence> keys[DATA_FILE_KIND_COUNT][SHARD_COUNT];
+  std::vector<std::string_view> stationKeys;
+  std::vector<std::string_view> stationCodes; // 原始站点编号，供运营线路引用
+  std::vector<std::string_view> trainKeys;
+  std::deque<std::string> ownedKeys; // 含引号字段的主键副本
+
+  // 逐行复用的临时缓冲
+  std::vector<std::string_view> fields;
+  std::deque<std::string> quotedFields;
+  bool lineQuoted = false;
+};
+
+struct ReferenceSets {
+  bool hasStations = false;
+  bool hasTrains = false;
+  std::unordered_set<std::string_view> stations;
+  std::unordered_set<std::string_view> stationCodes;
+  std::unordered_set<std::string_view> trains;
+};
+
+uint64_t hashKey(std::string_view key) {
+  uint64_t hash = 1469598103934665603ULL;
+  for (unsigned char c : key) {
+    hash ^= c;
+    hash *= 1099511628211ULL;
+  }
+  // 混合高位，使分片均匀
+  hash ^= hash >> 29;
+  hash *= 0xbf58476d1ce4e5b9ULL;
+  hash ^= hash >> 32;
+  return hash;
+}
+
+// 与FileManager::splitCSVLine语义一致：空行无字段，行尾逗号后的空字段忽略
+void splitFields(std::string_view line, std::vector<std::string_view> &fields,
+                 std::deque<std::string> &quoted, bool &lineQuoted) {
+  fields.clear();
+  lineQuoted = line.find('"') != std::string_view::npos;
+  if (!lineQuoted) {
+    size_t start = 0;
+    while (start < line.size()) {
+      size_t comma = line.find(',', start);
+      if (comma == std::string_view::npos) {
+        fields.push_back(line.substr(start));
+        break;
+      }
+      fields.push_back(line.substr(start, comma - start));
+      start = comma + 1;
+    }
+    return;
+  }
+
+  quoted.clear();
+  std::string field;
+  bool inQuotes = false;
+  bool pending = false;
+  for (size_t i = 0; i < line.size(); ++i) {
+    char c = line[i];
+    if (inQuotes) {
+      if (c == '"') {
+        if (i + 1 < line.size() && line[i + 1] == '"') {
+          field.push_back('"');
+          ++i;
+        } else {
+          inQuotes = false;
+        }
+      } else {
+        field.push_back(c);
+      }
+    } else if (c == '"') {
+      inQuotes = true;
+      pending = true;
+    } else if (c == ',') {
+      quoted.push_back(field);
+      field.clear();
+      pending = false;
+    } else {
+      field.push_back(c);
+      pending = true;
+    }
+  }
+  if (pending || !field.empty()) {
+    quoted.push_back(field);
+  }
+  // deque追加元素不会使已有元素失效，可以安全地引用
+  for (const auto &f : quoted) {
+    fields.push_back(f);
+  }
+}
+
+std::string_view trim(std::string_view text) {
+  if (text.empty() || (text.front() != ' ' && text.front() != '\t' &&
+                       text.back() != ' ' && text.back() != '\t')) {
+    return text;
+  }
+  size_t begin = text.find_first_not_of(" \t");
+  if (begin == std::string_view::npos) {
+    return std::string_view();
+  }
+  size_t end = text.find_last_not_of(" \t");
+  return text.substr(begin, end - begin + 1);
+}
+
+// 与FileManager的解析方式一致的主键：站点为电报码，列车为车次，
+// 运营线路格式为“线路编码:站序”，其余为首列
+std::string keyOf(const std::vector<std::string_view> &fields, int file) {
+  switch (static_cast<DataFileKind>(file)) {
+  case DataFileKind::Stations:
+    return fields.size() > 14 ? std::string(fields[14]) : std::string();
+  case DataFileKind::Trains:
+    return fields.size() > 4 ? std::string(fields[4]) : std::string();
+  case DataFileKind::Routes:
+    if (fields.size() >= 14) {
+      return std::string(trim(fields[0])) + ":" + std::string(trim(fields[3]));
+    }
+    break;
+  case DataFileKind::FlowRecords:
+    break;
+  }
+  return fields.empty() ? std::string() : std::string(fields[0]);
+}
+
+bool isNullValue(std::string_view text) {
+  text = trim(text);
+  return text.empty() || text == "NULL";
+}
+
+bool parseInteger(std::string_view text, long long &value) {
+  text = trim(text);
+  if (text.empty()) {
+    return false;
+  }
+  auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+  return result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+bool parseReal(std::string_view text, double &value) {
+  text = trim(text);
+  if (text.empty()) {
+    return false;
+  }
+  auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+  return result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+// 单行校验上下文
+class LineChecker {
+private:
+  WorkerState &state;
+  const ReferenceSets &refs;
+  size_t maxIssues;
+  // 本块已保留的明细数。分块内按行序检查，全局最靠前的maxIssues条中
+  // 落在本块的部分必在本块的前maxIssues条之内；各块保留的只是候选，
+  // 汇总后按行号全局排序再统一截取，与分块在哪个线程上处理无关
+  size_t storedCounts[VALIDATION_CATEGORY_COUNT] = {};
+  int file;
+  size_t chunk;
+  bool firstChunk;
+  long long relLine;
+  uint64_t lineOffset;
+
+public:
+  LineChecker(WorkerState &s, const ReferenceSets &r, size_t maxPerCategory,
+              int fileKind, size_t chunkIndex, bool isFirstChunk)
+      : state(s), refs(r), maxIssues(maxPerCategory), file(fileKind),
+        chunk(chunkIndex), firstChunk(isFirstChunk), relLine(0),
+        lineOffset(0) {}
+
+  void check(std::string_view line, long long rel, uint64_t offset) {
+    relLine = rel;
+    lineOffset = offset;
+    splitFields(line, state.fields, state.quotedFields, state.lineQuoted);
+    state.lines[file]++;
+
+    switch (static_cast<DataFileKind>(file)) {
+    case DataFileKind::Stations:
+      checkStation(state.fields);
+      break;
+    case DataFileKind::Routes:
+      checkRoute(state.fields);
+      break;
+    case DataFileKind::Trains:
+      checkTrain(state.fields);
+      break;
+    case DataFileKind::FlowRecords:
+      checkFlowRecord(state.fields);
+      break;
+    }
+  }
+
+private:
+  void report(ValidationCategory category, const std::string &message) {
+    int c = static_cast<int>(category);
+    state.counts[c]++;
+    state.fileCounts[file]++;
+    if (storedCounts[c] < maxIssues) {
+      storedCounts[c]++;
+      state.issues.push_back({file, chunk, relLine, category, message});
+    }
+  }
+
+  bool checkFieldCount(const std::vector<std::string_view> &fields,
+                       size_t required) {
+    if (fields.size() >= required) {
+      return true;
+    }
+    report(ValidationCategory::Schema,
+           "字段数不足: 需要至少" + std::to_string(required) + "个，实际" +
+               std::to_string(fields.size()) + "个");
+    return false;
+  }
+
+  // 记录主键，返回稳定的视图（含引号的行需复制）
+  std::string_view addKey(std::string_view key) {
+    if (state.lineQuoted) {
+      state.ownedKeys.emplace_back(key);
+      key = state.ownedKeys.back();
+    }
+    uint64_t hash = hashKey(key);
+    state.keys[file][hash >> 58].push_back({hash, lineOffset});
+    return key;
+  }
+
+  // 记录需要拼接的组合主键
+  void addCompositeKey(const std::string &key) {
+    uint64_t hash = hashKey(key);
+    state.keys[file][hash >> 58].push_back({hash, lineOffset});
+  }
+
+  std::string_view keepView(std::string_view text) {
+    if (state.lineQuoted) {
+      state.ownedKeys.emplace_back(text);
+      return state.ownedKeys.back();
+    }
+    return text;
+  }
+
+  void checkStation(const std::vector<std::string_view> &fields) {
+    if (!checkFieldCount(fields, 16)) {
+      return;
+    }
+
+    if (isNullValue(fields[7])) {
+      report(ValidationCategory::MissingValue, "站点名称为空");
+    }
+
+    long long zdid = 0;
+    if (!parseInteger(fields[0], zdid)) {
+      report(ValidationCategory::Type,
+             "站点编号不是整数: " + std::string(fields[0]));
+    }
+
+    std::string_view flag = trim(fields[11]);
+    if (!isNullValue(flag) && flag != "0" && flag != "1") {
+      report(ValidationCategory::Range,
+             "是否停用应为0或1: " + std::string(fields[11]));
+    }
+
+    if (isNullValue(fields[14])) {
+      report(ValidationCategory::MissingValue, "缺少站点电报码（站点ID）");
+    }
+    // 为空的电报码同样参与重复检查，与加载后的站点ID一致
+    state.stationKeys.push_back(addKey(fields[14]));
+    state.stationCodes.push_back(keepView(trim(fields[0])));
+  }
+
+  void checkTrain(const std::vector<std::string_view> &fields) {
+    if (!checkFieldCount(fields, 7)) {
+      return;
+    }
+
+    if (isNullValue(fields[4])) {
+      // 加载时会跳过该行，不参与主键检查
+      report(ValidationCategory::MissingValue, "车次为空");
+      return;
+    }
+
+    std::string_view capacity = trim(fields[6]);
+    if (!isNullValue(capacity) && capacity != "#N/A") {
+      long long value = 0;
+      if (!parseInteger(capacity, value)) {
+        report(ValidationCategory::Type,
+               "列车运能不是整数: " + std::string(fields[6]));
+      } else if (value <= 0) {
+        report(ValidationCategory::Range,
+               "列车运能必须为正数: " + std::string(fields[6]));
+      }
+    }
+
+    state.trainKeys.push_back(addKey(fields[4]));
+  }
+
+  // 运营线路格式：每行是线路上的一个站点
+  void checkOperationalRoute(const std::vector<std::string_view> &fields) {
+    long long routeCode = 0;
+    if (!parseInteger(fields[0], routeCode)) {
+      // 原始文件第二行是中文表头
+      if (firstChunk && relLine == 1) {
+        state.lines[file]--;
+        return;
+      }
+      report(ValidationCategory::Type,
+             "线路编码不是整数: " + std::string(fields[0]));
+      return;
+    }
+
+    long long order = 0;
+    if (!parseInteger(fields[3], order)) {
+      report(ValidationCategory::Type,
+             "线路站序不是整数: " + std::string(fields[3]));
+    } else if (order <= 0) {
+      report(ValidationCategory::Range,
+             "线路站序必须为正数: " + std::string(fields[3]));
+    } else {
+      addCompositeKey(std::string(trim(fields[0])) + ":" +
+                      std::string(trim(fields[3])));
+    }
+
+    if (!isNullValue(fields[5])) {
+      double segment = 0.0;
+      if (!parseReal(fields[5], segment)) {
+        report(ValidationCategory::Type,
+               "站间距离不是数值: " + std::string(fields[5]));
+      } else if (segment < 0.0) {
+        report(ValidationCategory::Range,
+               "站间距离为负数: " + std::string(fields[5]));
+      }
+    }
+
+    if (isNullValue(fields[1])) {
+      report(ValidationCategory::MissingValue, "线路站点编号为空");
+    } else if (refs.hasStations &&
+               refs.stationCodes.count(trim(fields[1])) == 0) {
+      report(ValidationCategory::Reference,
+             "线路引用了不存在的站点编号: " + std::string(fields[1]));
+    }
+  }
+
+  void checkRoute(const std::vector<std::string_view> &fields) {
+    if (fields.size() >= 14) {
+      checkOperationalRoute(fields);
+      return;
+    }
+    if (!checkFieldCount(fields, 6)) {
+      return;
+    }
+
+    if (isNullValue(fields[0])) {
+      report(ValidationCategory::MissingValue, "线路ID为空");
+    } else {
+      addKey(fields[0]);
+    }
+
+    double distance = 0.0;
+    if (!parseReal(fields[3], distance)) {
+      report(ValidationCategory::Type,
+             "线路里程不是数值: " + std::string(fields[3]));
+    } else if (distance < 0.0) {
+      report(ValidationCategory::Range,
+             "线路里程为负数: " + std::string(fields[3]));
+    }
+
+    long long speed = 0;
+    if (!parseInteger(fields[4], speed)) {
+      report(ValidationCategory::Type,
+             "最高速度不是整数: " + std::string(fields[4]));
+    } else if (speed <= 0) {
+      report(ValidationCategory::Range,
+             "最高速度必须为正数: " + std::string(fields[4]));
+    }
+
+    // 途经站点以分号分隔
+    std::string_view stationList = fields[5];
+    size_t stationCount = 0;
+    size_t missingCount = 0;
+    std::string_view firstMissing;
+    size_t start = 0;
+    while (start <= stationList.size()) {
+      size_t sep = stationList.find(';', start);
+      size_t end = sep == std::string_view::npos ? stationList.size() : sep;
+      std::string_view id = stationList.substr(start, end - start);
+      if (!id.empty()) {
+        stationCount++;
+        if (refs.hasStations && refs.stations.count(id) == 0) {
+          if (missingCount == 0) {
+            firstMissing = id;
+          }
+          missingCount++;
+        }
+      }
+      if (sep == std::string_view::npos) {
+        break;
+      }
+      start = sep + 1;
+    }
+
+    if (stationCount == 0) {
+      report(ValidationCategory::MissingValue, "线路未包含任何站点");
+    } else if (missingCount > 0) {
+      std::string message =
+          "线路引用了不存在的站点: " + std::string(firstMissing);
+      if (missingCount > 1) {
+        message += " 等" + std::to_string(missingCount) + "个";
+      }
+      report(ValidationCategory::Reference, message);
+    }
+
+    // 可选的站间距离列
+    if (fields.size() >= 7 && !fields[6].empty()) {
+      std::string_view segments = fields[6];
+      size_t begin = 0;
+      while (begin <= segments.size()) {
+        size_t sep = segments.find(';', begin);
+        size_t end = sep == std::string_view::npos ? segments.size() : sep;
+        std::string_view text = segments.substr(begin, end - begin);
+        double segment = 0.0;
+        if (!text.empty() && (!parseReal(text, segment) || segment < 0.0)) {
+          report(ValidationCategory::Type,
+                 "站间距离无效: " + std::string(text));
+          break;
+        }
+        if (sep == std::string_view::npos) {
+          break;
+        }
+        begin = sep + 1;
+      }
+    }
+  }
+
+  void checkDate(std::string_view text) {
+    text = trim(text);
+    if (text.empty() || text == "NULL") {
+      return; // 加载时使用默认日期
+    }
+
+    long long parts[3] = {0, 0, 0};
+    bool parsed = false;
+    if (text.find('-') != std::string_view::npos) {
+      size_t first = text.find('-');
+      size_t second = text.find('-', first + 1);
+      parsed = second != std::string_view::npos &&
+               parseInteger(text.substr(0, first), parts[0]) &&
+               parseInteger(text.substr(first + 1, second - first - 1),
+                            parts[1]) &&
+               parseInteger(text.substr(second + 1), parts[2]);
+    } else if (text.size() == 8) {
+      parsed = parseInteger(text.substr(0, 4), parts[0]) &&
+               parseInteger(text.substr(4, 2), parts[1]) &&
+               parseInteger(text.substr(6, 2), parts[2]);
+    }
+
+    if (!parsed) {
+      report(ValidationCategory::Type, "日期格式无法识别: " + std::string(text));
+    } else if (parts[1] < 1 || parts[1] > 12 || parts[2] < 1 ||
+               parts[2] > 31) {
+      report(ValidationCategory::Range, "日期超出范围: " + std::string(text));
+    }
+  }
+
+  void checkCount(std::string_view text, const char *name, long long minValue,
+                  long long maxValue) {
+    if (isNullValue(text)) {
+      return; // 加载时按0处理
+    }
+    long long value = 0;
+    if (!parseInteger(text, value)) {
+      report(ValidationCategory::Type,
+             std::string(name) + "不是整数: " + std::string(text));
+    } else if (value < minValue || value > maxValue) {
+      report(ValidationCategory::Range,
+             std::string(name) + "超出范围: " + std::string(text));
+    }
+  }
+
+  void checkFlowRecord(const std::vector<std::string_view> &fields) {
+    if (!checkFieldCount(fields, 9)) {
+      return;
+    }
+
+    if (fields[0].empty()) {
+      // 加载时会丢弃没有记录ID的行
+      report(ValidationCategory::MissingValue, "记录ID为空");
+    } else {
+      addKey(fields[0]);
+    }
+
+    checkDate(fields[3]);
+    checkCount(fields[4], "小时", 0, 23);
+    checkCount(fields[5], "上车人数", 0, 10000000);
+    checkCount(fields[6], "下车人数", 0, 10000000);
+
+    std::string_view station = trim(fields[1]);
+    if (refs.hasStations && refs.stations.count(station) == 0) {
+      report(ValidationCategory::Reference,
+             "引用了不存在的站点: " + std::string(station));
+    }
+    if (refs.hasTrains && !isNullValue(fields[7]) &&
+        refs.trains.count(fields[7]) == 0) {
+      report(ValidationCategory::Reference,
+             "引用了不存在的列车: " + std::string(fields[7]));
+    }
+  }
+};
+
+// 校验一个分块：逐行切分字段并检查
+void checkChunk(Chunk &chunk, size_t chunkIndex, const char *data,
+                WorkerState &state, const ReferenceSets &refs,
+                size_t maxIssues) {
+  LineChecker checker(state, refs, maxIssues, chunk.file, chunkIndex,
+                      chunk.skipHeader);
+  const char *p = data + chunk.begin;
+  const char *end = data + chunk.end;
+  long long rel = 0;
+
+  while (p < end) {
+    const char *newline =
+        static_cast<const char *>(std::memchr(p, '\n', end - p));
+    const char *lineEnd = newline ? newline : end;
+    size_t length = static_cast<size_t>(lineEnd - p);
+    while (length > 0 && p[length - 1] == '\r') {
+      --length; // 兼容\r\r\n结尾的导出文件
+    }
+
+    bool isHeader = chunk.skipHeader && rel == 0;
+    if (!isHeader && length > 0) {
+      checker.check(std::string_view(p, length), rel,
+                    static_cast<uint64_t>(p - data));
+    }
+
+    ++rel;
+    p = newline ? newline + 1 : end;
+  }
+  chunk.lineCount = rel;
+}
+
+// 取出某行的主键字段
+std::string extractKey(const char *data, size_t size, uint64_t offset,
+                       int file) {
+  const char *p = data + offset;
+  const char *end = data + size;
+  const char *newline =
+      static_cast<const char *>(std::memchr(p, '\n', end - p));
+  size_t length = static_cast<size_t>((newline ? newline : end) - p);
+  while (length > 0 && p[length - 1] == '\r') {
+    --length;
+  }
+
+  std::vector<std::string_view> fields;
+  std::deque<std::string> quoted;
+  bool lineQuoted = false;
+  splitFields(std::string_view(p, length), fields, quoted, lineQuoted);
+  return keyOf(fields, file);
+}
+
+} // namespace
+
+// 构造函数
+ValidationEngine::ValidationEngine() : maxIssuesPerCategory(1000) {
+  std::fill(fileRequired, fileRequired + DATA_FILE_KIND_COUNT, true);
+}
+
+void ValidationEngine::setFile(DataFileKind kind, const std::string &path,
+                               bool required) {
+  filePaths[static_cast<int>(kind)] = path;
+  fileRequired[static_cast<int>(kind)] = required;
+}
+
+ValidationReport ValidationEngine::run() const {
+  auto startTime = std::chrono::steady_clock::now();
+  ValidationReport report;
+  std::vector<ValidationIssue> fileIssues;
+
+  // 映射文件并按行切块
+  std::unique_ptr<MappedFile> files[DATA_FILE_KIND_COUNT];
+  std::vector<Chunk> chunks;
+  for (int f = 0; f < DATA_FILE_KIND_COUNT; ++f) {
+    if (filePaths[f].empty()) {
+      continue;
+    }
+    files[f] = std::make_unique<MappedFile>();
+    if (!files[f]->open(filePaths[f], MappedFile::Access::Sequential)) {
+      if (fileRequired[f]) {
+        report.fileChecked[f] = true;
+        fileIssues.emplace_back(static_cast<DataFileKind>(f), 0,
+                                ValidationCategory::FileAccess,
+                                files[f]->getLastError());
+      }
+      files[f].reset();
+      continue;
+    }
+    report.fileChecked[f] = true;
+
+    const char *data = files[f]->data();
+    size_t size = files[f]->size();
+    size_t pos = 0;
+    while (pos < size) {
+      size_t end = std::min(size, pos + CHUNK_SIZE);
+      if (end < size) {
+        const char *newline = static_cast<const char *>(
+            std::memchr(data + end, '\n', size - end));
+        end = newline ? static_cast<size_t>(newline - data) + 1 : size;
+      }
+      chunks.push_back({f, pos, end, pos == 0, 0, 0});
+      pos = end;
+    }
+  }
+
+  unsigned workerCount = parallelWorkerCount(static_cast<size_t>(-1));
+  std::vector<WorkerState> states(workerCount);
+  ReferenceSets refs;
+
+  auto runStage = [&](const std::vector<size_t> &stageChunks) {
+    parallelFor(stageChunks.size(),
+                [&](size_t begin, size_t end, unsigned worker) {
+                  for (size_t i = begin; i < end; ++i) {
+                    Chunk &chunk = chunks[stageChunks[i]];
+                    checkChunk(chunk, stageChunks[i],
+                               files[chunk.file]->data(), states[worker], refs,
+                               maxIssuesPerCategory);
+                  }
+                });
+  };
+
+  // 第一阶段：站点和列车（被引用方）；第二阶段：线路和客流（引用方）
+  std::vector<size_t> dimensionChunks, factChunks;
+  for (size_t i = 0; i < chunks.size(); ++i) {
+    DataFileKind kind = static_cast<DataFileKind>(chunks[i].file);
+    if (kind == DataFileKind::Stations || kind == DataFileKind::Trains) {
+      dimensionChunks.push_back(i);
+    } else {
+      factChunks.push_back(i);
+    }
+  }
+
+  runStage(dimensionChunks);
+
+  refs.hasStations = files[static_cast<int>(DataFileKind::Stations)] != nullptr;
+  refs.hasTrains = files[static_cast<int>(DataFileKind::Trains)] != nullptr;
+  for (const auto &state : states) {
+    refs.stations.insert(state.stationKeys.begin(), state.stationKeys.end());
+    refs.stationCodes.insert(state.stationCodes.begin(),
+                             state.stationCodes.end());
+    refs.trains.insert(state.trainKeys.begin(), state.trainKeys.end());
+  }
+
+  runStage(factChunks);
+
+  // 计算各块的全局起始行号
+  long long nextLine[DATA_FILE_KIND_COUNT] = {1, 1, 1, 1};
+  for (auto &chunk : chunks) {
+    chunk.firstLine = nextLine[chunk.file];
+    nextLine[chunk.file] += chunk.lineCount;
+  }
+
+  // 按分片并行排序查找重复主键
+  std::vector<std::vector<DuplicateHit>> shardHits(DATA_FILE_KIND_COUNT *
+                                                   SHARD_COUNT);
+  parallelFor(shardHits.size(), [&](size_t begin, size_t end, unsigned) {
+    std::vector<KeyOccurrence> keys;
+    for (size_t task = begin; task < end; ++task) {
+      int file = static_cast<int>(task / SHARD_COUNT);
+      size_t shard = task % SHARD_COUNT;
+      if (!files[file]) {
+        continue;
+      }
+
+      keys.clear();
+      for (const auto &state : states) {
+        const auto &part = state.keys[file][shard];
+        keys.insert(keys.end(), part.begin(), part.end());
+      }
+      // 只按哈希排序，组内顺序在比较真实主键时再确定
+      std::sort(keys.begin(), keys.end(),
+                [](const KeyOccurrence &a, const KeyOccurrence &b) {
+                  return a.hash < b.hash;
+                });
+
+      const char *data = files[file]->data();
+      size_t size = files[file]->size();
+      for (size_t i = 0; i < keys.size();) {
+        size_t j = i + 1;
+        while (j < keys.size() && keys[j].hash == keys[i].hash) {
+          ++j;
+        }
+        if (j - i > 1) {
+          // 哈希相同的组内逐一比较真实主键，排除哈希碰撞
+          std::vector<std::pair<std::string, uint64_t>> group;
+          for (size_t k = i; k < j; ++k) {
+            group.emplace_back(extractKey(data, size, keys[k].offset, file),
+                               keys[k].offset);
+          }
+          std::sort(group.begin(), group.end());
+          size_t runStart = 0;
+          for (size_t k = 1; k < group.size(); ++k) {
+            if (group[k].first != group[runStart].first) {
+              runStart = k;
+            } else {
+              shardHits[task].push_back(
+                  {file, group[k].second, group[runStart].second});
+            }
+          }
+        }
+        i = j;
+      }
+    }
+  });
+
+  std::vector<DuplicateHit> duplicates;
+  for (auto &hits : shardHits) {
+    duplicates.insert(duplicates.end(), hits.begin(), hits.end());
+  }
+  std::sort(duplicates.begin(), duplicates.end(),
+            [](const DuplicateHit &a, const DuplicateHit &b) {
+              return a.file != b.file ? a.file < b.file : a.offset < b.offset;
+            });
+
+  // 汇总计数与问题明细
+  for (const auto &issue : fileIssues) {
+    report.categoryCounts[static_cast<int>(issue.category)]++;
+    report.fileIssueCounts[static_cast<int>(issue.file)]++;
+    report.issues.push_back(issue);
+  }
+  for (const auto &state : states) {
+    for (int c = 0; c < VALIDATION_CATEGORY_COUNT; ++c) {
+      report.categoryCounts[c] += state.counts[c];
+    }
+    for (int f = 0; f < DATA_FILE_KIND_COUNT; ++f) {
+      report.fileIssueCounts[f] += state.fileCounts[f];
+      report.linesChecked[f] += state.lines[f];
+    }
+    for (const auto &issue : state.issues) {
+      report.issues.emplace_back(static_cast<DataFileKind>(issue.file),
+                                 chunks[issue.chunk].firstLine + issue.relLine,
+                                 issue.category, issue.message);
+    }
+  }
+
+  const int duplicateIndex = static_cast<int>(ValidationCategory::Duplicate);
+  report.categoryCounts[duplicateIndex] +=
+      static_cast<long long>(duplicates.size());
+  // 只为保留的重复项计算行号：收集涉及的行偏移，每个文件顺序扫描一遍
+  std::vector<DuplicateHit> reportedHits;
+  size_t reportedDuplicates[DATA_FILE_KIND_COUNT] = {};
+  std::vector<uint64_t> lineOffsets[DATA_FILE_KIND_COUNT];
+  for (const auto &hit : duplicates) {
+    report.fileIssueCounts[hit.file]++;
+    if (reportedDuplicates[hit.file] >= maxIssuesPerCategory) {
+      continue;
+    }
+    reportedDuplicates[hit.file]++;
+    reportedHits.push_back(hit);
+    lineOffsets[hit.file].push_back(hit.offset);
+    lineOffsets[hit.file].push_back(hit.firstOffset);
+  }
+
+  std::vector<long long> lineNumbers[DATA_FILE_KIND_COUNT];
+  for (int f = 0; f < DATA_FILE_KIND_COUNT; ++f) {
+    auto &offsets = lineOffsets[f];
+    if (offsets.empty()) {
+      continue;
+    }
+    std::sort(offsets.begin(), offsets.end());
+    offsets.erase(std::unique(offsets.begin(), offsets.end()), offsets.end());
+
+    const char *data = files[f]->data();
+    size_t chunkIndex = 0;
+    uint64_t position = 0;
+    long long line = 1;
+    for (uint64_t offset : offsets) {
+      // 跳到所在分块，利用已知的块首行号
+      while (chunkIndex < chunks.size() &&
+             (chunks[chunkIndex].file != f || chunks[chunkIndex].end <= offset)) {
+        ++chunkIndex;
+      }
+      if (chunkIndex < chunks.size() && chunks[chunkIndex].begin > position) {
+        position = chunks[chunkIndex].begin;
+        line = chunks[chunkIndex].firstLine;
+      }
+      line += std::count(data + position, data + offset, '\n');
+      position = offset;
+      lineNumbers[f].push_back(line);
+    }
+  }
+  auto lineAt = [&](int file, uint64_t offset) -> long long {
+    const auto &offsets = lineOffsets[file];
+    size_t index = static_cast<size_t>(
+        std::lower_bound(offsets.begin(), offsets.end(), offset) -
+        offsets.begin());
+    return lineNumbers[file][index];
+  };
+
+  for (const auto &hit : reportedHits) {
+    const MappedFile &mapped = *files[hit.file];
+    std::string key =
+        extractKey(mapped.data(), mapped.size(), hit.offset, hit.file);
+    report.issues.emplace_back(
+        static_cast<DataFileKind>(hit.file), lineAt(hit.file, hit.offset),
+        ValidationCategory::Duplicate,
+        key + "（首次出现于第" +
+            std::to_string(lineAt(hit.file, hit.firstOffset)) + "行）");
+  }
+
+  // 必需文件没有任何数据行
+  for (int f = 0; f < DATA_FILE_KIND_COUNT; ++f) {
+    if (files[f] && report.linesChecked[f] == 0) {
+      report.categoryCounts[static_cast<int>(ValidationCategory::MissingValue)]++;
+      report.fileIssueCounts[f]++;
+      report.issues.emplace_back(static_cast<DataFileKind>(f), 0,
+                                 ValidationCategory::MissingValue,
+                                 "文件中没有数据行");
+    }
+  }
+
+  // 按文件、行号排序，每类保留最靠前的若干条（唯一一次按上限截取）
+  std::stable_sort(report.issues.begin(), report.issues.end(),
+                   [](const ValidationIssue &a, const ValidationIssue &b) {
+                     return a.file != b.file ? a.file < b.file
+                                             : a.line < b.line;
+                   });
+  size_t kept[VALIDATION_CATEGORY_COUNT] = {};
+  std::vector<ValidationIssue> trimmed;
+  trimmed.reserve(report.issues.size());
+  for (auto &issue : report.issues) {
+    int c = static_cast<int>(issue.category);
+    if (kept[c] < maxIssuesPerCategory) {
+      kept[c]++;
+      trimmed.push_back(std::move(issue));
+    }
+  }
+  report.issues.swap(trimmed);
+
+  report.elapsedMs = std::chrono::duration<double, std::milli>(
+                         std::chrono::steady_clock::now() - startTime)
+                         .count();
+  return report;
+}
@@ -0,0 +1,86 @@
+#ifndef VALIDATIONENGINE_H
+#define VALIDATIONENGINE_H
+
+#include <string>
+#include <vector>
+
+// 问题类别
+enum class ValidationCategory {
+  FileAccess = 0, // 文件不存在或无法映射
+  Schema,         // 字段数不符合格式
+  MissingValue,   // 必填字段为空
+  Type,           // 字段类型错误
+  Range,          // 数值超出合理范围
+  Reference,      // 引用了不存在的站点或列车
+  Duplicate       // 主键重复
+};
+
+const int VALIDATION_CATEGORY_COUNT = 7;
+const char *validationCategoryName(ValidationCategory category);
+
+// 数据文件种类
+enum class DataFileKind { Stations = 0, Routes, Trains, FlowRecords };
+
+const int DATA_FILE_KIND_COUNT = 4;
+const char *dataFileKindName(DataFileKind kind);
+
+// 单条问题（行号从1开始，包含表头；文件级问题行号为0）
+struct ValidationIssue {
+  DataFileKind file;
+  long long line;
+  ValidationCategory category;
+  std::string message;
+
+  ValidationIssue(DataFileKind f = DataFileKind::Stations, long long l = 0,
+                  ValidationCategory c = ValidationCategory::Schema,
+                  const std::string &msg = "")
+      : file(f), line(l), category(c), message(msg) {}
+};
+
+// 校验报告
+struct ValidationReport {
+  std::vector<ValidationIssue> issues; // 按文件、行号排序，每类最多保留上限条
+  long long categoryCounts[VALIDATION_CATEGORY_COUNT];
+  long long fileIssueCounts[DATA_FILE_KIND_COUNT];
+  long long linesChecked[DATA_FILE_KIND_COUNT];
+  bool fileChecked[DATA_FILE_KIND_COUNT];
+  double elapsedMs;
+
+  ValidationReport();
+
+  long long totalIssues() const;
+  long long countOf(ValidationCategory category) const {
+    return categoryCounts[static_cast<int>(category)];
+  }
+  long long countOf(DataFileKind file) const {
+    return fileIssueCounts[static_cast<int>(file)];
+  }
+  bool isValid() const { return totalIssues() == 0; }
+  std::string toString(size_t maxIssueLines = 50) const;
+};
+
+// 数据校验引擎：内存映射各数据文件，按行切块并行校验结构、类型、
+// 引用完整性与主键重复，每个字节只扫描一次
+class ValidationEngine {
+private:
+  std::string filePaths[DATA_FILE_KIND_COUNT]; // 为空表示不校验
+  bool fileRequired[DATA_FILE_KIND_COUNT];
+  size_t maxIssuesPerCategory;
+
+public:
+  static const size_t CHUNK_SIZE = 4 << 20; // 每个校验分块约4MB
+
+  // 构造函数
+  ValidationEngine();
+
+  // 设置待校验文件；required为false时文件不存在不计为问题
+  void setFile(DataFileKind kind, const std::string &path,
+               bool required = true);
+  void setMaxIssuesPerCategory(size_t maxIssues) {
+    maxIssuesPerCategory = maxIssues;
+  }
+
+  ValidationReport run() const;
+};
+
+#endif // VALIDATIONENGINE_H
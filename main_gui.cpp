@@ -4,6 +4,7 @@
 #include <QDateEdit>
 #include <QFileDialog>
 #include <QFont>
+#include <QFutureWatcher>
 #include <QGroupBox>
 #include <QHBoxLayout>
 #include <QHeaderView>
@@ -23,12 +24,15 @@
 #include <QTreeWidget>
 #include <QTreeWidgetItem>
 #include <QVBoxLayout>
+#include <QtConcurrent/QtConcurrent>
 #include <algorithm>
 #include <climits>
 #include <clocale>
 #include <functional>
 #include <locale>
+#include <map>
 #include <memory>
+#include <set>
 #include <vector>
 
 #ifdef _WIN32
@@ -51,11 +55,17 @@
 
 // Qt Charts classes will be used with full namespace
 #include "DataAnalyzer.h"
+#include "EntityCatalog.h"
 #include "FileManager.h"
+#include "IsochroneIndex.h"
 #include "PassengerFlow.h"
 #include "Route.h"
+#include "SectionLoadIndex.h"
+#include "SpatialIndex.h"
 #include "Station.h"
+#include "TimetableGenerator.h"
 #include "Train.h"
+#include "TrainSimulator.h"
 
 class RailwayMainWindow : public QMainWindow {
   Q_OBJECT
@@ -105,7 +115,9 @@ private slots:
 
     } else if (analysisType == QString::fromUtf8("列车载客率分析")) {
       Date today(2024, 12, 15);
-      auto loadFactors = passengerFlow.getAllTrainsLoadFactor(today);
+      SectionLoadIndex loadIndex(catalog);
+      loadIndex.compute(passengerFlow, today);
+      auto loadFactors = loadIndex.getLoadFactors();
 
       result = QString::fromUtf8(
           "列车载客率分析报告\n=====================================\n");
@@ -134,16 +146,11 @@ private slots:
         result = QString::fromUtf8("请先选择要预测的站点！");
       } else {
         // 找到对应的站点ID
-        std::string stationId;
-        for (const auto &station : stations) {
-          if (QString::fromStdString(station->getStationName()) ==
-              selectedStation) {
-            stationId = station->getStationId();
-            break;
-          }
-        }
+        auto selected =
+            catalog->findStationByName(selectedStation.toStdString());
 
-        if (!stationId.empty()) {
+        if (selected) {
+          const std::string &stationId = selected->getStationId();
           auto prediction = passengerFlow.predictFlow(stationId, days);
 
           result =
@@ -238,6 +245,45 @@ private slots:
           result += QString::fromUtf8("预测结论: 双向流量将保持相对均衡");
         }
       }
+    } else if (analysisType == QString::fromUtf8("站点等时圈")) {
+      auto selected = catalog->findStationByName(
+          stationCombo->currentText().toStdString());
+      if (!selected) {
+        result = QString::fromUtf8("请先选择站点！");
+      } else if (!isochrones) {
+        // 全部站点的等时圈在加载后由后台整批计算，查询只读位图
+        result = QString::fromUtf8("站点等时圈正在后台计算，请稍后再试");
+      } else {
+        EntityHandle source =
+            catalog->getStationHandle(selected->getStationId());
+        result = QString::fromUtf8("站点等时圈（按典型运行时间）\n") +
+                 QString::fromUtf8("=====================================\n") +
+                 QString::fromUtf8("出发站点: %1\n\n")
+                     .arg(stationCombo->currentText());
+        for (int band = 0; band < isochrones->getBandCount(); ++band) {
+          auto reachable = isochrones->getReachable(source, band);
+          result += QString::fromUtf8("%1 分钟内可达: %2 站\n")
+                        .arg(isochrones->getBands()[band])
+                        .arg(reachable.size());
+          // 只列出新进入本档的站点
+          QStringList names;
+          for (EntityHandle station : reachable) {
+            if (names.size() >= 20) {
+              break;
+            }
+            if (station != source &&
+                isochrones->bandOf(source, station) == band) {
+              names << QString::fromStdString(
+                  catalog->getStation(station)->getStationName());
+            }
+          }
+          if (!names.isEmpty()) {
+            result += "  " + names.join(QString::fromUtf8("、")) + "\n";
+          }
+        }
+        result += QString::fromUtf8("\n全网计算耗时: %1 ms\n")
+                      .arg(isochrones->getElapsedMs(), 0, 'f', 1);
+      }
     }
 
     analysisResults->setText(result);
@@ -395,7 +441,9 @@ private slots:
 
   void createTrainLoadChart() {
     Date today(2024, 12, 15);
-    auto loadFactors = passengerFlow.getAllTrainsLoadFactor(today);
+    SectionLoadIndex loadIndex(catalog);
+    loadIndex.compute(passengerFlow, today);
+    auto loadFactors = loadIndex.getLoadFactors();
 
     QBarSeries *series = new QBarSeries();
     QBarSet *set = new QBarSet(QString::fromUtf8("载客率 (%)"));
@@ -575,11 +623,43 @@ private slots:
     // 创建热力点 - 使用多个散点图来模拟热力效果
     std::vector<QScatterSeries *> heatLayers;
 
-    // 为不同强度的热力创建不同的图层
+    // 视窗内的站点按站名匹配客流（缺站名的记录以站点ID为键），
+    // 目录中找不到站点的客流记录按名称估算位置
+    std::vector<std::pair<std::pair<double, double>, int>> heatPoints;
+    std::set<std::string> placedKeys;
+    for (EntityHandle handle : spatialIndex->withinBox(
+             VIEW_MIN_LONGITUDE, VIEW_MIN_LATITUDE, VIEW_MAX_LONGITUDE,
+             VIEW_MAX_LATITUDE)) {
+      const auto &station = catalog->getStation(handle);
+      auto flowIt = stationFlow.find(station->getStationName());
+      if (flowIt == stationFlow.end()) {
+        flowIt = stationFlow.find(station->getStationId());
+      }
+      if (flowIt == stationFlow.end()) {
+        continue;
+      }
+      double x, y;
+      getStationPosition(*station, x, y);
+      heatPoints.push_back({{x, y}, flowIt->second});
+      placedKeys.insert(flowIt->first);
+    }
     for (const auto &pair : stationFlow) {
+      if (placedKeys.count(pair.first) == 0 &&
+          !catalog->findStation(pair.first) &&
+          !catalog->findStationByName(pair.first)) {
+        double x, y;
+        FileManager::estimateStationPosition(pair.first, x, y);
+        heatPoints.push_back({{x, y}, pair.second});
+      }
+    }
+
+    for (const auto &point : heatPoints) {
+      double x = point.first.first;
+      double y = point.first.second;
+
       // 计算热力强度 (0-1之间)
       double intensity =
-          static_cast<double>(pair.second - minFlow) / (maxFlow - minFlow);
+          static_cast<double>(point.second - minFlow) / (maxFlow - minFlow);
 
       // 为每个站点创建一个热力区域（使用多个同心圆模拟）
       for (int radius = 5; radius >= 1; radius--) {
@@ -591,10 +671,6 @@ private slots:
         heatLayer->setColor(color);
         heatLayer->setBorderColor(QColor(Qt::transparent));
 
-        // 模拟地理位置 - 基于站点名称生成相对位置
-        double x, y;
-        getStationPosition(pair.first, x, y);
-
         heatLayer->append(x, y);
         heatLayers.push_back(heatLayer);
         chart->addSeries(heatLayer);
@@ -603,13 +679,13 @@ private slots:
 
     // 设置坐标轴
     QValueAxis *axisX = new QValueAxis();
-    axisX->setRange(103, 107); // 大致覆盖成都-重庆经度范围
+    axisX->setRange(VIEW_MIN_LONGITUDE, VIEW_MAX_LONGITUDE);
     axisX->setTitleText("Longitude / E");
     axisX->setLabelFormat("%.1f");
     chart->addAxis(axisX, Qt::AlignBottom);
 
     QValueAxis *axisY = new QValueAxis();
-    axisY->setRange(29, 31); // 大致覆盖成都-重庆纬度范围
+    axisY->setRange(VIEW_MIN_LATITUDE, VIEW_MAX_LATITUDE);
     axisY->setTitleText("Latitude / N");
     axisY->setLabelFormat("%.1f");
     chart->addAxis(axisY, Qt::AlignLeft);
@@ -632,13 +708,15 @@ private slots:
       return;
     }
 
-    // 为每个站点生成模拟客流量
-    for (const auto &station : stations) {
-      if (!station)
-        continue;
+    // 为视窗内的每个站点生成模拟客流量
+    std::vector<EntityHandle> visibleStations = spatialIndex->withinBox(
+        VIEW_MIN_LONGITUDE, VIEW_MIN_LATITUDE, VIEW_MAX_LONGITUDE,
+        VIEW_MAX_LATITUDE);
+    for (EntityHandle handle : visibleStations) {
+      const auto &station = catalog->getStation(handle);
 
       // 根据站点名称生成不同的客流强度
-      std::string stationName = station->getStationName();
+      const std::string &stationName = station->getStationName();
       int intensity = 100; // 基础强度
 
       // 主要城市站点客流更高
@@ -656,12 +734,7 @@ private slots:
 
       // 使用站点的经纬度或估算位置
       double x, y;
-      if (station->getLatitude() != 0 && station->getLongitude() != 0) {
-        x = station->getLongitude();
-        y = station->getLatitude();
-      } else {
-        getStationPosition(stationName, x, y);
-      }
+      getStationPosition(*station, x, y);
 
       // 计算强度 (0-1之间)
       double intensityNormal = static_cast<double>(intensity - 50) / 250.0;
@@ -683,13 +756,13 @@ private slots:
 
     // 设置坐标轴
     QValueAxis *axisX = new QValueAxis();
-    axisX->setRange(103, 107);
+    axisX->setRange(VIEW_MIN_LONGITUDE, VIEW_MAX_LONGITUDE);
     axisX->setTitleText("Longitude / E");
     axisX->setLabelFormat("%.1f");
     chart->addAxis(axisX, Qt::AlignBottom);
 
     QValueAxis *axisY = new QValueAxis();
-    axisY->setRange(29, 31);
+    axisY->setRange(VIEW_MIN_LATITUDE, VIEW_MAX_LATITUDE);
     axisY->setTitleText("Latitude / N");
     axisY->setLabelFormat("%.1f");
     chart->addAxis(axisY, Qt::AlignLeft);
@@ -702,7 +775,7 @@ private slots:
 
     chart->setTitle(
         QString::fromUtf8("川渝地区客流热力分布图 - 基于所有站点 (%1个站点)")
-            .arg(stations.size()));
+            .arg(visibleStations.size()));
     chart->legend()->setVisible(false);
   }
 
@@ -799,114 +872,140 @@ private slots:
     return color;
   }
 
-  void getStationPosition(const std::string &stationName, double &x,
-                          double &y) {
-    // 根据站点名称估算地理位置
-    if (stationName.find("成都") != std::string::npos) {
-      x = 104.0 + (std::hash<std::string>{}(stationName) % 20) * 0.01;
-      y = 30.5 + (std::hash<std::string>{}(stationName) % 20) * 0.01;
-    } else if (stationName.find("重庆") != std::string::npos) {
-      x = 106.4 + (std::hash<std::string>{}(stationName) % 20) * 0.01;
-      y = 29.5 + (std::hash<std::string>{}(stationName) % 20) * 0.01;
-    } else if (stationName.find("简阳") != std::string::npos) {
-      x = 104.5;
-      y = 30.4;
-    } else if (stationName.find("资阳") != std::string::npos) {
-      x = 104.8;
-      y = 30.2;
+  void getStationPosition(const Station &station, double &x, double &y) {
+    // 站点缺少经纬度时根据站点名称估算位置
+    if (station.getLatitude() != 0 && station.getLongitude() != 0) {
+      x = station.getLongitude();
+      y = station.getLatitude();
     } else {
-      // 其他站点在成都-重庆之间随机分布
-      x = 104.0 + (std::hash<std::string>{}(stationName) % 250) * 0.01;
-      y = 29.5 + (std::hash<std::string>{}(stationName) % 150) * 0.01;
+      FileManager::estimateStationPosition(station.getStationName(), x, y);
     }
   }
 
   void createTrainSimulation() {
-    // 创建列车运行模拟 - 显示列车在线路上的动态位置
+    // 离散事件模拟推进到当前时刻，显示列车线路上各列车的实时位置
+    int currentMinute =
+        QTime::currentTime().hour() * 60 + QTime::currentTime().minute();
+    std::vector<TrainPosition> positions =
+        trainSimulator->snapshotAt(currentMinute);
+
+    // 选取当前在途列车最多的线路
+    std::map<const Route *, int> trainsOnRoute;
+    for (const auto &position : positions) {
+      const auto &route = catalog->getTrain(position.train)->getRoute();
+      if (route) {
+        trainsOnRoute[route.get()]++;
+      }
+    }
+    const Route *route = nullptr;
+    for (const auto &pair : trainsOnRoute) {
+      if (!route || pair.second > trainsOnRoute[route]) {
+        route = pair.first;
+      }
+    }
+    if (!route) {
+      chart->setTitle(QString::fromUtf8("当前时刻无在途列车"));
+      return;
+    }
+
     QLineSeries *routeSeries = new QLineSeries();
-    routeSeries->setName(QString::fromUtf8("成渝高铁线路"));
+    routeSeries->setName(QString::fromUtf8(route->getRouteName().c_str()));
     routeSeries->setColor(QColor("#2c3e50"));
     routeSeries->setPen(QPen(QColor("#2c3e50"), 3));
 
-    // 模拟成渝高铁线路（成都 -> 重庆）
-    routeSeries->append(0, 0);    // 成都东站
-    routeSeries->append(2, 0.5);  // 成都南站
-    routeSeries->append(4, 1);    // 简阳南站
-    routeSeries->append(6, 1.5);  // 资阳北站
-    routeSeries->append(8, 2);    // 重庆西站
-    routeSeries->append(10, 2.5); // 重庆北站
-
-    chart->addSeries(routeSeries);
-
-    // 创建运行中的列车（使用散点图表示）
-    QScatterSeries *trainSeries = new QScatterSeries();
-    trainSeries->setName(QString::fromUtf8("运行列车"));
-    trainSeries->setMarkerSize(20.0);
-    trainSeries->setColor(QColor("#e74c3c"));
-    trainSeries->setBorderColor(QColor("#c0392b"));
-
-    // 模拟当前时间的列车位置
-    int currentHour = QTime::currentTime().hour();
-    double trainPositions[] = {1.5, 3.8, 6.2, 8.7}; // 4列列车的位置
-
-    for (int i = 0; i < 4; ++i) {
-      double pos =
-          trainPositions[i] + (currentHour % 12) * 0.1; // 根据时间微调位置
-      if (pos > 10)
-        pos = pos - 10; // 循环运行
-
-      double y = 0.25 * (pos / 2.5); // 沿线路的Y坐标
-      trainSeries->append(pos, y);
-    }
-
-    chart->addSeries(trainSeries);
-
-    // 创建车站点
+    // 车站按沿线里程排列
     QScatterSeries *stationSeries = new QScatterSeries();
     stationSeries->setName(QString::fromUtf8("车站"));
-    stationSeries->setMarkerSize(15.0);
+    stationSeries->setMarkerSize(8.0);
     stationSeries->setColor(QColor("#3498db"));
     stationSeries->setBorderColor(QColor("#2980b9"));
-
-    // 添加主要车站位置
-    stationSeries->append(0, 0);    // 成都东站
-    stationSeries->append(2, 0.5);  // 成都南站
-    stationSeries->append(4, 1);    // 简阳南站
-    stationSeries->append(6, 1.5);  // 资阳北站
-    stationSeries->append(8, 2);    // 重庆西站
-    stationSeries->append(10, 2.5); // 重庆北站
-
+    for (int i = 0; i < route->getStationCount(); ++i) {
+      routeSeries->append(route->getCumulativeDistance(i), 1);
+      stationSeries->append(route->getCumulativeDistance(i), 1);
+    }
+    chart->addSeries(routeSeries);
     chart->addSeries(stationSeries);
 
+    // 列车按所在区间插值到线路里程，下行在线路上方、上行在下方
+    QScatterSeries *downSeries = new QScatterSeries();
+    downSeries->setName(QString::fromUtf8("下行列车"));
+    downSeries->setMarkerSize(14.0);
+    downSeries->setColor(QColor("#e74c3c"));
+    downSeries->setBorderColor(QColor("#c0392b"));
+    QScatterSeries *upSeries = new QScatterSeries();
+    upSeries->setName(QString::fromUtf8("上行列车"));
+    upSeries->setMarkerSize(14.0);
+    upSeries->setColor(QColor("#27ae60"));
+    upSeries->setBorderColor(QColor("#1e8449"));
+
+    int shownTrains = 0;
+    int delayedTrains = 0;
+    double speedSum = 0.0;
+    int runningTrains = 0;
+    for (const auto &position : positions) {
+      if (catalog->getTrain(position.train)->getRoute().get() != route) {
+        continue;
+      }
+      int fromIndex = route->getStationIndex(
+          catalog->getStation(position.fromStation)->getStationId());
+      int toIndex = route->getStationIndex(
+          catalog->getStation(position.toStation)->getStationId());
+      if (fromIndex < 0 || toIndex < 0) {
+        continue;
+      }
+      double fromKm = route->getCumulativeDistance(fromIndex);
+      double x = fromKm + (route->getCumulativeDistance(toIndex) - fromKm) *
+                              position.progress;
+      if (!position.reversed) {
+        downSeries->append(x, 1.5);
+      } else {
+        upSeries->append(x, 0.5);
+      }
+      ++shownTrains;
+      if (position.delayMinutes > 0) {
+        ++delayedTrains;
+      }
+      if (position.state == TrainState::Running) {
+        speedSum += position.speed;
+        ++runningTrains;
+      }
+    }
+    chart->addSeries(downSeries);
+    chart->addSeries(upSeries);
+
     // 设置坐标轴
     QValueAxis *axisX = new QValueAxis();
-    axisX->setRange(-0.5, 10.5);
+    axisX->setRange(0, std::max(1.0, route->getTrackLength()));
     axisX->setTitleText("Railway Distance (km)");
-    axisX->setLabelFormat("%.1f");
+    axisX->setLabelFormat("%.0f");
     chart->addAxis(axisX, Qt::AlignBottom);
-    routeSeries->attachAxis(axisX);
-    trainSeries->attachAxis(axisX);
-    stationSeries->attachAxis(axisX);
 
     QValueAxis *axisY = new QValueAxis();
-    axisY->setRange(-0.5, 3);
+    axisY->setRange(0, 2);
     axisY->setTitleText("Track Direction");
     axisY->setLabelsVisible(false);
     chart->addAxis(axisY, Qt::AlignLeft);
-    routeSeries->attachAxis(axisY);
-    trainSeries->attachAxis(axisY);
-    stationSeries->attachAxis(axisY);
 
-    chart->setTitle(QString::fromUtf8("成渝高铁列车运行实时模拟"));
+    for (auto series : chart->series()) {
+      series->attachAxis(axisX);
+      series->attachAxis(axisY);
+    }
+
+    chart->setTitle(
+        QString::fromUtf8("%1 列车运行模拟 (%2)")
+            .arg(QString::fromUtf8(route->getRouteName().c_str()))
+            .arg(QTime::currentTime().toString("hh:mm")));
     chart->legend()->setVisible(true);
     chart->legend()->setAlignment(Qt::AlignBottom);
 
-    // 添加状态信息文本
-    QString statusText = QString::fromUtf8("当前时间: %1\n")
-                             .arg(QTime::currentTime().toString("hh:mm"));
-    statusText += QString::fromUtf8("运行列车: 4列\n");
-    statusText += QString::fromUtf8("线路状态: 正常运行\n");
-    statusText += QString::fromUtf8("平均速度: 280km/h");
+    // 状态信息
+    QString statusText =
+        QString::fromUtf8("在途列车: %1列  晚点: %2列  平均速度: %3km/h")
+            .arg(shownTrains)
+            .arg(delayedTrains)
+            .arg(runningTrains > 0 ? speedSum / runningTrains : 0.0, 0, 'f',
+                 0);
+    statusBar()->showMessage(statusText, 5000);
   }
 
   void exportData() {
@@ -942,7 +1041,7 @@ private slots:
   void onAnalysisTypeChanged(int index) {
     // 根据选择的分析类型显示/隐藏相关控件
     bool showPredictionDays = (index == 3 || index == 4); // 站点预测或川渝预测
-    bool showStationSelect = (index == 3); // 仅站点预测需要选择站点
+    bool showStationSelect = (index == 3 || index == 5); // 站点预测或等时圈
 
     predictionDaysLabel->setVisible(showPredictionDays);
     predictionDaysCombo->setVisible(showPredictionDays);
@@ -959,6 +1058,18 @@ private slots:
     updateStationCombo(); // 更新站点下拉列表
   }
 
+  // 后台等时圈计算完成；计算期间目录又发生变化时按新目录重新计算
+  void onIsochronesReady() {
+    if (isochroneRebuildPending) {
+      isochroneRebuildPending = false;
+      startIsochroneBuild();
+      return;
+    }
+    isochroneProgress->setVisible(false);
+    isochrones = isochroneWatcher.result();
+    statusBar()->showMessage(QString::fromUtf8("站点等时圈计算完成"), 2000);
+  }
+
   void updateStationCombo() {
     stationCombo->clear();
     stationCombo->addItem(QString::fromUtf8("请选择站点"));
@@ -1007,6 +1118,17 @@ private:
     // 创建状态栏
     statusBar()->showMessage(QString::fromUtf8("系统就绪"));
 
+    // 等时圈后台计算的进度指示（计算期间显示）
+    isochroneProgress = new QProgressBar;
+    isochroneProgress->setRange(0, 0);
+    isochroneProgress->setMaximumWidth(160);
+    isochroneProgress->setToolTip(QString::fromUtf8("正在计算站点等时圈"));
+    isochroneProgress->setVisible(false);
+    statusBar()->addPermanentWidget(isochroneProgress);
+    connect(&isochroneWatcher,
+            &QFutureWatcher<std::shared_ptr<IsochroneIndex>>::finished, this,
+            &RailwayMainWindow::onIsochronesReady);
+
     // 应用样式
     setStyleSheet(R"(
             QMainWindow {
@@ -1175,7 +1297,8 @@ private:
                                  QString::fromUtf8("川渝双向流量对比"),
                                  QString::fromUtf8("列车载客率分析"),
                                  QString::fromUtf8("站点客流预测"),
-                                 QString::fromUtf8("川渝双向预测")});
+                                 QString::fromUtf8("川渝双向预测"),
+                                 QString::fromUtf8("站点等时圈")});
     controlLayout->addWidget(analysisTypeCombo);
 
     // 预测天数选择（仅预测功能使用）
@@ -1275,10 +1398,8 @@ private:
   }
 
   void initializeData() {
-    // 尝试从CSV文件加载实际数据
-    stations = fileManager.loadStations();
-    routes = fileManager.loadRoutes(stations);
-    trains = fileManager.loadTrains(routes);
+    // 尝试从CSV文件加载实际数据（站点、线路、列车文件并发读取）
+    fileManager.importTopology(stations, routes, trains);
 
     // 暂时不从CSV加载客流数据，因为解析有问题
     // 直接使用生成的合理数据
@@ -1292,16 +1413,49 @@ private:
       generateRealisticFlowData();
     }
 
+    // 列车表不含运行线路：为列车绑定合成线路，再按线路、类型批量生成
+    // 时刻表（均为演示用的合成数据）
+    size_t syntheticRoutes =
+        TimetableGenerator::bindSyntheticRoutes(trains, routes);
+    size_t syntheticSchedules =
+        TimetableGenerator().fillMissingSchedules(trains);
+
+    // 重建共享实体目录
+    catalog = EntityCatalog::build(stations, routes, trains);
+    spatialIndex = std::make_shared<SpatialIndex>(*catalog);
+    trainSimulator = std::make_shared<TrainSimulator>(catalog);
+    startIsochroneBuild(); // 目录变化后在后台重新计算
+
     statusBar()->showMessage(
         QString::fromUtf8(
-            "已加载 %1 个站点, %2 条线路, %3 列列车, %4 条客流记录")
+            "已加载 %1 个站点, %2 条线路, %3 列列车, %4 条客流记录"
+            "（合成线路 %5 列, 合成时刻表 %6 列）")
             .arg(stations.size())
             .arg(routes.size())
             .arg(trains.size())
-            .arg(passengerFlow.getRecordCount()),
+            .arg(passengerFlow.getRecordCount())
+            .arg(syntheticRoutes)
+            .arg(syntheticSchedules),
         3000);
   }
 
+  // 在后台线程为全部站点计算等时圈，避免阻塞界面；上一次计算尚未
+  // 完成时（无法中途取消）待其结束后再按当前目录计算
+  void startIsochroneBuild() {
+    isochrones.reset();
+    if (isochroneWatcher.isRunning()) {
+      isochroneRebuildPending = true;
+      return;
+    }
+    auto indexCatalog = catalog;
+    isochroneProgress->setVisible(true);
+    isochroneWatcher.setFuture(QtConcurrent::run([indexCatalog]() {
+      auto index = std::make_shared<IsochroneIndex>(indexCatalog);
+      index->computeStatic(RailNetwork(indexCatalog));
+      return index;
+    }));
+  }
+
   void initSampleData() {
     // 创建示例站点
     auto station1 = std::make_shared<Station>(
@@ -1366,7 +1520,7 @@ private:
 
     for (const auto &station : stations) {
       if (station && !station->getStationName().empty()) {
-        std::string name = station->getStationName();
+        const std::string &name = station->getStationName();
         // 检查是否为主要城市站点
         if (name.find("成都") != std::string::npos ||
             name.find("重庆") != std::string::npos ||
@@ -1483,10 +1637,24 @@ private:
   }
 
 private:
+  // 热力图视窗（覆盖成都-重庆经纬度范围及估算坐标的分布范围）
+  static constexpr double VIEW_MIN_LONGITUDE = 103.0;
+  static constexpr double VIEW_MAX_LONGITUDE = 107.0;
+  static constexpr double VIEW_MIN_LATITUDE = 29.0;
+  static constexpr double VIEW_MAX_LATITUDE = 31.0;
+
   // 数据成员
   std::vector<std::shared_ptr<Station>> stations;
   std::vector<std::shared_ptr<Route>> routes;
   std::vector<std::shared_ptr<Train>> trains;
+  std::shared_ptr<const EntityCatalog> catalog = EntityCatalog::empty();
+  std::shared_ptr<SpatialIndex> spatialIndex =
+      std::make_shared<SpatialIndex>(*catalog);
+  std::shared_ptr<TrainSimulator> trainSimulator =
+      std::make_shared<TrainSimulator>(catalog);
+  std::shared_ptr<IsochroneIndex> isochrones; // 站点等时圈（加载后后台计算）
+  QFutureWatcher<std::shared_ptr<IsochroneIndex>> isochroneWatcher;
+  bool isochroneRebuildPending = false; // 计算期间目录又发生变化
   PassengerFlow passengerFlow;
   FileManager fileManager;
 
@@ -1504,6 +1672,7 @@ private:
   QComboBox *predictionDaysCombo;
   QLabel *stationLabel;
   QComboBox *stationCombo;
+  QProgressBar *isochroneProgress;
 };
 
 int main(int argc, char *argv[]) {
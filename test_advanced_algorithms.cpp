@@ -1,4 +1,5 @@
 #include "DataAnalyzer.h"
+#include "EntityCatalog.h"
 #include "PassengerFlow.h"
 #include "Station.h"
 #include "TimeSeriesAnalyzer.h"
@@ -17,25 +18,24 @@ int main() {
 
   // 创建模拟站点
   auto station1 =
-      std::make_shared<Station>("CD001", "成都东站", 30.123, 104.456, "成都");
+      std::make_shared<Station>("CD001", "成都东站", "成都", 104.456, 30.123);
   station1->setPlatformCount(8);
   station1->setIsTransferStation(true);
 
   auto station2 =
-      std::make_shared<Station>("CD002", "成都南站", 30.234, 104.567, "成都");
+      std::make_shared<Station>("CD002", "成都南站", "成都", 104.567, 30.234);
   station2->setPlatformCount(6);
   station2->setIsTransferStation(false);
 
   auto station3 =
-      std::make_shared<Station>("CQ001", "重庆北站", 29.345, 106.678, "重庆");
+      std::make_shared<Station>("CQ001", "重庆北站", "重庆", 106.678, 29.345);
   station3->setPlatformCount(10);
   station3->setIsTransferStation(true);
 
   // 创建高级分析器
-  TimeSeriesAnalyzer analyzer(passengerFlow);
-  analyzer.addStation(station1);
-  analyzer.addStation(station2);
-  analyzer.addStation(station3);
+  auto catalog =
+      EntityCatalog::build({station1, station2, station3}, {}, {});
+  TimeSeriesAnalyzer analyzer(passengerFlow, catalog);
 
   std::cout << "📊 系统初始化完成，共载入 3 个站点" << std::endl;
   std::cout << std::endl;
@@ -0,0 +1,116 @@
+#include "BackupStore.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+// 增量备份仓库的备份/恢复往返测试：同一秒内连续备份多个版本，检查清单
+// 顺序与备份顺序一致，恢复最近一次及指定版本的内容与备份时逐字节相同
+
+namespace {
+
+const int VERSION_COUNT = 12;
+
+int failures = 0;
+
+void expect(bool condition, const std::string &what) {
+  if (!condition) {
+    ++failures;
+    std::cout << "  不一致: " << what << std::endl;
+  }
+}
+
+std::string readFile(const std::string &path) {
+  std::ifstream file(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(file),
+                     std::istreambuf_iterator<char>());
+}
+
+void writeFile(const std::string &path, const std::string &content) {
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  file.write(content.data(), static_cast<std::streamsize>(content.size()));
+}
+
+// 第version个版本：大块共用内容（检验去重）加上各版本不同的尾部
+std::vector<std::string> makeVersion(int version) {
+  std::mt19937 random(7);
+  std::string shared(300 * 1024, '\0');
+  for (auto &c : shared) {
+    c = static_cast<char>(random() & 0xFF);
+  }
+  std::string csv = "RecordID,StationID,Hour\n";
+  for (int i = 0; i <= version * 50; ++i) {
+    csv += "F" + std::to_string(i) + ",S" + std::to_string(i % 30) + "," +
+           std::to_string(i % 24) + "\n";
+  }
+  return {shared + "version " + std::to_string(version), csv, ""};
+}
+
+} // namespace
+
+int main() {
+  namespace fs = std::filesystem;
+  std::string suffix = std::to_string(std::random_device{}());
+  fs::path root = fs::temp_directory_path() / ("railway_backup_test_" + suffix);
+  fs::path source = root / "source";
+  fs::path target = root / "target";
+  fs::create_directories(source);
+  const std::vector<std::string> fileNames = {"blob.bin", "flow.csv",
+                                              "empty.csv"};
+
+  BackupStore store((root / "store").string());
+  std::vector<std::string> manifests;
+  long long storedBytes = 0;
+  for (int version = 0; version < VERSION_COUNT; ++version) {
+    auto contents = makeVersion(version);
+    for (size_t i = 0; i < fileNames.size(); ++i) {
+      writeFile((source / fileNames[i]).string(), contents[i]);
+    }
+    BackupStats stats;
+    bool ok = store.backup(source.string(), fileNames, stats);
+    expect(ok, "备份版本" + std::to_string(version) + ": " +
+                   store.getLastError());
+    manifests.push_back(stats.manifestName);
+    storedBytes += stats.bytesStored;
+  }
+  std::cout << "备份: " << VERSION_COUNT << " 个版本, 写入 " << storedBytes
+            << " 字节" << std::endl;
+  expect(storedBytes < 2 * 300 * 1024, "共用数据块未去重");
+  expect(store.listManifests() == manifests, "清单顺序与备份顺序");
+
+  // 恢复最近一次备份
+  fs::create_directories(target);
+  bool restored = store.restore(target.string());
+  expect(restored, "恢复最近备份: " + store.getLastError());
+  auto latest = makeVersion(VERSION_COUNT - 1);
+  for (size_t i = 0; i < fileNames.size(); ++i) {
+    expect(readFile((target / fileNames[i]).string()) == latest[i],
+           "最近备份 " + fileNames[i]);
+  }
+
+  // 恢复每个指定版本
+  for (int version = 0; version < VERSION_COUNT; ++version) {
+    fs::remove_all(target);
+    fs::create_directories(target);
+    restored = store.restore(target.string(), manifests[version]);
+    expect(restored, "恢复版本" + std::to_string(version) + ": " +
+                         store.getLastError());
+    auto contents = makeVersion(version);
+    for (size_t i = 0; i < fileNames.size(); ++i) {
+      expect(readFile((target / fileNames[i]).string()) == contents[i],
+             "版本" + std::to_string(version) + " " + fileNames[i]);
+    }
+  }
+
+  std::error_code ec;
+  fs::remove_all(root, ec);
+  if (failures > 0) {
+    std::cout << "共 " << failures << " 处不一致" << std::endl;
+    return 1;
+  }
+  std::cout << "备份与恢复往返一致" << std::endl;
+  return 0;
+}
@@ -0,0 +1,222 @@
+#include "ContractionHierarchy.h"
+#include "EntityCatalog.h"
+#include "RailNetwork.h"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// 收缩层次与Dijkstra的对照测试：在随机生成的路网上按里程与运行时间
+// 两种度量比较全部站点对的最短代价，检查展开的路径首尾正确、相邻站点
+// 有区间相连且代价之和等于最短代价；并检查索引文件的保存/加载往返，
+// 以及等级表或捷径损坏的文件被拒绝
+
+namespace {
+
+const int STATION_COUNT = 60;
+const int ROUTE_COUNT = 8;
+
+int failures = 0;
+
+void expect(bool condition, const std::string &what) {
+  if (!condition) {
+    ++failures;
+    std::cout << "  不一致: " << what << std::endl;
+  }
+}
+
+bool sameCost(double a, double b) {
+  return std::fabs(a - b) <= 1e-9 * std::max(1.0, std::fabs(b));
+}
+
+// 线路随机经过部分站点，站点之间多处共用（形成换乘与平行区间）
+std::shared_ptr<const EntityCatalog> buildCatalog(std::mt19937 &random) {
+  std::vector<std::shared_ptr<Station>> stations;
+  for (int i = 0; i < STATION_COUNT; ++i) {
+    stations.push_back(std::make_shared<Station>(
+        "S" + std::to_string(i), "站点" + std::to_string(i), "测试",
+        104.0 + (i % 10) * 0.1, 30.0 + (i / 10) * 0.1, "中间站", 2));
+  }
+  std::vector<std::shared_ptr<Route>> routes;
+  for (int r = 0; r < ROUTE_COUNT; ++r) {
+    auto route = std::make_shared<Route>("R" + std::to_string(r),
+                                         "线路" + std::to_string(r), "高铁",
+                                         0.0, 120 + 40 * (r % 5));
+    int length = 8 + random() % 12;
+    for (int k = 0; k < length; ++k) {
+      route->addStation(stations[random() % STATION_COUNT],
+                        k == 0 ? 0.0 : 5.0 + random() % 60);
+    }
+    routes.push_back(route);
+  }
+  return EntityCatalog::build(stations, routes, {});
+}
+
+// 相邻两站之间区间的最小代价，没有区间返回-1
+double arcWeight(const RailNetwork &network, int from, int to,
+                 PathMetric metric) {
+  const auto &offsets = network.getOffsets();
+  const auto &edges = network.getEdges();
+  double best = -1.0;
+  for (int e = offsets[from]; e < offsets[from + 1]; ++e) {
+    if (edges[e].target == to &&
+        (best < 0.0 || edges[e].weight(metric) < best)) {
+      best = edges[e].weight(metric);
+    }
+  }
+  return best;
+}
+
+void checkQueries(const RailNetwork &network, const ContractionHierarchy &ch,
+                  PathMetric metric, const std::string &name) {
+  DijkstraWorkspace dijkstraWorkspace, chWorkspace;
+  int reachable = 0;
+  for (int source = 0; source < network.getNodeCount(); ++source) {
+    for (int target = 0; target < network.getNodeCount(); ++target) {
+      std::string what = name + " " + std::to_string(source) + "->" +
+                         std::to_string(target);
+      PathResult expected =
+          network.shortestPath(source, target, metric, dijkstraWorkspace);
+      double cost = ch.queryCost(source, target, chWorkspace);
+      PathResult path = ch.query(source, target, chWorkspace);
+      expect(path.found == expected.found, what + " 可达性");
+      if (!expected.found || !path.found) {
+        continue;
+      }
+      reachable++;
+      expect(sameCost(cost, expected.cost), what + " 最短代价");
+      expect(sameCost(path.cost, expected.cost), what + " 路径代价");
+
+      const auto &stations = path.stations;
+      bool ends = !stations.empty() && stations.front() == source &&
+                  stations.back() == target;
+      expect(ends, what + " 路径首尾");
+      double total = 0.0;
+      bool connected = true;
+      for (size_t i = 1; i < stations.size(); ++i) {
+        double weight =
+            arcWeight(network, stations[i - 1], stations[i], metric);
+        connected &= weight >= 0.0;
+        total += std::max(0.0, weight);
+      }
+      expect(connected, what + " 路径相邻站点无区间");
+      expect(ends && connected && sameCost(total, expected.cost),
+             what + " 路径区间代价之和");
+    }
+  }
+  std::cout << name << ": " << reachable << " 个可达站点对, 捷径 "
+            << ch.getShortcutCount() << " 条" << std::endl;
+}
+
+std::string readFile(const std::string &path) {
+  std::ifstream file(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(file),
+                     std::istreambuf_iterator<char>());
+}
+
+void writeFile(const std::string &path, const std::string &content) {
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  file.write(content.data(), static_cast<std::streamsize>(content.size()));
+}
+
+template <typename T> T readAt(const std::string &bytes, size_t offset) {
+  T value;
+  std::memcpy(&value, bytes.data() + offset, sizeof(T));
+  return value;
+}
+
+template <typename T>
+void writeAt(std::string &bytes, size_t offset, const T &value) {
+  std::memcpy(&bytes[offset], &value, sizeof(T));
+}
+
+// 文件布局：魔数、版本、度量、指纹，随后为等级表、偏移表、上行边
+// （各自以uint64个数开头）
+void checkFileValidation(const RailNetwork &network,
+                         ContractionHierarchy &ch) {
+  namespace fs = std::filesystem;
+  std::string suffix = std::to_string(std::random_device{}());
+  std::string path =
+      (fs::temp_directory_path() / ("railway_ch_test_" + suffix)).string();
+  expect(ch.saveToFile(path), "保存索引: " + ch.getLastError());
+
+  ContractionHierarchy loaded;
+  bool ok = loaded.loadFromFile(path, network);
+  expect(ok, "加载索引: " + loaded.getLastError());
+  if (ok) {
+    checkQueries(network, loaded, ch.getMetric(), "加载的索引");
+  }
+
+  std::string original = readFile(path);
+  size_t nodes = static_cast<size_t>(network.getNodeCount());
+  size_t ranksAt = 4 + 4 + 4 + 8 + 8;
+  size_t offsetsAt = ranksAt + nodes * sizeof(int) + 8;
+  size_t edgesAt = offsetsAt + (nodes + 1) * sizeof(int) + 8;
+
+  // 等级重复
+  std::string corrupted = original;
+  writeAt(corrupted, ranksAt, readAt<int>(corrupted, ranksAt + sizeof(int)));
+  writeFile(path, corrupted);
+  ok = loaded.loadFromFile(path, network);
+  expect(!ok, "重复等级的索引被拒绝");
+  expect(loaded.isBuilt(), "加载失败后保留原索引");
+
+  // 捷径经过的节点改为其上行端点（等级高于起点），展开将无限递归
+  bool foundShortcut = false;
+  for (size_t node = 0; node < nodes && !foundShortcut; ++node) {
+    int begin = readAt<int>(original, offsetsAt + node * sizeof(int));
+    int end = readAt<int>(original, offsetsAt + (node + 1) * sizeof(int));
+    for (int e = begin; e < end; ++e) {
+      size_t edgeAt = edgesAt + static_cast<size_t>(e) *
+                                    sizeof(ContractionHierarchy::UpEdge);
+      auto edge = readAt<ContractionHierarchy::UpEdge>(original, edgeAt);
+      if (edge.middle < 0) {
+        continue;
+      }
+      corrupted = original;
+      edge.middle = edge.target;
+      writeAt(corrupted, edgeAt, edge);
+      foundShortcut = true;
+      break;
+    }
+  }
+  expect(foundShortcut, "测试路网中没有捷径");
+  writeFile(path, corrupted);
+  ok = loaded.loadFromFile(path, network);
+  expect(!ok, "捷径中间节点等级不低于端点的索引被拒绝");
+
+  std::error_code ec;
+  fs::remove(path, ec);
+}
+
+} // namespace
+
+int main() {
+  std::mt19937 random(20240615);
+  auto catalog = buildCatalog(random);
+  RailNetwork network(catalog);
+
+  ContractionHierarchy byDistance;
+  byDistance.build(network, PathMetric::Distance);
+  checkQueries(network, byDistance, PathMetric::Distance, "里程");
+
+  ContractionHierarchy byTime;
+  byTime.build(network, PathMetric::Time);
+  checkQueries(network, byTime, PathMetric::Time, "运行时间");
+
+  checkFileValidation(network, byTime);
+
+  if (failures > 0) {
+    std::cout << "共 " << failures << " 处不一致" << std::endl;
+    return 1;
+  }
+  std::cout << "收缩层次与Dijkstra结果一致" << std::endl;
+  return 0;
+}
@@ -0,0 +1,262 @@
+#include "EntityCatalog.h"
+#include "JourneyPlanner.h"
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// 最早到达规划与暴力算法的对照测试：在随机生成的路网与时刻表上，按
+// 列车逐段反复松弛直到不再变化求各站最早到达，与Connection Scan的结果
+// 比较；并检查回溯出的行程每段都是真实的列车区间、换乘满足最短换乘
+// 时间、终到时刻等于最早到达。停运部分列车后再比较一次
+
+namespace {
+
+const int MINUTES_PER_DAY = 24 * 60;
+const int STATION_COUNT = 25;
+const int TRAIN_COUNT = 150;
+const int NOT_REACHED = std::numeric_limits<int>::max();
+
+int failures = 0;
+
+void expect(bool condition, const std::string &what) {
+  if (!condition) {
+    ++failures;
+    std::cout << "  不一致: " << what << std::endl;
+  }
+}
+
+TimePoint toTimePoint(int minute) {
+  minute %= MINUTES_PER_DAY;
+  return TimePoint(minute / 60, minute % 60);
+}
+
+// 四条线路共用部分站点；部分列车跳站或回到始发站，发车时刻分布在全天
+std::shared_ptr<const EntityCatalog> buildCatalog(std::mt19937 &random) {
+  std::vector<std::shared_ptr<Station>> stations;
+  for (int i = 0; i < STATION_COUNT; ++i) {
+    stations.push_back(std::make_shared<Station>(
+        "S" + std::to_string(i), "站点" + std::to_string(i), "测试",
+        104.0 + i * 0.05, 30.0, "中间站", 2));
+  }
+
+  std::vector<std::vector<int>> layouts(4);
+  for (int i = 0; i < 12; ++i) {
+    layouts[0].push_back(i);
+    layouts[1].push_back(STATION_COUNT - 1 - i);
+  }
+  for (int i = 1; i < STATION_COUNT; i += 3) {
+    layouts[2].push_back(i);
+  }
+  for (int i = 20; i >= 0; i -= 5) {
+    layouts[3].push_back(i);
+  }
+  std::vector<std::shared_ptr<Route>> routes;
+  for (size_t r = 0; r < layouts.size(); ++r) {
+    auto route = std::make_shared<Route>("R" + std::to_string(r),
+                                         "线路" + std::to_string(r), "高铁",
+                                         0.0, 250);
+    for (size_t k = 0; k < layouts[r].size(); ++k) {
+      route->addStation(stations[layouts[r][k]], k == 0 ? 0.0 : 20.0);
+    }
+    routes.push_back(route);
+  }
+
+  std::vector<std::shared_ptr<Train>> trains;
+  for (int k = 0; k < TRAIN_COUNT; ++k) {
+    const auto &route = routes[k % routes.size()];
+    auto train = std::make_shared<Train>("T" + std::to_string(k), "G", route);
+    trains.push_back(train);
+    auto routeStations = route->getStations();
+    if (k % 2 == 1) {
+      std::reverse(routeStations.begin(), routeStations.end());
+    }
+    int minute = random() % MINUTES_PER_DAY;
+    for (size_t i = 0; i < routeStations.size(); ++i) {
+      if (k % 7 == 0 && i % 4 == 2) {
+        continue;
+      }
+      int dwell = 1 + random() % 4;
+      train->addScheduleEntry(ScheduleEntry(
+          routeStations[i]->getStationId(), routeStations[i]->getStationName(),
+          toTimePoint(minute), toTimePoint(minute + dwell), dwell));
+      minute += dwell + 5 + random() % 20;
+    }
+    if (k % 11 == 0) {
+      train->addScheduleEntry(ScheduleEntry(
+          routeStations[0]->getStationId(), routeStations[0]->getStationName(),
+          toTimePoint(minute), toTimePoint(minute + 3), 3));
+    }
+  }
+  return EntityCatalog::build(stations, routes, trains);
+}
+
+// 列车相邻两个停站之间的一段运行
+struct Segment {
+  EntityHandle from;
+  EntityHandle to;
+  int departure;
+  int arrival;
+};
+
+std::vector<std::vector<Segment>>
+buildSegments(const std::shared_ptr<const EntityCatalog> &catalog) {
+  std::vector<std::vector<Segment>> segments(catalog->getTrainCount());
+  for (EntityHandle t = 0; t < catalog->getTrainCount(); ++t) {
+    const auto &train = catalog->getTrain(t);
+    const auto &schedule = train->getSchedule();
+    for (size_t i = 1; i < schedule.size(); ++i) {
+      EntityHandle from = catalog->getStationHandle(schedule[i - 1].stationId);
+      EntityHandle to = catalog->getStationHandle(schedule[i].stationId);
+      if (from != to) {
+        segments[t].push_back({from, to, train->getDepartureMinute(i - 1),
+                               train->getArrivalMinute(i)});
+      }
+    }
+  }
+  return segments;
+}
+
+// 逐列车按停站顺序松弛：能在发车前到达并完成换乘（起点无需换乘）即可
+// 上车，上车后沿途各站均可下车；反复扫描直到最早到达不再变化
+std::vector<int> bruteForceArrivals(const JourneyPlanner &planner,
+                                    const std::vector<std::vector<Segment>> &
+                                        segments,
+                                    EntityHandle source, int departure) {
+  std::vector<int> arrival(STATION_COUNT, NOT_REACHED);
+  std::vector<int> boardable(STATION_COUNT, NOT_REACHED);
+  arrival[source] = departure;
+  boardable[source] = departure;
+  for (bool changed = true; changed;) {
+    changed = false;
+    for (EntityHandle t = 0; t < static_cast<int>(segments.size()); ++t) {
+      if (planner.isTrainCancelled(t)) {
+        continue;
+      }
+      bool onboard = false;
+      for (const Segment &segment : segments[t]) {
+        if (segment.departure < departure) {
+          continue;
+        }
+        onboard = onboard || boardable[segment.from] <= segment.departure;
+        if (!onboard) {
+          continue;
+        }
+        if (segment.arrival < arrival[segment.to]) {
+          arrival[segment.to] = segment.arrival;
+          changed = true;
+        }
+        int change = planner.getTransferMinutes(segment.to);
+        if (change >= 0 && segment.arrival + change < boardable[segment.to]) {
+          boardable[segment.to] = segment.arrival + change;
+          changed = true;
+        }
+      }
+    }
+  }
+  return arrival;
+}
+
+// 一段乘车在列车时刻表中存在：自fromStation发车、到达toStation且时刻一致
+bool isTrainLeg(const std::shared_ptr<const EntityCatalog> &catalog,
+                const JourneyLeg &leg) {
+  const auto &train = catalog->getTrain(leg.train);
+  const auto &schedule = train->getSchedule();
+  for (size_t i = 0; i < schedule.size(); ++i) {
+    if (catalog->getStationHandle(schedule[i].stationId) != leg.fromStation ||
+        train->getDepartureMinute(i) != leg.departureMinute) {
+      continue;
+    }
+    for (size_t j = i + 1; j < schedule.size(); ++j) {
+      if (catalog->getStationHandle(schedule[j].stationId) == leg.toStation &&
+          train->getArrivalMinute(j) == leg.arrivalMinute) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+void checkJourney(const std::shared_ptr<const EntityCatalog> &catalog,
+                  const JourneyPlanner &planner, const Journey &journey,
+                  EntityHandle source, EntityHandle target, int departure,
+                  int expectedArrival, const std::string &what) {
+  expect(journey.found == (expectedArrival != NOT_REACHED), what + " 可达性");
+  if (!journey.found || expectedArrival == NOT_REACHED) {
+    return;
+  }
+  expect(journey.arrivalMinute == expectedArrival, what + " 最早到达");
+  const auto &legs = journey.legs;
+  if (source == target) {
+    expect(legs.empty(), what + " 起终点相同");
+    return;
+  }
+  bool valid = !legs.empty() && legs.front().fromStation == source &&
+               legs.front().departureMinute >= departure &&
+               legs.back().toStation == target &&
+               legs.back().arrivalMinute == expectedArrival;
+  for (size_t k = 0; valid && k < legs.size(); ++k) {
+    valid = isTrainLeg(catalog, legs[k]) &&
+            !planner.isTrainCancelled(legs[k].train);
+    if (valid && k > 0) {
+      int change = planner.getTransferMinutes(legs[k].fromStation);
+      valid = legs[k].fromStation == legs[k - 1].toStation && change >= 0 &&
+              legs[k - 1].arrivalMinute + change <= legs[k].departureMinute;
+    }
+  }
+  expect(valid, what + " 行程各段");
+}
+
+int checkPlanner(const std::shared_ptr<const EntityCatalog> &catalog,
+                 const JourneyPlanner &planner, const std::string &name) {
+  auto segments = buildSegments(catalog);
+  int reachable = 0;
+  for (int departure : {0, 6 * 60, 12 * 60 + 30, 20 * 60}) {
+    for (EntityHandle source = 0; source < STATION_COUNT; ++source) {
+      auto expected = bruteForceArrivals(planner, segments, source, departure);
+      std::vector<int> arrival;
+      planner.earliestArrivals(source, departure, arrival);
+      for (EntityHandle target = 0; target < STATION_COUNT; ++target) {
+        std::string what = name + " " + std::to_string(source) + "->" +
+                           std::to_string(target) + "@" +
+                           std::to_string(departure);
+        int want = expected[target] == NOT_REACHED ? JourneyPlanner::UNREACHABLE
+                                                   : expected[target];
+        expect(arrival[target] == want, what + " 单源最早到达");
+        Journey journey = planner.planJourney(source, target, departure);
+        checkJourney(catalog, planner, journey, source, target, departure,
+                     expected[target], what);
+        reachable += journey.found;
+      }
+    }
+  }
+  return reachable;
+}
+
+} // namespace
+
+int main() {
+  std::mt19937 random(20241215);
+  auto catalog = buildCatalog(random);
+  JourneyPlanner planner(catalog);
+
+  int reachable = checkPlanner(catalog, planner, "全部列车");
+  std::cout << "全部列车: " << planner.getConnections().size() << " 个连接, "
+            << reachable << " 个可达查询" << std::endl;
+
+  for (EntityHandle t = 0; t < catalog->getTrainCount(); t += 5) {
+    planner.setTrainCancelled(catalog->getTrain(t)->getTrainId());
+  }
+  reachable = checkPlanner(catalog, planner, "部分停运");
+  std::cout << "部分停运: " << reachable << " 个可达查询" << std::endl;
+
+  if (failures > 0) {
+    std::cout << "共 " << failures << " 处不一致" << std::endl;
+    return 1;
+  }
+  std::cout << "最早到达与暴力算法一致" << std::endl;
+  return 0;
+}
@@ -0,0 +1,472 @@
+#include "EntityCatalog.h"
+#include "FlowScheduleJoin.h"
+#include "HeadwayChecker.h"
+#include "PassengerFlow.h"
+#include "PlatformOccupancy.h"
+#include "SectionLoadIndex.h"
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// 时刻表相关检查与暴力算法的对照测试：在随机生成的小型路网与时刻表上
+// 比较追踪间隔/越行检查、站台占用、客流与时刻表的as-of连接、区间断面
+// 客流的结果，任一不一致时返回非零
+
+namespace {
+
+const int MINUTES_PER_DAY = 24 * 60;
+const int STATION_COUNT = 30;
+const int TRAIN_COUNT = 200;
+const Date FLOW_DATE(2024, 12, 15);
+
+int failures = 0;
+
+void expect(bool condition, const std::string &what) {
+  if (!condition) {
+    ++failures;
+    std::cout << "  不一致: " << what << std::endl;
+  }
+}
+
+TimePoint toTimePoint(int minute) {
+  minute %= MINUTES_PER_DAY;
+  return TimePoint(minute / 60, minute % 60);
+}
+
+// 四条线路共用部分站点；约一成列车无时刻表，部分列车跳站或回到始发站，
+// 发车时刻随机分布在全天（含跨午夜）
+std::shared_ptr<const EntityCatalog> buildCatalog(std::mt19937 &random) {
+  std::vector<std::shared_ptr<Station>> stations;
+  for (int i = 0; i < STATION_COUNT; ++i) {
+    stations.push_back(std::make_shared<Station>(
+        "S" + std::to_string(i), "站点" + std::to_string(i), "测试",
+        104.0 + i * 0.05, 30.0 + (i % 5) * 0.02, "中间站",
+        i % 7 == 3 ? 0 : 2 + i % 3)); // 0为站台数未知
+  }
+
+  std::vector<std::vector<int>> layouts(4);
+  for (int i = 0; i < 15; ++i) {
+    layouts[0].push_back(i);
+    layouts[1].push_back(10 + i);
+  }
+  for (int i = 5; i < STATION_COUNT; i += 2) {
+    layouts[2].push_back(i);
+  }
+  for (int i = 20; i >= 0; i -= 4) {
+    layouts[3].push_back(i);
+  }
+  std::vector<std::shared_ptr<Route>> routes;
+  for (size_t r = 0; r < layouts.size(); ++r) {
+    auto route = std::make_shared<Route>("R" + std::to_string(r),
+                                         "线路" + std::to_string(r), "高铁",
+                                         0.0, 250);
+    for (size_t k = 0; k < layouts[r].size(); ++k) {
+      route->addStation(stations[layouts[r][k]],
+                        k == 0 ? 0.0 : 5.0 + random() % 16);
+    }
+    routes.push_back(route);
+  }
+
+  std::vector<std::shared_ptr<Train>> trains;
+  for (int k = 0; k < TRAIN_COUNT; ++k) {
+    const auto &route = routes[k % routes.size()];
+    auto train = std::make_shared<Train>("T" + std::to_string(k), "G", route,
+                                         600 + 100 * (k % 5));
+    trains.push_back(train);
+    if (k % 10 == 0) {
+      continue;
+    }
+    auto routeStations = route->getStations();
+    if (k % 2 == 1) {
+      std::reverse(routeStations.begin(), routeStations.end());
+    }
+    int minute = random() % MINUTES_PER_DAY;
+    for (size_t i = 0; i < routeStations.size(); ++i) {
+      if (k % 7 == 0 && i % 5 == 2) {
+        continue;
+      }
+      int dwell = 1 + random() % 5;
+      train->addScheduleEntry(ScheduleEntry(
+          routeStations[i]->getStationId(), routeStations[i]->getStationName(),
+          toTimePoint(minute), toTimePoint(minute + dwell), dwell));
+      minute += dwell + 3 + random() % 12;
+    }
+    if (k % 13 == 0) {
+      train->addScheduleEntry(ScheduleEntry(
+          routeStations[0]->getStationId(), routeStations[0]->getStationName(),
+          toTimePoint(minute), toTimePoint(minute + 3), 3));
+    }
+  }
+  return EntityCatalog::build(stations, routes, trains);
+}
+
+// ========== 追踪间隔与越行 ==========
+
+// 冲突的比较键：(类型, 区间起点, 区间终点, 列车, 另一列车)
+using ConflictKey = std::tuple<int, int, int, int, int>;
+
+void checkHeadway(const std::shared_ptr<const EntityCatalog> &catalog) {
+  const int minHeadway = HeadwayChecker::DEFAULT_MIN_HEADWAY_MINUTES;
+  HeadwayReport report = HeadwayChecker(catalog, minHeadway).check();
+  std::multiset<ConflictKey> found;
+  for (const auto &conflict : report.conflicts) {
+    if (conflict.type != ConflictType::RunningTime) {
+      found.insert({static_cast<int>(conflict.type), conflict.fromStation,
+                    conflict.toStation, conflict.train, conflict.otherTrain});
+    }
+  }
+
+  // 占用(进入, 离开, 列车, 是否为平移一天的副本)，按有向区间分组
+  using Interval = std::tuple<int, int, int, bool>;
+  std::map<std::pair<int, int>, std::vector<Interval>> segments;
+  for (EntityHandle t = 0; t < catalog->getTrainCount(); ++t) {
+    const auto &train = catalog->getTrain(t);
+    const auto &schedule = train->getSchedule();
+    for (size_t i = 1; i < schedule.size(); ++i) {
+      int from = catalog->getStationHandle(schedule[i - 1].stationId);
+      int to = catalog->getStationHandle(schedule[i].stationId);
+      int enter = train->getDepartureMinute(i - 1);
+      int run = train->getArrivalMinute(i) - enter;
+      enter %= MINUTES_PER_DAY;
+      segments[{from, to}].push_back({enter, enter + run, t, false});
+      segments[{from, to}].push_back({enter + MINUTES_PER_DAY,
+                                      enter + MINUTES_PER_DAY + run, t, true});
+    }
+  }
+
+  std::multiset<ConflictKey> expected;
+  for (auto &segment : segments) {
+    int from = segment.first.first;
+    int to = segment.first.second;
+    auto &intervals = segment.second;
+    std::sort(intervals.begin(), intervals.end());
+
+    // 相邻进入
+    std::set<std::pair<size_t, size_t>> entryPairs;
+    for (size_t i = 0; i + 1 < intervals.size(); ++i) {
+      if (!std::get<3>(intervals[i]) &&
+          std::get<0>(intervals[i + 1]) - std::get<0>(intervals[i]) <
+              minHeadway) {
+        expected.insert({static_cast<int>(ConflictType::Headway), from, to,
+                         std::get<2>(intervals[i]),
+                         std::get<2>(intervals[i + 1])});
+        entryPairs.insert({i, i + 1});
+      }
+    }
+    // 相邻离开（顺序与进入一致且未按进入报告过的）
+    std::vector<size_t> byExit(intervals.size());
+    for (size_t i = 0; i < byExit.size(); ++i) {
+      byExit[i] = i;
+    }
+    std::sort(byExit.begin(), byExit.end(), [&](size_t a, size_t b) {
+      return std::get<1>(intervals[a]) != std::get<1>(intervals[b])
+                 ? std::get<1>(intervals[a]) < std::get<1>(intervals[b])
+                 : a < b;
+    });
+    for (size_t k = 0; k + 1 < byExit.size(); ++k) {
+      size_t first = byExit[k];
+      size_t second = byExit[k + 1];
+      if (std::get<1>(intervals[second]) - std::get<1>(intervals[first]) >=
+              minHeadway ||
+          first > second || std::get<3>(intervals[first]) ||
+          entryPairs.count({first, second})) {
+        continue;
+      }
+      expected.insert({static_cast<int>(ConflictType::Headway), from, to,
+                       std::get<2>(intervals[first]),
+                       std::get<2>(intervals[second])});
+    }
+    // 越行：后进入者先离开
+    for (size_t i = 0; i < intervals.size(); ++i) {
+      if (std::get<3>(intervals[i])) {
+        continue;
+      }
+      for (size_t j = i + 1; j < intervals.size(); ++j) {
+        if (std::get<0>(intervals[j]) < std::get<1>(intervals[i]) &&
+            std::get<1>(intervals[j]) < std::get<1>(intervals[i])) {
+          expected.insert({static_cast<int>(ConflictType::Overtake), from, to,
+                           std::get<2>(intervals[i]),
+                           std::get<2>(intervals[j])});
+        }
+      }
+    }
+  }
+
+  std::cout << "追踪间隔/越行: 检查 " << found.size() << " 个冲突, 暴力 "
+            << expected.size() << " 个" << std::endl;
+  expect(!expected.empty(), "测试数据中没有冲突");
+  expect(found == expected, "追踪间隔/越行冲突集合");
+}
+
+// ========== 站台占用 ==========
+
+void checkPlatforms(const std::shared_ptr<const EntityCatalog> &catalog) {
+  const int clearance = PlatformOccupancy::DEFAULT_CLEARANCE_MINUTES;
+  PlatformOccupancy occupancy(catalog, clearance);
+  std::vector<PlatformUsage> usages = occupancy.evaluate();
+
+  // 逐分钟累加各站的停站时段
+  std::vector<std::vector<int>> perMinute(
+      catalog->getStationCount(), std::vector<int>(MINUTES_PER_DAY, 0));
+  for (EntityHandle t = 0; t < catalog->getTrainCount(); ++t) {
+    const auto &train = catalog->getTrain(t);
+    const auto &schedule = train->getSchedule();
+    for (size_t i = 0; i < schedule.size(); ++i) {
+      int station = catalog->getStationHandle(schedule[i].stationId);
+      int arrival = train->getArrivalMinute(i);
+      int end = std::max(arrival + 1, train->getDepartureMinute(i) + clearance);
+      for (int minute = arrival; minute < end; ++minute) {
+        perMinute[station][minute % MINUTES_PER_DAY]++;
+      }
+    }
+  }
+
+  int overloaded = 0;
+  for (EntityHandle s = 0; s < catalog->getStationCount(); ++s) {
+    const PlatformUsage &usage = usages[s];
+    const auto &minutes = perMinute[s];
+    std::string name = catalog->getStation(s)->getStationName();
+    int peak = *std::max_element(minutes.begin(), minutes.end());
+    int overflow = 0;
+    for (int count : minutes) {
+      overflow += usage.platformCount > 0 && count > usage.platformCount;
+    }
+    int windowMinutes = 0;
+    for (const auto &window : usage.overflows) {
+      windowMinutes += window.endMinute - window.startMinute;
+    }
+    expect(usage.peakOccupancy == peak, name + " 峰值占用");
+    expect(minutes[usage.peakMinute] == peak, name + " 峰值时刻");
+    expect(usage.overflowMinutes == overflow, name + " 超出分钟数");
+    expect(windowMinutes == overflow, name + " 超出时段");
+    expect(usage.isOverloaded() ==
+               (usage.platformCount > 0 && peak > usage.platformCount),
+           name + " 站台不足");
+    overloaded += usage.isOverloaded();
+
+    // 分配结果：同一站台不重叠，有空闲分钟时所用站台数等于峰值
+    auto assignments = occupancy.assignPlatforms(s);
+    std::map<int, std::vector<int>> platforms;
+    bool overlap = false;
+    for (const auto &assignment : assignments) {
+      auto &timeline = platforms[assignment.platform];
+      timeline.resize(MINUTES_PER_DAY, 0);
+      for (int minute = assignment.arrivalMinute;
+           minute < assignment.releaseMinute; ++minute) {
+        overlap |= timeline[minute % MINUTES_PER_DAY]++ > 0;
+      }
+    }
+    expect(!overlap, name + " 站台重复分配");
+    expect(static_cast<int>(platforms.size()) == usage.platformsAssigned,
+           name + " 分配站台数");
+    if (*std::min_element(minutes.begin(), minutes.end()) == 0) {
+      expect(usage.platformsAssigned == peak, name + " 分配站台数等于峰值");
+    }
+  }
+  std::cout << "站台占用: " << catalog->getStationCount() << " 个站点, "
+            << overloaded << " 个站台不足" << std::endl;
+}
+
+// ========== 客流记录与时刻表的as-of连接 ==========
+
+std::vector<FlowRecord>
+makeFlowRecords(const std::shared_ptr<const EntityCatalog> &catalog,
+                std::mt19937 &random) {
+  std::vector<FlowRecord> records;
+  for (int i = 0; i < 20000; ++i) {
+    const auto &train = catalog->getTrain(random() % catalog->getTrainCount());
+    const auto &routeStations = train->getRoute()->getStations();
+    std::string trainId = i % 1000 == 0 ? "未知车次" : train->getTrainId();
+    std::string stationId =
+        i % 997 == 0
+            ? "未知站点"
+            : routeStations[random() % routeStations.size()]->getStationId();
+    Date date = i % 3 == 0 ? Date(2024, 12, 16) : FLOW_DATE;
+    records.emplace_back("F" + std::to_string(i), stationId, "", date,
+                         random() % 24, random() % 40, random() % 40,
+                         trainId);
+  }
+  return records;
+}
+
+void checkJoin(const std::shared_ptr<const EntityCatalog> &catalog,
+               const std::vector<FlowRecord> &records) {
+  const int tolerance = FlowScheduleJoin::DEFAULT_TOLERANCE_MINUTES;
+  std::vector<ScheduleMatch> matches =
+      FlowScheduleJoin(catalog, tolerance).join(records);
+  expect(matches.size() == records.size(), "连接结果条数");
+  if (matches.size() != records.size()) {
+    return;
+  }
+
+  for (size_t i = 0; i < records.size(); ++i) {
+    const FlowRecord &record = records[i];
+    const ScheduleMatch &match = matches[i];
+    std::string what = "记录" + std::to_string(i);
+    EntityHandle trainHandle = catalog->getTrainHandle(record.getTrainId());
+    if (trainHandle == INVALID_HANDLE) {
+      expect(match.status == JoinStatus::UnknownTrain, what + " 未知列车");
+      continue;
+    }
+    if (catalog->getStationHandle(record.getStationId()) == INVALID_HANDLE) {
+      expect(match.status == JoinStatus::UnknownStation, what + " 未知站点");
+      continue;
+    }
+    const auto &train = catalog->getTrain(trainHandle);
+    const auto &schedule = train->getSchedule();
+    if (schedule.empty()) {
+      expect(match.status == JoinStatus::NoSchedule, what + " 无时刻表");
+      continue;
+    }
+
+    // 同站多次停靠：不晚于记录小时结束的最后一次到站，没有则取第一次
+    std::vector<std::pair<int, int>> visits; // (当日到站分钟, 停站序号)
+    for (size_t q = 0; q < schedule.size(); ++q) {
+      if (schedule[q].stationId == record.getStationId()) {
+        visits.push_back({train->getArrivalMinute(q) % MINUTES_PER_DAY,
+                          static_cast<int>(q)});
+      }
+    }
+    if (visits.empty()) {
+      expect(match.status == JoinStatus::NotOnSchedule, what + " 不在时刻表");
+      continue;
+    }
+    std::sort(visits.begin(), visits.end());
+    int hourEnd = record.getHour() * 60 + 59;
+    int stop = visits.front().second;
+    for (const auto &visit : visits) {
+      if (visit.first <= hourEnd) {
+        stop = visit.second;
+      }
+    }
+
+    // 停站时段与记录小时的间隔（按日循环）
+    int arrival = train->getArrivalMinute(stop) % MINUTES_PER_DAY;
+    int departure =
+        arrival + train->getDepartureMinute(stop) - train->getArrivalMinute(stop);
+    int gap = MINUTES_PER_DAY;
+    for (int shift = -MINUTES_PER_DAY; shift <= MINUTES_PER_DAY;
+         shift += MINUTES_PER_DAY) {
+      int hourStart = record.getHour() * 60 - shift;
+      gap = std::min(gap, std::max({0, hourStart - departure,
+                                    arrival - (hourStart + 59)}));
+    }
+    int travel = stop > 0 ? train->getArrivalMinute(stop) -
+                                train->getDepartureMinute(stop - 1)
+                          : 0;
+    expect(match.stop == stop, what + " 停站序号");
+    expect(match.arrivalMinute == arrival, what + " 到站时刻");
+    expect(match.departureMinute == departure, what + " 发车时刻");
+    expect(match.travelMinutes == travel, what + " 区间运行时分");
+    expect(match.offsetMinutes == gap, what + " 时间间隔");
+    expect(match.status == (gap <= tolerance ? JoinStatus::Matched
+                                             : JoinStatus::TimeMismatch),
+           what + " 匹配状态");
+  }
+
+  JoinSummary summary = FlowScheduleJoin::summarize(matches);
+  std::cout << "as-of连接: " << summary.getTotal() << " 条记录, 匹配 "
+            << summary.matched << " 条, 时间不符 " << summary.timeMismatch
+            << " 条" << std::endl;
+}
+
+// ========== 区间断面客流 ==========
+
+void checkSectionLoads(const std::shared_ptr<const EntityCatalog> &catalog,
+                       const std::vector<FlowRecord> &records) {
+  PassengerFlow passengerFlow;
+  passengerFlow.addRecords(std::vector<FlowRecord>(records));
+  SectionLoadIndex index(catalog);
+  index.compute(passengerFlow, FLOW_DATE);
+
+  int matched = 0;
+  std::map<std::pair<int, int>, long long> segmentPassengers;
+  for (EntityHandle t = 0; t < catalog->getTrainCount(); ++t) {
+    const auto &train = catalog->getTrain(t);
+    std::string what = train->getTrainId();
+
+    // 停站：有时刻表按时刻表，否则按线路全部站点
+    std::vector<std::string> stops;
+    if (!train->getSchedule().empty()) {
+      for (const auto &entry : train->getSchedule()) {
+        stops.push_back(entry.stationId);
+      }
+    } else {
+      for (const auto &station : train->getRoute()->getStations()) {
+        stops.push_back(station->getStationId());
+      }
+    }
+
+    // 逐条记录计入该站的第一次停靠
+    std::vector<int> boarding(stops.size(), 0);
+    std::vector<int> alighting(stops.size(), 0);
+    for (const auto &record : records) {
+      if (!(record.getDate() == FLOW_DATE) ||
+          record.getTrainId() != train->getTrainId()) {
+        continue;
+      }
+      auto it = std::find(stops.begin(), stops.end(), record.getStationId());
+      if (it == stops.end()) {
+        continue;
+      }
+      ++matched;
+      boarding[it - stops.begin()] += record.getBoardingCount();
+      alighting[it - stops.begin()] += record.getAlightingCount();
+    }
+
+    const TrainLoadProfile &profile = index.getTrainProfile(t);
+    expect(profile.sectionLoads.size() + 1 == stops.size(), what + " 区间数");
+    if (profile.sectionLoads.size() + 1 != stops.size()) {
+      continue;
+    }
+    int onboard = 0;
+    int peak = 0;
+    for (size_t i = 0; i + 1 < stops.size(); ++i) {
+      onboard = std::max(0, onboard + boarding[i] - (i > 0 ? alighting[i] : 0));
+      peak = std::max(peak, onboard);
+      expect(profile.sectionLoads[i] == onboard,
+             what + " 第" + std::to_string(i) + "区间断面客流");
+      int a = catalog->getStationHandle(stops[i]);
+      int b = catalog->getStationHandle(stops[i + 1]);
+      segmentPassengers[{std::min(a, b), std::max(a, b)}] += onboard;
+    }
+    expect(profile.peakLoad == peak, what + " 最大断面客流");
+  }
+
+  for (const auto &segment : index.getSegments()) {
+    auto it = segmentPassengers.find(
+        {segment.fromStation, segment.toStation});
+    expect(it != segmentPassengers.end() && it->second == segment.passengers,
+           "区间" + std::to_string(segment.fromStation) + "-" +
+               std::to_string(segment.toStation) + " 客流汇总");
+  }
+  expect(index.getMatchedRecords() == matched, "计入的记录数");
+  std::cout << "区间断面客流: 计入 " << index.getMatchedRecords() << " 条记录, "
+            << index.getSegments().size() << " 个区间" << std::endl;
+}
+
+} // namespace
+
+int main() {
+  std::mt19937 random(2024);
+  auto catalog = buildCatalog(random);
+  std::vector<FlowRecord> records = makeFlowRecords(catalog, random);
+
+  checkHeadway(catalog);
+  checkPlatforms(catalog);
+  checkJoin(catalog, records);
+  checkSectionLoads(catalog, records);
+
+  if (failures > 0) {
+    std::cout << "共 " << failures << " 处不一致" << std::endl;
+    return 1;
+  }
+  std::cout << "全部检查与暴力算法一致" << std::endl;
+  return 0;
+}
@@ -0,0 +1,107 @@
+#include "EntityCatalog.h"
+#include "TrainSimulator.h"
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// 列车运行模拟的扰动注入测试：单线三站、区间按最高速度恰好等于计划
+// 运行时分（晚点只能靠压缩停站追回），检查始发站、停站中及重置前
+// 注入的额外停留都按计划推迟发车
+
+namespace {
+
+int failures = 0;
+
+void expect(bool condition, const std::string &what) {
+  if (!condition) {
+    ++failures;
+    std::cout << "  不一致: " << what << std::endl;
+  }
+}
+
+// A 08:00 发 — B 09:00 到 09:05 发 — C 10:05 到，区间各100公里，最高100km/h
+std::shared_ptr<const EntityCatalog> buildCatalog() {
+  std::vector<std::shared_ptr<Station>> stations;
+  for (const char *id : {"A", "B", "C"}) {
+    stations.push_back(std::make_shared<Station>(
+        id, std::string("站点") + id, "测试", 104.0, 30.0, "中间站", 2));
+  }
+  auto route = std::make_shared<Route>("R", "线路", "高铁", 0.0, 100);
+  for (size_t i = 0; i < stations.size(); ++i) {
+    route->addStation(stations[i], i == 0 ? 0.0 : 100.0);
+  }
+  auto train = std::make_shared<Train>("G1", "G", route);
+  train->addScheduleEntry(
+      ScheduleEntry("A", "站点A", TimePoint(8, 0), TimePoint(8, 0), 0));
+  train->addScheduleEntry(
+      ScheduleEntry("B", "站点B", TimePoint(9, 0), TimePoint(9, 5), 5));
+  train->addScheduleEntry(
+      ScheduleEntry("C", "站点C", TimePoint(10, 5), TimePoint(10, 5), 0));
+  return EntityCatalog::build(stations, {route}, {train});
+}
+
+} // namespace
+
+int main() {
+  TrainSimulator simulator(buildCatalog());
+  const EntityHandle train = 0;
+  expect(simulator.isSimulated(train), "列车参与模拟");
+
+  simulator.runToEnd();
+  expect(simulator.getTrainState(train) == TrainState::Finished, "正点到达终点");
+  expect(simulator.getDelayMinutes(train) == 0, "无扰动时正点");
+
+  // 始发发车事件已在reset时入历，之后注入的始发站停留仍需生效
+  simulator.reset();
+  expect(simulator.addDelay("G1", "A", 30), "注入始发站停留");
+  simulator.advanceTo(8 * 60 + 15);
+  expect(simulator.getTrainState(train) == TrainState::Waiting,
+         "始发站停留期间未发车");
+  simulator.advanceTo(8 * 60 + 31);
+  expect(simulator.getTrainState(train) == TrainState::Running,
+         "停留结束后发车");
+  expect(simulator.getDelayMinutes(train) == 30, "始发晚点30分钟");
+  simulator.advanceTo(9 * 60 + 30);
+  expect(simulator.getTrainState(train) == TrainState::Dwelling &&
+             simulator.getDelayMinutes(train) == 30,
+         "中间站晚到30分钟");
+  simulator.runToEnd();
+  // 中间站压缩至最短停站，追回4分钟
+  expect(simulator.getDelayMinutes(train) ==
+             30 - 5 + TrainSimulator::MIN_DWELL_MINUTES,
+         "终到晚点");
+
+  // 停站中注入：发车事件已在到站时入历
+  simulator.clearDelays();
+  simulator.reset();
+  simulator.advanceTo(9 * 60 + 2);
+  expect(simulator.getTrainState(train) == TrainState::Dwelling, "停站中");
+  expect(simulator.addDelay("G1", "B", 20), "注入停站中停留");
+  simulator.advanceTo(9 * 60 + 20);
+  expect(simulator.getTrainState(train) == TrainState::Dwelling,
+         "停站中停留期间未发车");
+  simulator.runToEnd();
+  expect(simulator.getDelayMinutes(train) == 20, "停站中停留的终到晚点");
+
+  // 重置前注入，回放时同样生效；清除后恢复正点
+  simulator.clearDelays();
+  expect(simulator.addDelay("G1", "B", 10), "注入中间站停留");
+  simulator.reset();
+  simulator.runToEnd();
+  expect(simulator.getDelayMinutes(train) == 10, "中间站停留的终到晚点");
+  simulator.clearDelays();
+  simulator.reset();
+  simulator.runToEnd();
+  expect(simulator.getDelayMinutes(train) == 0, "清除扰动后正点");
+
+  expect(!simulator.addDelay("G9", "A", 5), "未知列车");
+  expect(!simulator.addDelay("G1", "X", 5), "未知站点");
+
+  if (failures > 0) {
+    std::cout << "共 " << failures << " 处不一致" << std::endl;
+    return 1;
+  }
+  std::cout << "扰动注入按计划推迟发车" << std::endl;
+  return 0;
+}